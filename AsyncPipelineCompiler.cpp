@@ -0,0 +1,151 @@
+#include "AsyncPipelineCompiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+AsyncPipelineCompiler::AsyncPipelineCompiler(VulkanContext& context, uint32_t workerCount, bool useCache)
+    : _context(context), _useCache(useCache) {
+    // 留一个核心给主线程
+    if (workerCount == 0) {
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        _workers.emplace_back(&AsyncPipelineCompiler::workerLoop, this);
+    }
+}
+
+AsyncPipelineCompiler::~AsyncPipelineCompiler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _jobAvailable.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+AsyncPipelineCompiler::Handle AsyncPipelineCompiler::submit(std::unique_ptr<PipelineBuilder> builder) {
+    Handle handle = static_cast<Handle>(_slots.size());
+    _slots.push_back(std::make_unique<Slot>());
+    _pendingCount.fetch_add(1, std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back({_slots.back().get(), std::move(builder)});
+    }
+    _jobAvailable.notify_one();
+    return handle;
+}
+
+VulkanPipeline* AsyncPipelineCompiler::get(Handle handle, VulkanPipeline* fallback) const {
+    const Slot& slot = *_slots[handle];
+    return slot.state.load(std::memory_order_acquire) == State::Ready ? slot.pipeline.get() : fallback;
+}
+
+void AsyncPipelineCompiler::wait(Handle handle) {
+    Slot& slot = *_slots[handle];
+    std::unique_lock<std::mutex> lock(_mutex);
+    _jobFinished.wait(lock, [&] { return slot.state.load(std::memory_order_acquire) != State::Pending; });
+}
+
+void AsyncPipelineCompiler::waitAll() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _jobFinished.wait(lock, [this] { return _pendingCount.load(std::memory_order_acquire) == 0; });
+}
+
+void AsyncPipelineCompiler::workerLoop() {
+    // 每个工作线程一个线程缓存；不使用缓存时显式传 VK_NULL_HANDLE
+    VkPipelineCache cache = _useCache ? _context.getPipelineCache().createThreadCache() : VK_NULL_HANDLE;
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobAvailable.wait(lock, [this] { return _stop || !_jobs.empty(); });
+            if (_stop) return;
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        // 编译不持锁；builder 用完即销毁，释放它持有的 SPIR-V
+        State result = State::Failed;
+        try {
+            job.builder->setPipelineCache(cache);
+            job.slot->pipeline = job.builder->buildGraphicsPipeline();
+            result = State::Ready;
+        } catch (const std::exception& e) {
+            std::cerr << "[WARNING] async pipeline compilation failed: " << e.what() << std::endl;
+        }
+        job.builder.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            job.slot->state.store(result, std::memory_order_release);
+            _pendingCount.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        _jobFinished.notify_all();
+    }
+}
+
+std::vector<AsyncPipelineCompiler::BenchmarkResult> AsyncPipelineCompiler::benchmark(VulkanContext& context,
+    const std::function<std::unique_ptr<PipelineBuilder>(uint32_t index)>& makeBuilder,
+    uint32_t pipelineCount, std::span<const uint32_t> threadCounts) {
+    std::vector<uint32_t> counts(threadCounts.begin(), threadCounts.end());
+    if (counts.empty()) {
+        const uint32_t hardware = std::max(std::thread::hardware_concurrency(), 1u);
+        for (uint32_t count = 1; count < hardware; count *= 2) {
+            counts.push_back(count);
+        }
+        counts.push_back(hardware);
+    }
+
+    // 盐的起点每次调用随机选取，避免命中上一次启动留在驱动磁盘缓存中的结果
+    const uint32_t saltBase = std::random_device{}();
+    std::vector<BenchmarkResult> results;
+    for (size_t run = 0; run < counts.size(); ++run) {
+        const uint32_t threadCount = counts[run];
+        // 读取着色器文件不计入耗时
+        std::vector<std::unique_ptr<PipelineBuilder>> builders;
+        builders.reserve(pipelineCount);
+        for (uint32_t i = 0; i < pipelineCount; ++i) {
+            std::unique_ptr<PipelineBuilder> builder = makeBuilder(i);
+            VkShaderStageFlags stages = builder->getShaderStages();
+            if (stages == 0) {
+                throw std::runtime_error("benchmark pipeline has no shader stages!");
+            }
+            auto firstStage = static_cast<VkShaderStageFlagBits>(stages & (~stages + 1));
+            builder->getSpecializationConstants(firstStage).set(kBenchmarkSaltConstantId, saltBase + static_cast<uint32_t>(run));
+            builders.push_back(std::move(builder));
+        }
+
+        AsyncPipelineCompiler compiler(context, threadCount, false);
+        std::vector<Handle> handles;
+        handles.reserve(pipelineCount);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto& builder : builders) {
+            handles.push_back(compiler.submit(std::move(builder)));
+        }
+        compiler.waitAll();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        // 失败的任务也会很快“完成”，计入耗时会让结果失去意义
+        for (Handle handle : handles) {
+            if (compiler.getState(handle) == State::Failed) {
+                throw std::runtime_error("pipeline compile benchmark failed: pipeline " + std::to_string(handle)
+                    + " could not be compiled with " + std::to_string(threadCount) + " threads!");
+            }
+        }
+
+        results.push_back({threadCount, std::chrono::duration<double, std::milli>(end - start).count()});
+    }
+
+    std::cout << "[INFO] pipeline compile benchmark (" << pipelineCount << " pipelines, no cache, salted):";
+    for (const BenchmarkResult& result : results) {
+        std::cout << " " << result.threadCount << "T " << result.milliseconds << " ms ("
+                  << results.front().milliseconds / result.milliseconds << "x)";
+    }
+    std::cout << std::endl;
+    return results;
+}
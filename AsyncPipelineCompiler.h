@@ -0,0 +1,104 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanPipeline.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * @class AsyncPipelineCompiler
+ * @brief 在工作线程池上并行编译图形管线。
+ *
+ * submit() 接收一个配置好的 PipelineBuilder（SPIR-V 已在调用线程上读入），立即返回句柄；
+ * 工作线程调用 buildGraphicsPipeline() 创建着色器模块并完成真正耗时的 vkCreateGraphicsPipelines。
+ * 每个工作线程使用自己的线程缓存（PipelineCache::createThreadCache），避免在同一个缓存上争用驱动内部的锁，
+ * 线程缓存以共享缓存为初始数据，VulkanContext 销毁时并回共享缓存写入磁盘。
+ *
+ * 渲染时用 get() 查询：管线未就绪（或编译失败）时返回 nullptr 或调用方给出的替代管线，
+ * 渲染器据此跳过这次绘制或用一个通用管线代替，不会阻塞在编译上。
+ *
+ * 除工作线程外，所有接口都应在同一个线程（通常是主线程）中调用。管线归编译器所有，生命周期与它相同。
+ */
+class AsyncPipelineCompiler {
+public:
+    using Handle = uint32_t;
+
+    enum class State {
+        Pending,    // 排队或编译中
+        Ready,
+        Failed
+    };
+
+    struct BenchmarkResult {
+        uint32_t threadCount;
+        double milliseconds;
+    };
+
+    // workerCount 为 0 时使用 hardware_concurrency - 1；useCache 为 false 时不使用任何管线缓存（用于测量真实编译耗时）
+    AsyncPipelineCompiler(VulkanContext& context, uint32_t workerCount = 0, bool useCache = true);
+    ~AsyncPipelineCompiler();
+
+    // 禁止拷贝
+    AsyncPipelineCompiler(const AsyncPipelineCompiler&) = delete;
+    AsyncPipelineCompiler& operator=(const AsyncPipelineCompiler&) = delete;
+
+    // builder 必须已完成配置，之后由编译器持有并在编译完成后销毁
+    Handle submit(std::unique_ptr<PipelineBuilder> builder);
+
+    State getState(Handle handle) const { return _slots[handle]->state.load(std::memory_order_acquire); }
+    bool isReady(Handle handle) const { return getState(handle) == State::Ready; }
+
+    // 就绪时返回管线，否则返回 fallback（默认 nullptr，调用方跳过这次绘制）
+    VulkanPipeline* get(Handle handle, VulkanPipeline* fallback = nullptr) const;
+
+    // 阻塞直到指定管线（或全部已提交的管线）编译完成或失败
+    void wait(Handle handle);
+    void waitAll();
+    uint32_t getPendingCount() const { return _pendingCount.load(std::memory_order_acquire); }
+
+    /*
+     * @brief 用 makeBuilder(i) 生成 pipelineCount 个管线描述，分别以 threadCounts 中的每个线程数编译一遍，
+     * 记录从提交到全部完成的墙钟时间。为了测量真实的编译耗时，不使用管线缓存；驱动自身的磁盘着色器缓存
+     * 则用盐避开：每轮在第一个着色器阶段追加一个着色器中不存在的特化常量（kBenchmarkSaltConstantId），
+     * 值对每次调用和每一轮都不同，因此每轮都是冷编译。任何管线编译失败时抛出异常。
+     * threadCounts 为空时依次测试 1、2、4 ... 直到 hardware_concurrency。
+     */
+    static constexpr uint32_t kBenchmarkSaltConstantId = 0x7FFFFFFF;
+    static std::vector<BenchmarkResult> benchmark(VulkanContext& context,
+        const std::function<std::unique_ptr<PipelineBuilder>(uint32_t index)>& makeBuilder,
+        uint32_t pipelineCount, std::span<const uint32_t> threadCounts = {});
+
+private:
+    struct Slot {
+        std::atomic<State> state{State::Pending};
+        std::unique_ptr<VulkanPipeline> pipeline;   // state 变为 Ready 之后才能读取
+    };
+
+    struct Job {
+        Slot* slot;                                 // 槽位地址稳定，工作线程不访问 _slots 本身
+        std::unique_ptr<PipelineBuilder> builder;
+    };
+
+    void workerLoop();
+
+    VulkanContext& _context;
+    bool _useCache;
+    std::vector<std::unique_ptr<Slot>> _slots;      // 只由调用线程访问
+    std::atomic<uint32_t> _pendingCount{0};
+
+    // --- 与工作线程共享，受 _mutex 保护 ---
+    std::mutex _mutex;
+    std::condition_variable _jobAvailable;
+    std::condition_variable _jobFinished;
+    std::deque<Job> _jobs;
+    bool _stop = false;
+
+    std::vector<std::thread> _workers;
+};
@@ -0,0 +1,319 @@
+#include "AsyncUploader.h"
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+AsyncUploader::AsyncUploader(VulkanContext& context, VulkanQueue& transferQueue, VulkanQueue& graphicsQueue, VkDeviceSize stagingSize)
+    : _context(context), _transferQueue(transferQueue),
+      _transferFamily(transferQueue.getFamilyIndex()), _graphicsFamily(graphicsQueue.getFamilyIndex()),
+      _commandBuffers(context.getDevice(), transferQueue.getFamilyIndex()),
+      _staging(context, stagingSize) {
+    VkDevice device = _context.getDevice();
+
+    // 时间线信号量，初始值为 0，每提交一个批次加一
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &_timeline) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create upload timeline semaphore!");
+    }
+}
+
+AsyncUploader::~AsyncUploader() {
+    VkDevice device = _context.getDevice();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_batchCmd != VK_NULL_HANDLE) {
+            flushLocked();
+        }
+    }
+    wait(_submittedValue);
+    vkDestroySemaphore(device, _timeline, nullptr);
+}
+
+void AsyncUploader::beginBatchLocked() {
+    if (_batchCmd != VK_NULL_HANDLE) return;
+    _batchCmd = _commandBuffers.begin();
+}
+
+StagingRing::Allocation AsyncUploader::allocateStagingLocked(VkDeviceSize size, VkDeviceSize alignment) {
+    StagingRing::Allocation allocation;
+    if (size <= _staging.getCapacity()) {
+        retireLocked();
+        while (!_staging.tryAllocate(size, alignment, allocation)) {
+            if (_staging.hasInFlight()) {
+                // 等最早的批次完成，回收它占用的区段后重试
+                uint64_t oldest = _staging.oldestInFlight();
+                VkSemaphoreWaitInfo waitInfo{};
+                waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+                waitInfo.semaphoreCount = 1;
+                waitInfo.pSemaphores = &_timeline;
+                waitInfo.pValues = &oldest;
+                vkWaitSemaphores(_context.getDevice(), &waitInfo, UINT64_MAX);
+                retireLocked();
+            } else if (_batchCmd != VK_NULL_HANDLE) {
+                // 当前批次自己占满了环：先把它提交出去，之后的等待会回收它的空间
+                flushLocked();
+            } else {
+                break;
+            }
+        }
+        if (allocation.buffer != VK_NULL_HANDLE) return allocation;
+    }
+
+    // 单次请求超过环容量，退化为一个临时 buffer，随所属批次一起释放
+    auto buffer = std::make_unique<VulkanBuffer>(
+        _context,
+        size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+    allocation.buffer = buffer->GetBuffer();
+    allocation.offset = 0;
+    allocation.data = buffer->GetMappedMemory();
+    _oversizeStaging.push_back(std::move(buffer));
+    return allocation;
+}
+
+uint64_t AsyncUploader::uploadBuffer(const void* data, VkDeviceSize size, VulkanBuffer& dst, VkDeviceSize dstOffset,
+    VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // 1. 写入暂存（可能触发一次 flush，因此要在开始记录之前完成）
+    StagingRing::Allocation staging = allocateStagingLocked(size, 16);
+    memcpy(staging.data, data, static_cast<size_t>(size));
+
+    // 2. 记录拷贝
+    beginBatchLocked();
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = staging.offset;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = size;
+    vkCmdCopyBuffer(_batchCmd, staging.buffer, dst.GetBuffer(), 1, &copyRegion);
+
+    // 3. 批次末尾的 release 屏障；队列族不同时还需要图形侧的 acquire
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.srcQueueFamilyIndex = needsOwnershipTransfer() ? _transferFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = needsOwnershipTransfer() ? _graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = dst.GetBuffer();
+    barrier.offset = dstOffset;
+    barrier.size = size;
+    _releaseBufferBarriers.push_back(barrier);
+
+    if (needsOwnershipTransfer()) {
+        PendingAcquire acquire{};
+        acquire.dstStage = dstStage;
+        acquire.isImage = false;
+        acquire.bufferBarrier = barrier;
+        acquire.bufferBarrier.srcAccessMask = 0;
+        acquire.bufferBarrier.dstAccessMask = dstAccess;
+        _batchAcquires.push_back(acquire);
+    }
+    return _submittedValue + 1;
+}
+
+uint64_t AsyncUploader::uploadImage(const void* data, VkDeviceSize size, VulkanImage& image,
+    std::span<const VkBufferImageCopy> regions, VkImageLayout finalLayout,
+    VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // 1. 写入暂存；拷贝源偏移需要对齐到纹素大小，16 对所有非压缩/块压缩格式都足够
+    StagingRing::Allocation staging = allocateStagingLocked(size, 16);
+    memcpy(staging.data, data, static_cast<size_t>(size));
+
+    beginBatchLocked();
+
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.baseMipLevel = 0;
+    range.levelCount = image.getMipLevels();
+    range.baseArrayLayer = 0;
+    range.layerCount = image.getArrayLayers();     // 数组/立方体贴图的所有层都要转换，并一起转移所有权
+
+    // 2. UNDEFINED -> TRANSFER_DST
+    VkImageMemoryBarrier toTransfer{};
+    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = image.getImage();
+    toTransfer.subresourceRange = range;
+    toTransfer.srcAccessMask = 0;
+    toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(_batchCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+    // 3. 拷贝，区域偏移加上暂存偏移
+    std::vector<VkBufferImageCopy> copies;
+    if (regions.empty()) {
+        VkExtent2D extent = image.getExtent2D();
+        VkBufferImageCopy region{};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = image.getArrayLayers();
+        region.imageExtent = { extent.width, extent.height, 1 };
+        copies.push_back(region);
+    } else {
+        copies.assign(regions.begin(), regions.end());
+    }
+    for (auto& region : copies) {
+        region.bufferOffset += staging.offset;
+    }
+    vkCmdCopyBufferToImage(_batchCmd, staging.buffer, image.getImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        static_cast<uint32_t>(copies.size()), copies.data());
+
+    // 4. TRANSFER_DST -> finalLayout，队列族不同时兼作 release
+    VkImageMemoryBarrier release{};
+    release.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    release.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    release.newLayout = finalLayout;
+    release.srcQueueFamilyIndex = needsOwnershipTransfer() ? _transferFamily : VK_QUEUE_FAMILY_IGNORED;
+    release.dstQueueFamilyIndex = needsOwnershipTransfer() ? _graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+    release.image = image.getImage();
+    release.subresourceRange = range;
+    release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    release.dstAccessMask = 0;
+    _releaseImageBarriers.push_back(release);
+
+    if (needsOwnershipTransfer()) {
+        PendingAcquire acquire{};
+        acquire.dstStage = dstStage;
+        acquire.isImage = true;
+        acquire.imageBarrier = release;
+        acquire.imageBarrier.srcAccessMask = 0;
+        acquire.imageBarrier.dstAccessMask = dstAccess;
+        _batchAcquires.push_back(acquire);
+    }
+
+    // 图像在 GPU 上到达该布局之前，使用方必须等待返回的时间线值
+    image.setLayout(finalLayout);
+    return _submittedValue + 1;
+}
+
+uint64_t AsyncUploader::flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return flushLocked();
+}
+
+uint64_t AsyncUploader::flushLocked() {
+    if (_batchCmd == VK_NULL_HANDLE) return _submittedValue;
+
+    // 1. 合并所有 release 屏障为一次调用
+    if (!_releaseBufferBarriers.empty() || !_releaseImageBarriers.empty()) {
+        vkCmdPipelineBarrier(_batchCmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0, nullptr,
+            static_cast<uint32_t>(_releaseBufferBarriers.size()), _releaseBufferBarriers.data(),
+            static_cast<uint32_t>(_releaseImageBarriers.size()), _releaseImageBarriers.data()
+        );
+    }
+    // 2. 提交并让时间线信号量到达新的值；命令缓冲区由回收池在完成后回收
+    uint64_t signalValue = _submittedValue + 1;
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &_timeline;
+
+    VkCommandBuffer cmd = _batchCmd;
+    _batchCmd = VK_NULL_HANDLE;
+    _commandBuffers.submit(cmd, _transferQueue.getQueue(), submitInfo);
+    _submittedValue = signalValue;
+
+    // 3. 暂存空间与 acquire 请求都归属到这个值
+    _staging.commit(signalValue);
+    _inFlight.push_back({signalValue, std::move(_oversizeStaging)});
+    _oversizeStaging.clear();
+    for (auto& acquire : _batchAcquires) {
+        acquire.value = signalValue;
+        _pendingAcquires.push_back(acquire);
+    }
+    _batchAcquires.clear();
+    _releaseBufferBarriers.clear();
+    _releaseImageBarriers.clear();
+
+    return signalValue;
+}
+
+void AsyncUploader::retireLocked() {
+    if (_inFlight.empty()) return;
+    vkGetSemaphoreCounterValue(_context.getDevice(), _timeline, &_completedValue);
+    while (!_inFlight.empty() && _inFlight.front().value <= _completedValue) {
+        _inFlight.pop_front();
+    }
+    _staging.release(_completedValue);
+}
+
+bool AsyncUploader::isComplete(uint64_t value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (value <= _completedValue) return true;
+    retireLocked();
+    return value <= _completedValue;
+}
+
+void AsyncUploader::wait(uint64_t value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (value <= _completedValue) return;
+    if (value > _submittedValue) {
+        // 等待一个还在记录中的批次：先把它提交出去
+        flushLocked();
+    }
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_timeline;
+    waitInfo.pValues = &value;
+    vkWaitSemaphores(_context.getDevice(), &waitInfo, UINT64_MAX);
+    retireLocked();
+}
+
+uint64_t AsyncUploader::recordAcquireBarriers(VkCommandBuffer graphicsCmd, VkPipelineStageFlags& waitStages) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    waitStages = 0;
+    uint64_t waitValue = 0;
+
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    for (const auto& acquire : _pendingAcquires) {
+        waitStages |= acquire.dstStage;
+        waitValue = std::max(waitValue, acquire.value);
+        if (acquire.isImage) {
+            imageBarriers.push_back(acquire.imageBarrier);
+        } else {
+            bufferBarriers.push_back(acquire.bufferBarrier);
+        }
+    }
+    _pendingAcquires.clear();
+
+    if (!bufferBarriers.empty() || !imageBarriers.empty()) {
+        // 信号量等待发生在 waitStages，屏障的前半作用域与之衔接
+        vkCmdPipelineBarrier(graphicsCmd,
+            waitStages, waitStages,
+            0,
+            0, nullptr,
+            static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+            static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data()
+        );
+    }
+
+    // 同一队列族时不需要 acquire，但仍要在 GPU 上等最近提交的批次
+    if (!needsOwnershipTransfer() && _submittedValue > _completedValue) {
+        waitValue = _submittedValue;
+        waitStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    }
+    return waitValue;
+}
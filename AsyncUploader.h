@@ -0,0 +1,114 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanQueue.h"
+#include "VulkanBuffer.h"
+#include "VulkanImage.h"
+#include "StagingRing.h"
+#include "CommandBufferPool.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+/*
+ * @class AsyncUploader
+ * @brief 运行在专用传输队列上的异步上传引擎。
+ *
+ * 上传命令记录进传输队列的命令缓冲区，flush() 时提交并让时间线信号量
+ * 递增到新的值。每次上传都返回它所在批次将要触发的时间线值：
+ * - CPU 侧可以用 isComplete()/wait() 查询；
+ * - GPU 侧由渲染器在提交时等待这个值（Renderer::addWaitSemaphore），不阻塞 CPU。
+ *
+ * 当传输队列族与图形队列族不同时，会自动插入队列族所有权转移：
+ * 传输侧在批次末尾记录 release 屏障，图形侧在帧命令缓冲区开头调用
+ * recordAcquireBarriers() 记录对应的 acquire 屏障。
+ * 所有接口内部加锁，可以从流式加载线程调用。
+ */
+class AsyncUploader {
+public:
+    AsyncUploader(VulkanContext& context, VulkanQueue& transferQueue, VulkanQueue& graphicsQueue, VkDeviceSize stagingSize = 64ull * 1024 * 1024);
+    ~AsyncUploader();
+
+    // 禁止拷贝
+    AsyncUploader(const AsyncUploader&) = delete;
+    AsyncUploader& operator=(const AsyncUploader&) = delete;
+
+    /*
+     * @brief 把 data 上传到 dst 的 [dstOffset, dstOffset + size)。
+     * @param dstStage/dstAccess 图形侧第一次使用这段数据的阶段与访问方式。
+     * @return 上传完成时时间线信号量将到达的值（需要 flush() 之后才会真正提交）。
+     */
+    uint64_t uploadBuffer(const void* data, VkDeviceSize size, VulkanBuffer& dst, VkDeviceSize dstOffset = 0,
+        VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        VkAccessFlags dstAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT);
+
+    /*
+     * @brief 把 data 上传到 image，结束时 image 处于 finalLayout。
+     * @param regions 各拷贝区域，bufferOffset 相对于 data 起点；为空时拷贝第 0 级 mip 的所有层（各层在 data 中紧密排列）。
+     * 传输队列不支持 blit，因此不会生成 mipmap，需要的话应在 regions 中给出每一级数据。
+     */
+    uint64_t uploadImage(const void* data, VkDeviceSize size, VulkanImage& image,
+        std::span<const VkBufferImageCopy> regions = {},
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VkAccessFlags dstAccess = VK_ACCESS_SHADER_READ_BIT);
+
+    // 提交当前批次，返回它将触发的时间线值；没有待提交的上传时返回最近一次提交的值
+    uint64_t flush();
+
+    bool isComplete(uint64_t value);
+    void wait(uint64_t value);
+
+    /*
+     * @brief 在图形队列的命令缓冲区中记录已提交批次的 acquire 屏障。
+     * @param waitStages 输出：调用方提交该命令缓冲区时需要等待的阶段。
+     * @return 需要等待的时间线值，0 表示没有需要等待的上传。
+     */
+    uint64_t recordAcquireBarriers(VkCommandBuffer graphicsCmd, VkPipelineStageFlags& waitStages);
+
+    VkSemaphore getTimelineSemaphore() const { return _timeline; }
+    bool needsOwnershipTransfer() const { return _transferFamily != _graphicsFamily; }
+
+private:
+    struct InFlightBatch {
+        uint64_t value;
+        std::vector<std::unique_ptr<VulkanBuffer>> oversizeStaging;
+    };
+
+    struct PendingAcquire {
+        uint64_t value;
+        VkPipelineStageFlags dstStage;
+        bool isImage;
+        VkBufferMemoryBarrier bufferBarrier;
+        VkImageMemoryBarrier imageBarrier;
+    };
+
+    void beginBatchLocked();
+    uint64_t flushLocked();
+    void retireLocked();
+    StagingRing::Allocation allocateStagingLocked(VkDeviceSize size, VkDeviceSize alignment);
+
+    VulkanContext& _context;
+    VulkanQueue& _transferQueue;
+    uint32_t _transferFamily;
+    uint32_t _graphicsFamily;
+
+    std::mutex _mutex;
+    CommandBufferPool _commandBuffers;
+    VkSemaphore _timeline = VK_NULL_HANDLE;
+    uint64_t _submittedValue = 0;   // 最近一次提交的批次将触发的值
+    uint64_t _completedValue = 0;   // 已知 GPU 已经到达的值
+
+    // 当前正在记录的批次
+    VkCommandBuffer _batchCmd = VK_NULL_HANDLE;
+    std::vector<VkBufferMemoryBarrier> _releaseBufferBarriers;
+    std::vector<VkImageMemoryBarrier> _releaseImageBarriers;
+    std::vector<PendingAcquire> _batchAcquires;
+    std::vector<std::unique_ptr<VulkanBuffer>> _oversizeStaging;
+
+    std::deque<InFlightBatch> _inFlight;
+    std::vector<PendingAcquire> _pendingAcquires; // 已提交、尚未被图形队列 acquire 的资源
+
+    StagingRing _staging;
+};
@@ -0,0 +1,428 @@
+#include "BCDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // BC7 模式参数：子集数、分区位、旋转位、索引选择位、颜色/alpha 端点位数、每端点/每子集 p 位、两组索引位数
+    struct BC7Mode {
+        uint8_t subsets;
+        uint8_t partitionBits;
+        uint8_t rotationBits;
+        uint8_t indexSelectionBits;
+        uint8_t colorBits;
+        uint8_t alphaBits;
+        uint8_t endpointPBits;
+        uint8_t sharedPBits;
+        uint8_t indexBits;
+        uint8_t secondaryIndexBits;
+    };
+
+    const BC7Mode kBC7Modes[8] = {
+        { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+        { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+        { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+        { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+        { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+        { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+        { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+        { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+    };
+
+    // 两子集分区：第 i 位为纹素 i 所属的子集
+    const uint16_t kBC7Partitions2[64] = {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+    };
+
+    // 三子集分区：每个纹素的子集编号
+    const uint8_t kBC7Partitions3[64][16] = {
+        { 0,0,1,1, 0,0,1,1, 0,2,2,1, 2,2,2,2 }, { 0,0,0,1, 0,0,1,1, 2,2,1,1, 2,2,2,1 },
+        { 0,0,0,0, 2,0,0,1, 2,2,1,1, 2,2,1,1 }, { 0,2,2,2, 0,0,2,2, 0,0,1,1, 0,1,1,1 },
+        { 0,0,0,0, 0,0,0,0, 1,1,2,2, 1,1,2,2 }, { 0,0,1,1, 0,0,1,1, 0,0,2,2, 0,0,2,2 },
+        { 0,0,2,2, 0,0,2,2, 1,1,1,1, 1,1,1,1 }, { 0,0,1,1, 0,0,1,1, 2,2,1,1, 2,2,1,1 },
+        { 0,0,0,0, 0,0,0,0, 1,1,1,1, 2,2,2,2 }, { 0,0,0,0, 1,1,1,1, 1,1,1,1, 2,2,2,2 },
+        { 0,0,0,0, 1,1,1,1, 2,2,2,2, 2,2,2,2 }, { 0,0,1,2, 0,0,1,2, 0,0,1,2, 0,0,1,2 },
+        { 0,1,1,2, 0,1,1,2, 0,1,1,2, 0,1,1,2 }, { 0,1,2,2, 0,1,2,2, 0,1,2,2, 0,1,2,2 },
+        { 0,0,1,1, 0,1,1,2, 1,1,2,2, 1,2,2,2 }, { 0,0,1,1, 2,0,0,1, 2,2,0,0, 2,2,2,0 },
+        { 0,0,0,1, 0,0,1,1, 0,1,1,2, 1,1,2,2 }, { 0,1,1,1, 0,0,1,1, 2,0,0,1, 2,2,0,0 },
+        { 0,0,0,0, 1,1,2,2, 1,1,2,2, 1,1,2,2 }, { 0,0,2,2, 0,0,2,2, 0,0,2,2, 1,1,1,1 },
+        { 0,1,1,1, 0,1,1,1, 0,2,2,2, 0,2,2,2 }, { 0,0,0,1, 0,0,0,1, 2,2,2,1, 2,2,2,1 },
+        { 0,0,0,0, 0,0,1,1, 0,1,2,2, 0,1,2,2 }, { 0,0,0,0, 1,1,0,0, 2,2,1,0, 2,2,1,0 },
+        { 0,1,2,2, 0,1,2,2, 0,0,1,1, 0,0,0,0 }, { 0,0,1,2, 0,0,1,2, 1,1,2,2, 2,2,2,2 },
+        { 0,1,1,0, 1,2,2,1, 1,2,2,1, 0,1,1,0 }, { 0,0,0,0, 0,1,1,0, 1,2,2,1, 1,2,2,1 },
+        { 0,0,2,2, 1,1,0,2, 1,1,0,2, 0,0,2,2 }, { 0,1,1,0, 0,1,1,0, 2,0,0,2, 2,2,2,2 },
+        { 0,0,1,1, 0,1,2,2, 0,1,2,2, 0,0,1,1 }, { 0,0,0,0, 2,0,0,0, 2,2,1,1, 2,2,2,1 },
+        { 0,0,0,0, 0,0,0,2, 1,1,2,2, 1,2,2,2 }, { 0,2,2,2, 0,0,2,2, 0,0,1,2, 0,0,1,1 },
+        { 0,0,1,1, 0,0,1,2, 0,0,2,2, 0,2,2,2 }, { 0,1,2,0, 0,1,2,0, 0,1,2,0, 0,1,2,0 },
+        { 0,0,0,0, 1,1,1,1, 2,2,2,2, 0,0,0,0 }, { 0,1,2,0, 1,2,0,1, 2,0,1,2, 0,1,2,0 },
+        { 0,1,2,0, 2,0,1,2, 1,2,0,1, 0,1,2,0 }, { 0,0,1,1, 2,2,0,0, 1,1,2,2, 0,0,1,1 },
+        { 0,0,1,1, 1,1,2,2, 2,2,0,0, 0,0,1,1 }, { 0,1,0,1, 0,1,0,1, 2,2,2,2, 2,2,2,2 },
+        { 0,0,0,0, 0,0,0,0, 2,1,2,1, 2,1,2,1 }, { 0,0,2,2, 1,1,2,2, 0,0,2,2, 1,1,2,2 },
+        { 0,0,2,2, 0,0,1,1, 0,0,2,2, 0,0,1,1 }, { 0,2,2,0, 1,2,2,1, 0,2,2,0, 1,2,2,1 },
+        { 0,1,0,1, 2,2,2,2, 2,2,2,2, 0,1,0,1 }, { 0,0,0,0, 2,1,2,1, 2,1,2,1, 2,1,2,1 },
+        { 0,1,0,1, 0,1,0,1, 0,1,0,1, 2,2,2,2 }, { 0,2,2,2, 0,1,1,1, 0,2,2,2, 0,1,1,1 },
+        { 0,0,0,2, 1,1,1,2, 0,0,0,2, 1,1,1,2 }, { 0,0,0,0, 2,1,1,2, 2,1,1,2, 2,1,1,2 },
+        { 0,2,2,2, 0,1,1,1, 0,1,1,1, 0,2,2,2 }, { 0,0,0,2, 1,1,1,2, 1,1,1,2, 0,0,0,2 },
+        { 0,1,1,0, 0,1,1,0, 0,1,1,0, 2,2,2,2 }, { 0,0,0,0, 0,0,0,0, 2,1,1,2, 2,1,1,2 },
+        { 0,1,1,0, 0,1,1,0, 2,2,2,2, 2,2,2,2 }, { 0,0,2,2, 0,0,1,1, 0,0,1,1, 0,0,2,2 },
+        { 0,0,2,2, 1,1,2,2, 1,1,2,2, 0,0,2,2 }, { 0,0,0,0, 0,0,0,0, 0,0,0,0, 2,1,1,2 },
+        { 0,0,0,2, 0,0,0,1, 0,0,0,2, 0,0,0,1 }, { 0,2,2,2, 1,2,2,2, 0,2,2,2, 1,2,2,2 },
+        { 0,1,0,1, 2,2,2,2, 2,2,2,2, 2,2,2,2 }, { 0,1,1,1, 2,0,1,1, 2,2,0,1, 2,2,2,0 },
+    };
+
+    // 各子集的锚点纹素（索引少存一位的那个）；子集 0 的锚点总是纹素 0
+    const uint8_t kBC7Anchor2Of2[64] = {
+        15,15,15,15,15,15,15,15, 15,15,15,15,15,15,15,15, 15, 2, 8, 2, 2, 8, 8,15, 2, 8, 2, 2, 8, 8, 2, 2,
+        15,15, 6, 8, 2, 8,15,15,  2, 8, 2, 2, 2,15,15, 6,  6, 2, 6, 8,15,15, 2, 2, 15,15,15,15,15, 2, 2,15,
+    };
+    const uint8_t kBC7Anchor2Of3[64] = {
+         3, 3,15,15, 8, 3,15,15,  8, 8, 6, 6, 6, 5, 3, 3,  3, 3, 8,15, 3, 3, 6,10,  5, 8, 8, 6, 8, 5,15,15,
+         8,15, 3, 5, 6,10, 8,15, 15, 3,15, 5,15,15,15,15,  3,15, 5, 5, 5, 8, 5,10,  5,10, 8,13,15,12, 3, 3,
+    };
+    const uint8_t kBC7Anchor3Of3[64] = {
+        15, 8, 8, 3,15,15, 3, 8, 15,15,15,15,15,15,15, 8, 15, 8,15, 3,15, 8,15, 8,  3,15, 6,10,15,15,10, 8,
+        15, 3,15,10,10, 8, 9,10,  6,15, 8,15, 3, 6, 6, 8, 15, 3,15,15,15,15,15,15, 15,15,15,15, 3,15,15, 8,
+    };
+
+    const uint8_t kBC7Weights2[4] = { 0, 21, 43, 64 };
+    const uint8_t kBC7Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+    const uint8_t kBC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // 从低位开始按位读取 16 字节的块
+    class BitReader {
+    public:
+        explicit BitReader(const uint8_t* data) : _data(data) {}
+
+        uint32_t read(uint32_t count) {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < count; ++i, ++_position) {
+                value |= static_cast<uint32_t>((_data[_position >> 3] >> (_position & 7)) & 1) << i;
+            }
+            return value;
+        }
+
+    private:
+        const uint8_t* _data;
+        uint32_t _position = 0;
+    };
+
+    uint8_t interpolateBC7(uint8_t e0, uint8_t e1, uint32_t index, uint32_t indexBits) {
+        const uint8_t* weights = indexBits == 2 ? kBC7Weights2 : (indexBits == 3 ? kBC7Weights3 : kBC7Weights4);
+        return static_cast<uint8_t>(((64 - weights[index]) * e0 + weights[index] * e1 + 32) >> 6);
+    }
+}
+
+bool BCDecoder::canDecode(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool BCDecoder::isSigned(VkFormat format) {
+    return format == VK_FORMAT_BC4_SNORM_BLOCK || format == VK_FORMAT_BC5_SNORM_BLOCK;
+}
+
+VkFormat BCDecoder::getDecodedFormat(VkFormat format, bool isSrgb) {
+    if (isSigned(format)) return VK_FORMAT_R8G8B8A8_SNORM;
+    return isSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+// 8 字节颜色块：两个 RGB565 端点 + 16 个 2 位索引，输出 16 个 RGBA8 纹素
+void BCDecoder::decodeColorBlock(const uint8_t* block, uint8_t* rgba, bool allowPunchThrough) {
+    uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+
+    uint8_t palette[4][4];
+    auto expand565 = [](uint16_t c, uint8_t* out) {
+        uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+        out[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        out[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        out[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        out[3] = 255;
+    };
+    expand565(c0, palette[0]);
+    expand565(c1, palette[1]);
+
+    if (c0 > c1 || !allowPunchThrough) {
+        for (int i = 0; i < 3; ++i) {
+            palette[2][i] = static_cast<uint8_t>((2 * palette[0][i] + palette[1][i] + 1) / 3);
+            palette[3][i] = static_cast<uint8_t>((palette[0][i] + 2 * palette[1][i] + 1) / 3);
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    } else {
+        // 三色模式：第 4 个颜色为透明黑
+        for (int i = 0; i < 3; ++i) {
+            palette[2][i] = static_cast<uint8_t>((palette[0][i] + palette[1][i]) / 2);
+            palette[3][i] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+    }
+
+    uint32_t indices = static_cast<uint32_t>(block[4] | (block[5] << 8) | (block[6] << 16) | (block[7] << 24));
+    for (int i = 0; i < 16; ++i) {
+        memcpy(rgba + i * 4, palette[(indices >> (2 * i)) & 0x3], 4);
+    }
+}
+
+// 8 字节的 BC4 式单通道块：两个端点 + 16 个 3 位索引，结果按 stride 写入
+void BCDecoder::decodeAlphaBlock(const uint8_t* block, uint8_t* values, uint32_t stride) {
+    uint8_t a0 = block[0];
+    uint8_t a1 = block[1];
+
+    uint8_t palette[8];
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; ++i) {
+            palette[i + 1] = static_cast<uint8_t>(((7 - i) * a0 + i * a1 + 3) / 7);
+        }
+    } else {
+        for (int i = 1; i < 5; ++i) {
+            palette[i + 1] = static_cast<uint8_t>(((5 - i) * a0 + i * a1 + 2) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i) {
+        indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    }
+    for (int i = 0; i < 16; ++i) {
+        values[i * stride] = palette[(indices >> (3 * i)) & 0x7];
+    }
+}
+
+// 有符号版本：端点是 int8（-128 按 -127 处理），按有符号比较选择模式，两端极值为 -127/127
+void BCDecoder::decodeSignedAlphaBlock(const uint8_t* block, uint8_t* values, uint32_t stride) {
+    int a0 = std::max(static_cast<int>(static_cast<int8_t>(block[0])), -127);
+    int a1 = std::max(static_cast<int>(static_cast<int8_t>(block[1])), -127);
+
+    int palette[8];
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; ++i) {
+            int sum = (7 - i) * a0 + i * a1;
+            palette[i + 1] = (sum >= 0 ? sum + 3 : sum - 3) / 7;
+        }
+    } else {
+        for (int i = 1; i < 5; ++i) {
+            int sum = (5 - i) * a0 + i * a1;
+            palette[i + 1] = (sum >= 0 ? sum + 2 : sum - 2) / 5;
+        }
+        palette[6] = -127;
+        palette[7] = 127;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i) {
+        indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    }
+    for (int i = 0; i < 16; ++i) {
+        values[i * stride] = static_cast<uint8_t>(static_cast<int8_t>(palette[(indices >> (3 * i)) & 0x7]));
+    }
+}
+
+// 16 字节的 BC7 块：按模式读出分区、端点（含 p 位）与索引，插值后按旋转位交换 alpha 与某个颜色通道
+void BCDecoder::decodeBC7Block(const uint8_t* block, uint8_t* rgba) {
+    uint32_t modeIndex = 0;
+    while (modeIndex < 8 && (block[0] & (1u << modeIndex)) == 0) {
+        modeIndex++;
+    }
+    // 保留的模式 8 解码为透明黑
+    if (modeIndex == 8) {
+        memset(rgba, 0, 16 * 4);
+        return;
+    }
+    const BC7Mode& mode = kBC7Modes[modeIndex];
+    BitReader bits(block);
+    bits.read(modeIndex + 1);
+
+    const uint32_t partition = bits.read(mode.partitionBits);
+    const uint32_t rotation = bits.read(mode.rotationBits);
+    const uint32_t indexSelection = bits.read(mode.indexSelectionBits);
+
+    // 端点按通道存放：R 的所有端点、G 的所有端点……最后是 alpha；没有 alpha 的模式 alpha 为 255
+    const uint32_t endpointCount = mode.subsets * 2u;
+    uint8_t endpoints[6][4];
+    for (uint32_t channel = 0; channel < 4; ++channel) {
+        const uint32_t channelBits = channel < 3 ? mode.colorBits : mode.alphaBits;
+        for (uint32_t e = 0; e < endpointCount; ++e) {
+            endpoints[e][channel] = static_cast<uint8_t>(channelBits ? bits.read(channelBits) : 255);
+        }
+    }
+
+    // p 位作为每个通道的最低位，再把位数扩展到 8 位
+    const bool hasPBits = mode.endpointPBits || mode.sharedPBits;
+    uint32_t pBits[6] = {};
+    if (mode.endpointPBits) {
+        for (uint32_t e = 0; e < endpointCount; ++e) pBits[e] = bits.read(1);
+    } else if (mode.sharedPBits) {
+        for (uint32_t s = 0; s < mode.subsets; ++s) pBits[s * 2] = pBits[s * 2 + 1] = bits.read(1);
+    }
+    for (uint32_t e = 0; e < endpointCount; ++e) {
+        for (uint32_t channel = 0; channel < 4; ++channel) {
+            uint32_t channelBits = channel < 3 ? mode.colorBits : mode.alphaBits;
+            if (channelBits == 0) continue;
+            uint32_t value = endpoints[e][channel];
+            if (hasPBits) {
+                value = (value << 1) | pBits[e];
+                channelBits++;
+            }
+            value <<= 8 - channelBits;
+            endpoints[e][channel] = static_cast<uint8_t>(value | (value >> channelBits));
+        }
+    }
+
+    // 每个纹素的子集与锚点：锚点索引的最高位隐含为 0
+    uint8_t subsetOf[16] = {};
+    uint32_t anchors[3] = { 0, 0, 0 };
+    if (mode.subsets == 2) {
+        for (uint32_t i = 0; i < 16; ++i) subsetOf[i] = (kBC7Partitions2[partition] >> i) & 1;
+        anchors[1] = kBC7Anchor2Of2[partition];
+    } else if (mode.subsets == 3) {
+        memcpy(subsetOf, kBC7Partitions3[partition], 16);
+        anchors[1] = kBC7Anchor2Of3[partition];
+        anchors[2] = kBC7Anchor3Of3[partition];
+    }
+
+    uint32_t indices[16];
+    for (uint32_t i = 0; i < 16; ++i) {
+        const bool anchor = i == anchors[subsetOf[i]];
+        indices[i] = bits.read(anchor ? mode.indexBits - 1u : mode.indexBits);
+    }
+    // 模式 4/5 的第二组索引只有一个子集，锚点为纹素 0
+    uint32_t secondary[16] = {};
+    if (mode.secondaryIndexBits) {
+        for (uint32_t i = 0; i < 16; ++i) {
+            secondary[i] = bits.read(i == 0 ? mode.secondaryIndexBits - 1u : mode.secondaryIndexBits);
+        }
+    }
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        const uint8_t* e0 = endpoints[subsetOf[i] * 2];
+        const uint8_t* e1 = endpoints[subsetOf[i] * 2 + 1];
+        uint8_t* texel = rgba + i * 4;
+        if (mode.secondaryIndexBits) {
+            // 索引选择位为 1 时颜色用第二组索引、alpha 用第一组
+            const uint32_t colorIndex = indexSelection ? secondary[i] : indices[i];
+            const uint32_t colorIndexBits = indexSelection ? mode.secondaryIndexBits : mode.indexBits;
+            const uint32_t alphaIndex = indexSelection ? indices[i] : secondary[i];
+            const uint32_t alphaIndexBits = indexSelection ? mode.indexBits : mode.secondaryIndexBits;
+            for (int c = 0; c < 3; ++c) texel[c] = interpolateBC7(e0[c], e1[c], colorIndex, colorIndexBits);
+            texel[3] = interpolateBC7(e0[3], e1[3], alphaIndex, alphaIndexBits);
+        } else {
+            for (int c = 0; c < 4; ++c) texel[c] = interpolateBC7(e0[c], e1[c], indices[i], mode.indexBits);
+        }
+        if (rotation) {
+            std::swap(texel[3], texel[rotation - 1]);
+        }
+    }
+}
+
+bool BCDecoder::decodeToRGBA8(VkFormat format, const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst) {
+    if (!canDecode(format)) return false;
+
+    uint32_t blocksX = (width + 3) / 4;
+    uint32_t blocksY = (height + 3) / 4;
+    uint8_t texels[16 * 4];
+
+    for (uint32_t by = 0; by < blocksY; ++by) {
+        for (uint32_t bx = 0; bx < blocksX; ++bx) {
+            switch (format) {
+                case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                    // 无 alpha 的 BC1：三色模式的第 4 个颜色是不透明黑
+                    decodeColorBlock(src, texels, true);
+                    for (int i = 0; i < 16; ++i) texels[i * 4 + 3] = 255;
+                    src += 8;
+                    break;
+                case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+                case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                    decodeColorBlock(src, texels, true);
+                    src += 8;
+                    break;
+                case VK_FORMAT_BC2_UNORM_BLOCK:
+                case VK_FORMAT_BC2_SRGB_BLOCK:
+                    decodeColorBlock(src + 8, texels, false);
+                    // 显式 4 位 alpha
+                    for (int i = 0; i < 16; ++i) {
+                        uint8_t a = (src[i / 2] >> ((i & 1) * 4)) & 0xF;
+                        texels[i * 4 + 3] = static_cast<uint8_t>(a * 17);
+                    }
+                    src += 16;
+                    break;
+                case VK_FORMAT_BC3_UNORM_BLOCK:
+                case VK_FORMAT_BC3_SRGB_BLOCK:
+                    decodeColorBlock(src + 8, texels, false);
+                    decodeAlphaBlock(src, texels + 3, 4);
+                    src += 16;
+                    break;
+                case VK_FORMAT_BC4_UNORM_BLOCK:
+                    memset(texels, 0, sizeof(texels));
+                    decodeAlphaBlock(src, texels, 4);
+                    for (int i = 0; i < 16; ++i) texels[i * 4 + 3] = 255;
+                    src += 8;
+                    break;
+                case VK_FORMAT_BC4_SNORM_BLOCK:
+                    // 输出 R8G8B8A8_SNORM，alpha 为 127（1.0）
+                    memset(texels, 0, sizeof(texels));
+                    decodeSignedAlphaBlock(src, texels, 4);
+                    for (int i = 0; i < 16; ++i) texels[i * 4 + 3] = 127;
+                    src += 8;
+                    break;
+                case VK_FORMAT_BC5_UNORM_BLOCK:
+                    memset(texels, 0, sizeof(texels));
+                    decodeAlphaBlock(src, texels, 4);
+                    decodeAlphaBlock(src + 8, texels + 1, 4);
+                    for (int i = 0; i < 16; ++i) texels[i * 4 + 3] = 255;
+                    src += 16;
+                    break;
+                case VK_FORMAT_BC5_SNORM_BLOCK:
+                    memset(texels, 0, sizeof(texels));
+                    decodeSignedAlphaBlock(src, texels, 4);
+                    decodeSignedAlphaBlock(src + 8, texels + 1, 4);
+                    for (int i = 0; i < 16; ++i) texels[i * 4 + 3] = 127;
+                    src += 16;
+                    break;
+                case VK_FORMAT_BC7_UNORM_BLOCK:
+                case VK_FORMAT_BC7_SRGB_BLOCK:
+                    decodeBC7Block(src, texels);
+                    src += 16;
+                    break;
+                default:
+                    return false;
+            }
+
+            // 写回目标图像，裁掉超出边界的纹素
+            uint32_t copyWidth = std::min(4u, width - bx * 4);
+            uint32_t copyHeight = std::min(4u, height - by * 4);
+            for (uint32_t y = 0; y < copyHeight; ++y) {
+                uint8_t* row = dst + ((static_cast<size_t>(by) * 4 + y) * width + bx * 4) * 4;
+                memcpy(row, texels + y * 16, copyWidth * 4);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+/*
+ * @class BCDecoder
+ * @brief BC 块压缩格式的 CPU 解压，用于设备不支持对应格式时的回退路径。
+ *
+ * 支持 BC1/BC2/BC3/BC4/BC5/BC7（UNORM/SRGB，以及 BC4/BC5 的 SNORM），
+ * 输出为 RGBA8；BC4 输出 (r,0,0,1)，BC5 输出 (r,g,0,1)，与硬件采样的结果一致。
+ * SNORM 格式按有符号解码，输出每字节为 int8，需以 R8G8B8A8_SNORM 上传（见 getDecodedFormat）。
+ * BC6H 是 HDR 格式，与 ASTC 一样不在此列，设备不支持时由调用方报错。
+ */
+class BCDecoder {
+public:
+    static bool canDecode(VkFormat format);
+    static bool isSigned(VkFormat format);
+    // 解压结果应使用的图像格式：R8G8B8A8 的 UNORM/SRGB/SNORM 之一
+    static VkFormat getDecodedFormat(VkFormat format, bool isSrgb);
+
+    /*
+     * @brief 把一整级 mip 解压为 RGBA8。
+     * @param src 按行排列的压缩块，共 ceil(width/4) * ceil(height/4) 块
+     * @param dst 至少 width * height * 4 字节，行紧密排列
+     */
+    static bool decodeToRGBA8(VkFormat format, const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst);
+
+private:
+    static void decodeColorBlock(const uint8_t* block, uint8_t* rgba, bool allowPunchThrough);
+    static void decodeAlphaBlock(const uint8_t* block, uint8_t* values, uint32_t stride);
+    static void decodeSignedAlphaBlock(const uint8_t* block, uint8_t* values, uint32_t stride);
+    static void decodeBC7Block(const uint8_t* block, uint8_t* rgba);
+};
@@ -0,0 +1,165 @@
+#include "CommandBufferPool.h"
+#include <stdexcept>
+
+CommandBufferPool::CommandBufferPool(VkDevice device, uint32_t queueFamilyIndex)
+    : _device(device), _queueFamilyIndex(queueFamilyIndex) {
+}
+
+CommandBufferPool::~CommandBufferPool() {
+    // 等所有未回收的提交完成后再销毁
+    for (auto& [ticket, entry] : _pending) {
+        vkWaitForFences(_device, 1, &entry.second, VK_TRUE, UINT64_MAX);
+    }
+    for (auto& [threadId, threadPools] : _threads) {
+        for (auto& subPool : threadPools.subPools) {
+            for (VkFence fence : subPool->fences) {
+                vkDestroyFence(_device, fence, nullptr);
+            }
+            // 销毁命令池会一并释放其中的命令缓冲区
+            vkDestroyCommandPool(_device, subPool->pool, nullptr);
+        }
+    }
+}
+
+CommandBufferPool::SubPool* CommandBufferPool::createSubPool() {
+    auto subPool = std::make_unique<SubPool>();
+
+    // 不设置 RESET_COMMAND_BUFFER_BIT：命令缓冲区只随整个池一起重置
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = _queueFamilyIndex;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    if (vkCreateCommandPool(_device, &poolInfo, nullptr, &subPool->pool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create command pool!");
+    }
+
+    ThreadPools& threadPools = _threads[std::this_thread::get_id()];
+    threadPools.subPools.push_back(std::move(subPool));
+    return threadPools.subPools.back().get();
+}
+
+bool CommandBufferPool::tryResetSubPool(SubPool& subPool) {
+    if (subPool.recording > 0 || subPool.waiters > 0) return false;
+    for (size_t i = 0; i < subPool.fencesUsed; ++i) {
+        if (vkGetFenceStatus(_device, subPool.fences[i]) != VK_SUCCESS) return false;
+    }
+
+    // 所有提交都已完成：整体重置命令池与 fence，本轮的编号全部视为已完成
+    vkResetCommandPool(_device, subPool.pool, 0);
+    if (subPool.fencesUsed > 0) {
+        vkResetFences(_device, static_cast<uint32_t>(subPool.fencesUsed), subPool.fences.data());
+    }
+    for (Ticket ticket : subPool.tickets) {
+        _pending.erase(ticket);
+    }
+    subPool.tickets.clear();
+    subPool.used = 0;
+    subPool.fencesUsed = 0;
+    return true;
+}
+
+VkCommandBuffer CommandBufferPool::begin() {
+    VkCommandBuffer cmd;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ThreadPools& threadPools = _threads[std::this_thread::get_id()];
+        SubPool* subPool = threadPools.subPools.empty() ? nullptr : threadPools.subPools[threadPools.current].get();
+
+        // 当前子池已用满：找一个可以整体重置的子池，找不到就新建
+        if (!subPool || subPool->used == kBuffersPerSubPool) {
+            subPool = nullptr;
+            for (size_t i = 0; i < threadPools.subPools.size(); ++i) {
+                if (tryResetSubPool(*threadPools.subPools[i])) {
+                    threadPools.current = i;
+                    subPool = threadPools.subPools[i].get();
+                    break;
+                }
+            }
+            if (!subPool) {
+                subPool = createSubPool();
+                threadPools.current = threadPools.subPools.size() - 1;
+            }
+        }
+
+        if (subPool->used == subPool->buffers.size()) {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = subPool->pool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(_device, &allocInfo, &cmd) != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate command buffer!");
+            }
+            subPool->buffers.push_back(cmd);
+            _owners[cmd] = subPool;
+        }
+        cmd = subPool->buffers[subPool->used++];
+        subPool->recording++;
+    }
+
+    // 记录在锁外进行，每个线程只会碰到自己子池中的命令缓冲区
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+    return cmd;
+}
+
+CommandBufferPool::Ticket CommandBufferPool::submit(VkCommandBuffer cmd, VkQueue queue, VkSubmitInfo submitInfo) {
+    vkEndCommandBuffer(cmd);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto owner = _owners.find(cmd);
+    if (owner == _owners.end()) {
+        throw std::runtime_error("command buffer was not allocated from this pool!");
+    }
+    SubPool& subPool = *owner->second;
+
+    if (subPool.fencesUsed == subPool.fences.size()) {
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        VkFence fence;
+        if (vkCreateFence(_device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create command buffer fence!");
+        }
+        subPool.fences.push_back(fence);
+    }
+    VkFence fence = subPool.fences[subPool.fencesUsed++];
+
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    // 队列的访问需要外部同步，这里在池的锁内提交
+    if (vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit command buffer!");
+    }
+
+    Ticket ticket = ++_nextTicket;
+    subPool.tickets.push_back(ticket);
+    subPool.recording--;
+    _pending[ticket] = {&subPool, fence};
+    return ticket;
+}
+
+bool CommandBufferPool::isComplete(Ticket ticket) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _pending.find(ticket);
+    if (it == _pending.end()) return true;
+    return vkGetFenceStatus(_device, it->second.second) == VK_SUCCESS;
+}
+
+void CommandBufferPool::wait(Ticket ticket) {
+    SubPool* subPool;
+    VkFence fence;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _pending.find(ticket);
+        if (it == _pending.end()) return;
+        subPool = it->second.first;
+        fence = it->second.second;
+        // 等待期间禁止该子池被重置，否则 fence 可能被复用
+        subPool->waiters++;
+    }
+    vkWaitForFences(_device, 1, &fence, VK_TRUE, UINT64_MAX);
+    std::lock_guard<std::mutex> lock(_mutex);
+    subPool->waiters--;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/*
+ * @class CommandBufferPool
+ * @brief 一次性命令缓冲区的回收池。
+ *
+ * 每个线程拥有自己的一组 VkCommandPool（子池），因此不同线程可以同时记录命令。
+ * 命令缓冲区提交时附带一个由池持有的 fence；当一个子池里所有提交的 fence
+ * 都已触发，整个子池用 vkResetCommandPool 一次性重置，其中的命令缓冲区与 fence
+ * 原地复用，不再逐个 vkAllocateCommandBuffers/vkFreeCommandBuffers。
+ * 提交返回一个编号，用 isComplete()/wait() 查询，不需要 vkQueueWaitIdle。
+ */
+class CommandBufferPool {
+public:
+    using Ticket = uint64_t;
+
+    CommandBufferPool(VkDevice device, uint32_t queueFamilyIndex);
+    ~CommandBufferPool();
+
+    // 禁止拷贝
+    CommandBufferPool(const CommandBufferPool&) = delete;
+    CommandBufferPool& operator=(const CommandBufferPool&) = delete;
+
+    // 从调用线程的子池取一个命令缓冲区，并以 ONE_TIME_SUBMIT 开始记录
+    VkCommandBuffer begin();
+
+    /*
+     * @brief 结束记录并提交到 queue（queue 必须属于构造时的队列族）。
+     * @param submitInfo 可以携带等待/触发的信号量及 pNext 链，命令缓冲区字段会被覆盖。
+     * @return 提交编号；池在对应 fence 触发后自动回收该命令缓冲区。
+     */
+    Ticket submit(VkCommandBuffer cmd, VkQueue queue, VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO});
+
+    bool isComplete(Ticket ticket);
+    void wait(Ticket ticket);
+
+    uint32_t getQueueFamilyIndex() const { return _queueFamilyIndex; }
+
+private:
+    static constexpr size_t kBuffersPerSubPool = 16;
+
+    struct SubPool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> buffers;   // 已分配的命令缓冲区，前 used 个本轮已被取用
+        size_t used = 0;
+        std::vector<VkFence> fences;            // 前 fencesUsed 个本轮已随提交使用
+        size_t fencesUsed = 0;
+        std::vector<Ticket> tickets;            // 本轮的提交
+        uint32_t recording = 0;                 // 已 begin 尚未 submit 的数量
+        uint32_t waiters = 0;                   // 正在 wait() 其中某个 fence 的线程数
+    };
+
+    struct ThreadPools {
+        std::vector<std::unique_ptr<SubPool>> subPools;
+        size_t current = 0;
+    };
+
+    SubPool* createSubPool();
+    bool tryResetSubPool(SubPool& subPool);
+
+    VkDevice _device;
+    uint32_t _queueFamilyIndex;
+
+    std::mutex _mutex;
+    std::unordered_map<std::thread::id, ThreadPools> _threads;
+    std::unordered_map<VkCommandBuffer, SubPool*> _owners;
+    std::unordered_map<Ticket, std::pair<SubPool*, VkFence>> _pending;  // 还未随子池重置而回收的提交
+    Ticket _nextTicket = 0;
+};
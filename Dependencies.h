@@ -4,11 +4,27 @@
 #include "VulkanSwapchain.h"
 #include "VulkanBuffer.h"
 #include "VulkanImage.h"
+#include "ImageDecoder.h"
+#include "MipmapGenerator.h"
 #include "VulkanPipeline.h"
+#include "AsyncPipelineCompiler.h"
+#include "PipelineRegistry.h"
+#include "SpirvReflection.h"
+#include "SpecializationConstants.h"
+#include "DynamicStateTracker.h"
 #include "ImmediateSubmitter.h"
+#include "AsyncUploader.h"
+#include "TextureStreamer.h"
 #include "Renderer.h"
 #include "VulkanQueue.h"
 #include "Model.h"
+#include "ObjParser.h"
+#include "VertexCompressor.h"
+#include "MeshletCuller.h"
+#include "GeometryPool.h"
+#include "ParticleSimulation.h"
+#include "MeshSimplifier.h"
+#include "LodSelector.h"
 #include "DescriptorWriter.h"
 #include "VulkanDescriptorSetLayout.h"
 #include "VulkanDescriptorPool.h"
@@ -0,0 +1,179 @@
+#include "DynamicStateTracker.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+DynamicStateTracker::DynamicStateTracker(VulkanContext& context) {
+    VkDevice device = context.getDevice();
+    auto load = [device](auto& function, const char* name) {
+        function = reinterpret_cast<std::remove_reference_t<decltype(function)>>(vkGetDeviceProcAddr(device, name));
+        if (function == nullptr) {
+            throw std::runtime_error(std::string("failed to load ") + name + "!");
+        }
+    };
+    // 只加载已启用扩展中的函数；管线不会声明未启用扩展的动态状态，对应指针保持为空
+    if (context.isDeviceExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+        load(_vkCmdSetCullModeEXT, "vkCmdSetCullModeEXT");
+        load(_vkCmdSetFrontFaceEXT, "vkCmdSetFrontFaceEXT");
+        load(_vkCmdSetPrimitiveTopologyEXT, "vkCmdSetPrimitiveTopologyEXT");
+        load(_vkCmdSetDepthTestEnableEXT, "vkCmdSetDepthTestEnableEXT");
+        load(_vkCmdSetDepthWriteEnableEXT, "vkCmdSetDepthWriteEnableEXT");
+        load(_vkCmdSetDepthCompareOpEXT, "vkCmdSetDepthCompareOpEXT");
+        load(_vkCmdSetDepthBoundsTestEnableEXT, "vkCmdSetDepthBoundsTestEnableEXT");
+        load(_vkCmdSetStencilTestEnableEXT, "vkCmdSetStencilTestEnableEXT");
+    }
+    if (context.isDeviceExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+        load(_vkCmdSetDepthBiasEnableEXT, "vkCmdSetDepthBiasEnableEXT");
+        load(_vkCmdSetPrimitiveRestartEnableEXT, "vkCmdSetPrimitiveRestartEnableEXT");
+        load(_vkCmdSetRasterizerDiscardEnableEXT, "vkCmdSetRasterizerDiscardEnableEXT");
+    }
+    const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& features3 = context.getExtendedDynamicState3Features();
+    if (features3.extendedDynamicState3PolygonMode) {
+        load(_vkCmdSetPolygonModeEXT, "vkCmdSetPolygonModeEXT");
+    }
+    if (features3.extendedDynamicState3ColorBlendEnable) {
+        load(_vkCmdSetColorBlendEnableEXT, "vkCmdSetColorBlendEnableEXT");
+    }
+    if (features3.extendedDynamicState3ColorWriteMask) {
+        load(_vkCmdSetColorWriteMaskEXT, "vkCmdSetColorWriteMaskEXT");
+    }
+}
+
+void DynamicStateTracker::begin(VkCommandBuffer cmd) {
+    _cmd = cmd;
+    _pipeline = nullptr;
+    _validMask = 0;
+}
+
+VkDynamicState DynamicStateTracker::getDynamicState(Slot slot) {
+    switch (slot) {
+    case CullMode: return VK_DYNAMIC_STATE_CULL_MODE_EXT;
+    case FrontFace: return VK_DYNAMIC_STATE_FRONT_FACE_EXT;
+    case Topology: return VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT;
+    case DepthTest: return VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT;
+    case DepthWrite: return VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT;
+    case DepthCompare: return VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT;
+    case DepthBoundsTest: return VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT;
+    case StencilTest: return VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT;
+    case DepthBias: return VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT;
+    case PrimitiveRestart: return VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT;
+    case RasterizerDiscard: return VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT;
+    case PolygonMode: return VK_DYNAMIC_STATE_POLYGON_MODE_EXT;
+    case BlendEnable: return VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT;
+    case ColorWriteMask: return VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT;
+    case Viewport: return VK_DYNAMIC_STATE_VIEWPORT;
+    case Scissor: return VK_DYNAMIC_STATE_SCISSOR;
+    default: throw std::runtime_error("invalid dynamic state slot!");
+    }
+}
+
+void DynamicStateTracker::bindPipeline(VulkanPipeline& pipeline, VkPipelineBindPoint bindPoint) {
+    if (_cmd == VK_NULL_HANDLE) {
+        throw std::runtime_error("DynamicStateTracker::begin must be called before binding a pipeline!");
+    }
+    if (_pipeline == &pipeline) {
+        _stats.skipped++;
+        return;
+    }
+    pipeline.bind(_cmd, bindPoint);
+    _pipeline = &pipeline;
+    _stats.emitted++;
+
+    // 新管线中静态的状态会覆盖之前设置的动态值
+    for (uint32_t slot = 0; slot < SlotCount; ++slot) {
+        if (!pipeline.isDynamic(getDynamicState(static_cast<Slot>(slot)))) {
+            _validMask &= ~(1u << slot);
+        }
+    }
+}
+
+bool DynamicStateTracker::update(Slot slot, bool dynamic, uint32_t value) {
+    if (!dynamic) {
+        return false;
+    }
+    const uint32_t bit = 1u << slot;
+    if ((_validMask & bit) && _values[slot] == value) {
+        _stats.skipped++;
+        return false;
+    }
+    _validMask |= bit;
+    _values[slot] = value;
+    _stats.emitted++;
+    return true;
+}
+
+void DynamicStateTracker::setState(const State& state) {
+    if (_pipeline == nullptr) {
+        throw std::runtime_error("DynamicStateTracker::setState called before binding a pipeline!");
+    }
+    auto dynamic = [this](Slot slot) { return _pipeline->isDynamic(getDynamicState(slot)); };
+
+    if (update(CullMode, dynamic(CullMode), state.cullMode)) {
+        _vkCmdSetCullModeEXT(_cmd, state.cullMode);
+    }
+    if (update(FrontFace, dynamic(FrontFace), state.frontFace)) {
+        _vkCmdSetFrontFaceEXT(_cmd, state.frontFace);
+    }
+    if (update(Topology, dynamic(Topology), state.topology)) {
+        _vkCmdSetPrimitiveTopologyEXT(_cmd, state.topology);
+    }
+    if (update(DepthTest, dynamic(DepthTest), state.depthTestEnable)) {
+        _vkCmdSetDepthTestEnableEXT(_cmd, state.depthTestEnable ? VK_TRUE : VK_FALSE);
+    }
+    if (update(DepthWrite, dynamic(DepthWrite), state.depthWriteEnable)) {
+        _vkCmdSetDepthWriteEnableEXT(_cmd, state.depthWriteEnable ? VK_TRUE : VK_FALSE);
+    }
+    if (update(DepthCompare, dynamic(DepthCompare), state.depthCompareOp)) {
+        _vkCmdSetDepthCompareOpEXT(_cmd, state.depthCompareOp);
+    }
+    if (update(DepthBoundsTest, dynamic(DepthBoundsTest), state.depthBoundsTestEnable)) {
+        _vkCmdSetDepthBoundsTestEnableEXT(_cmd, state.depthBoundsTestEnable ? VK_TRUE : VK_FALSE);
+    }
+    if (update(StencilTest, dynamic(StencilTest), state.stencilTestEnable)) {
+        _vkCmdSetStencilTestEnableEXT(_cmd, state.stencilTestEnable ? VK_TRUE : VK_FALSE);
+    }
+    if (update(DepthBias, dynamic(DepthBias), state.depthBiasEnable)) {
+        _vkCmdSetDepthBiasEnableEXT(_cmd, state.depthBiasEnable ? VK_TRUE : VK_FALSE);
+    }
+    if (update(PrimitiveRestart, dynamic(PrimitiveRestart), state.primitiveRestartEnable)) {
+        _vkCmdSetPrimitiveRestartEnableEXT(_cmd, state.primitiveRestartEnable ? VK_TRUE : VK_FALSE);
+    }
+    if (update(RasterizerDiscard, dynamic(RasterizerDiscard), state.rasterizerDiscardEnable)) {
+        _vkCmdSetRasterizerDiscardEnableEXT(_cmd, state.rasterizerDiscardEnable ? VK_TRUE : VK_FALSE);
+    }
+    if (update(PolygonMode, dynamic(PolygonMode), state.polygonMode)) {
+        _vkCmdSetPolygonModeEXT(_cmd, state.polygonMode);
+    }
+    if (update(BlendEnable, dynamic(BlendEnable), state.blendEnable)) {
+        VkBool32 blendEnable = state.blendEnable ? VK_TRUE : VK_FALSE;
+        _vkCmdSetColorBlendEnableEXT(_cmd, 0, 1, &blendEnable);
+    }
+    if (update(ColorWriteMask, dynamic(ColorWriteMask), state.colorWriteMask)) {
+        _vkCmdSetColorWriteMaskEXT(_cmd, 0, 1, &state.colorWriteMask);
+    }
+}
+
+void DynamicStateTracker::setViewport(const VkViewport& viewport) {
+    const uint32_t bit = 1u << Viewport;
+    if ((_validMask & bit) && memcmp(&_viewport, &viewport, sizeof(VkViewport)) == 0) {
+        _stats.skipped++;
+        return;
+    }
+    vkCmdSetViewport(_cmd, 0, 1, &viewport);
+    _viewport = viewport;
+    _validMask |= bit;
+    _stats.emitted++;
+}
+
+void DynamicStateTracker::setScissor(const VkRect2D& scissor) {
+    const uint32_t bit = 1u << Scissor;
+    if ((_validMask & bit) && memcmp(&_scissor, &scissor, sizeof(VkRect2D)) == 0) {
+        _stats.skipped++;
+        return;
+    }
+    vkCmdSetScissor(_cmd, 0, 1, &scissor);
+    _scissor = scissor;
+    _validMask |= bit;
+    _stats.emitted++;
+}
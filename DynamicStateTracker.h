@@ -0,0 +1,88 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanPipeline.h"
+#include <cstdint>
+
+/*
+ * @class DynamicStateTracker
+ * @brief 在一个命令缓冲区内跟踪已绑定的管线和已设置的动态状态，只发出真正变化的 vkCmdBindPipeline / vkCmdSet*。
+ *
+ * 配合 PipelineBuilder::useExtendedDynamicState() 使用：剔除模式、深度比较等材质差异不再需要各自的管线，
+ * 绘制前用 setState() 设置即可。只有当前管线声明为动态的状态才会被设置；切换到把某个状态编译进管线的
+ * 管线后，该状态的缓存失效，下次 setState() 会重新设置。
+ *
+ * 每个命令缓冲区开始录制时调用 begin()，缓存不跨命令缓冲区保留。
+ */
+class DynamicStateTracker {
+public:
+    // 默认值与 PipelineBuilder 的默认状态一致
+    struct State {
+        VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+        VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        bool depthTestEnable = true;
+        bool depthWriteEnable = true;
+        VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+        bool depthBoundsTestEnable = false;
+        bool stencilTestEnable = false;
+        bool depthBiasEnable = false;
+        bool primitiveRestartEnable = false;
+        bool rasterizerDiscardEnable = false;
+        VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+        bool blendEnable = false;                           // 作用于颜色附件 0
+        VkColorComponentFlags colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+            | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    };
+
+    struct Stats {
+        uint32_t emitted = 0;   // 实际录制的绑定与状态命令
+        uint32_t skipped = 0;   // 与缓存相同而省略的命令
+    };
+
+    explicit DynamicStateTracker(VulkanContext& context);
+
+    // 开始录制新的命令缓冲区，清空缓存
+    void begin(VkCommandBuffer cmd);
+
+    void bindPipeline(VulkanPipeline& pipeline, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
+    void setState(const State& state);
+    void setViewport(const VkViewport& viewport);
+    void setScissor(const VkRect2D& scissor);
+
+    const Stats& getStats() const { return _stats; }
+    void resetStats() { _stats = {}; }
+
+private:
+    enum Slot : uint32_t {
+        CullMode, FrontFace, Topology, DepthTest, DepthWrite, DepthCompare, DepthBoundsTest, StencilTest,
+        DepthBias, PrimitiveRestart, RasterizerDiscard, PolygonMode, BlendEnable, ColorWriteMask,
+        Viewport, Scissor, SlotCount
+    };
+
+    // 状态与缓存相同时返回 false；否则更新缓存并返回 true
+    bool update(Slot slot, bool dynamic, uint32_t value);
+    static VkDynamicState getDynamicState(Slot slot);
+
+    VkCommandBuffer _cmd = VK_NULL_HANDLE;
+    VulkanPipeline* _pipeline = nullptr;
+    uint32_t _validMask = 0;            // 第 i 位表示 _values[i] 与命令缓冲区中的状态一致
+    uint32_t _values[SlotCount] = {};
+    VkViewport _viewport{};
+    VkRect2D _scissor{};
+    Stats _stats;
+
+    PFN_vkCmdSetCullModeEXT _vkCmdSetCullModeEXT = nullptr;
+    PFN_vkCmdSetFrontFaceEXT _vkCmdSetFrontFaceEXT = nullptr;
+    PFN_vkCmdSetPrimitiveTopologyEXT _vkCmdSetPrimitiveTopologyEXT = nullptr;
+    PFN_vkCmdSetDepthTestEnableEXT _vkCmdSetDepthTestEnableEXT = nullptr;
+    PFN_vkCmdSetDepthWriteEnableEXT _vkCmdSetDepthWriteEnableEXT = nullptr;
+    PFN_vkCmdSetDepthCompareOpEXT _vkCmdSetDepthCompareOpEXT = nullptr;
+    PFN_vkCmdSetDepthBoundsTestEnableEXT _vkCmdSetDepthBoundsTestEnableEXT = nullptr;
+    PFN_vkCmdSetStencilTestEnableEXT _vkCmdSetStencilTestEnableEXT = nullptr;
+    PFN_vkCmdSetDepthBiasEnableEXT _vkCmdSetDepthBiasEnableEXT = nullptr;
+    PFN_vkCmdSetPrimitiveRestartEnableEXT _vkCmdSetPrimitiveRestartEnableEXT = nullptr;
+    PFN_vkCmdSetRasterizerDiscardEnableEXT _vkCmdSetRasterizerDiscardEnableEXT = nullptr;
+    PFN_vkCmdSetPolygonModeEXT _vkCmdSetPolygonModeEXT = nullptr;
+    PFN_vkCmdSetColorBlendEnableEXT _vkCmdSetColorBlendEnableEXT = nullptr;
+    PFN_vkCmdSetColorWriteMaskEXT _vkCmdSetColorWriteMaskEXT = nullptr;
+};
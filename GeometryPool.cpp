@@ -0,0 +1,376 @@
+#include "GeometryPool.h"
+#include "ImmediateSubmitter.h"
+#include "VertexCompressor.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+// --- RangeAllocator ---
+
+void GeometryPool::RangeAllocator::reset(uint64_t capacity, uint64_t used) {
+    _free.clear();
+    _capacity = capacity;
+    _used = used;
+    if (used < capacity) {
+        _free[used] = capacity - used;
+    }
+}
+
+bool GeometryPool::RangeAllocator::allocate(uint64_t size, uint64_t& offset) {
+    for (auto it = _free.begin(); it != _free.end(); ++it) {
+        if (it->second < size) continue;
+        offset = it->first;
+        uint64_t remaining = it->second - size;
+        _free.erase(it);
+        if (remaining > 0) {
+            _free[offset + size] = remaining;
+        }
+        _used += size;
+        return true;
+    }
+    return false;
+}
+
+void GeometryPool::RangeAllocator::free(uint64_t offset, uint64_t size) {
+    auto it = _free.emplace(offset, size).first;
+    _used -= size;
+
+    // 与后一个空闲区间相接时合并
+    auto next = std::next(it);
+    if (next != _free.end() && it->first + it->second == next->first) {
+        it->second += next->second;
+        _free.erase(next);
+    }
+    // 与前一个空闲区间相接时合并
+    if (it != _free.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second == it->first) {
+            prev->second += it->second;
+            _free.erase(it);
+        }
+    }
+}
+
+uint64_t GeometryPool::RangeAllocator::getLargestFree() const {
+    uint64_t largest = 0;
+    for (const auto& [offset, size] : _free) {
+        largest = std::max(largest, size);
+    }
+    return largest;
+}
+
+// --- GeometryPool ---
+
+GeometryPool::GeometryPool(VulkanContext& context, ImmediateSubmitter& submitter, VertexFormat format, VertexLayout layout,
+    uint32_t vertexCapacity, uint32_t indexCapacity, VkIndexType indexType)
+    : _context(context), _submitter(submitter), _format(format), _layout(layout), _indexType(indexType) {
+    if (vertexCapacity == 0 || indexCapacity == 0) {
+        throw std::runtime_error("geometry pool capacity must be non-zero");
+    }
+    if (indexType != VK_INDEX_TYPE_UINT16 && indexType != VK_INDEX_TYPE_UINT32) {
+        throw std::runtime_error("geometry pool only supports 16/32-bit indices");
+    }
+    _vertexStride = layout == VertexLayout::Split ? VertexCompressor::getAttributeStride(format) : VertexCompressor::getStride(format);
+    _positionStride = layout == VertexLayout::Split ? VertexCompressor::getPositionStride(format) : 0;
+    _indexSize = indexType == VK_INDEX_TYPE_UINT16 ? 2 : 4;
+
+    // 设备未启用 multiDrawIndirect 时 drawCount 只能为 0 或 1
+    if (context.getEnabledFeatures().multiDrawIndirect) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(context.getPhysicalDevice(), &properties);
+        _maxDrawIndirectCount = std::max(properties.limits.maxDrawIndirectCount, 1u);
+    }
+
+    Buffers buffers = createBuffers(vertexCapacity, indexCapacity);
+    _vertexBuffer = std::move(buffers.vertex);
+    _positionBuffer = std::move(buffers.position);
+    _indexBuffer = std::move(buffers.index);
+    _vertexRanges.reset(vertexCapacity, 0);
+    _indexRanges.reset(indexCapacity, 0);
+}
+
+GeometryPool::~GeometryPool() = default;
+
+GeometryPool::Buffers GeometryPool::createBuffers(uint64_t vertexCapacity, uint64_t indexCapacity) const {
+    // TRANSFER_SRC 用于整理/扩容时的搬运，STORAGE 供计算/网格着色器直接读取
+    const VkBufferUsageFlags common = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    Buffers buffers;
+    buffers.vertex = std::make_unique<VulkanBuffer>(_context, vertexCapacity * _vertexStride,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | common, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (_layout == VertexLayout::Split) {
+        buffers.position = std::make_unique<VulkanBuffer>(_context, vertexCapacity * _positionStride,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | common, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+    buffers.index = std::make_unique<VulkanBuffer>(_context, indexCapacity * _indexSize,
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | common, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    return buffers;
+}
+
+GeometryPool::MeshId GeometryPool::add(const Model& model) {
+    PackedMesh mesh = model.pack(_format, _layout);
+    return add(mesh, model.getLods());
+}
+
+GeometryPool::MeshId GeometryPool::add(const PackedMesh& mesh, std::span<const LodLevel> lods) {
+    if (mesh.format != _format || mesh.layout != _layout) {
+        throw std::runtime_error("mesh vertex format/layout does not match the geometry pool");
+    }
+    if (mesh.vertexCount == 0 || mesh.indexCount == 0) {
+        throw std::runtime_error("cannot add an empty mesh to the geometry pool");
+    }
+    if (_indexType == VK_INDEX_TYPE_UINT16 && mesh.vertexCount > 65536) {
+        throw std::runtime_error("mesh has too many vertices for a 16-bit geometry pool");
+    }
+    for (const LodLevel& lod : lods) {
+        if (static_cast<uint64_t>(lod.firstIndex) + lod.indexCount > mesh.indexCount) {
+            throw std::runtime_error("LOD level exceeds the mesh index range");
+        }
+    }
+
+    // 索引类型与池不同时逐个转换；索引相对网格自身，值不变
+    std::vector<uint8_t> converted;
+    const uint8_t* indexData = mesh.indexData.data();
+    if (mesh.indexType != _indexType) {
+        converted.resize(static_cast<size_t>(mesh.indexCount) * _indexSize);
+        for (uint32_t i = 0; i < mesh.indexCount; ++i) {
+            uint32_t value = 0;
+            if (mesh.indexType == VK_INDEX_TYPE_UINT16) {
+                uint16_t narrow;
+                memcpy(&narrow, indexData + i * 2, 2);
+                value = narrow;
+            } else {
+                memcpy(&value, indexData + i * 4, 4);
+            }
+            if (_indexType == VK_INDEX_TYPE_UINT16) {
+                uint16_t narrow = static_cast<uint16_t>(value);
+                memcpy(converted.data() + i * 2, &narrow, 2);
+            } else {
+                memcpy(converted.data() + i * 4, &value, 4);
+            }
+        }
+        indexData = converted.data();
+    }
+
+    uint64_t vertexOffset = 0, indexOffset = 0;
+    allocate(mesh.vertexCount, mesh.indexCount, vertexOffset, indexOffset);
+
+    _submitter.copyDataToBuffer(mesh.vertexData.data(), *_vertexBuffer,
+        static_cast<VkDeviceSize>(mesh.vertexCount) * _vertexStride, vertexOffset * _vertexStride);
+    if (_layout == VertexLayout::Split) {
+        _submitter.copyDataToBuffer(mesh.positionData.data(), *_positionBuffer,
+            static_cast<VkDeviceSize>(mesh.vertexCount) * _positionStride, vertexOffset * _positionStride);
+    }
+    _submitter.copyDataToBuffer(indexData, *_indexBuffer,
+        static_cast<VkDeviceSize>(mesh.indexCount) * _indexSize, indexOffset * _indexSize);
+
+    MeshRange range;
+    range.firstIndex = static_cast<uint32_t>(indexOffset);
+    range.indexCount = mesh.indexCount;
+    range.vertexOffset = static_cast<int32_t>(vertexOffset);
+    range.vertexCount = mesh.vertexCount;
+    range.dequantization = mesh.dequantization;
+    if (lods.empty()) {
+        range.lods.push_back({ range.firstIndex, mesh.indexCount, 0.0f });
+    } else {
+        for (const LodLevel& lod : lods) {
+            range.lods.push_back({ range.firstIndex + lod.firstIndex, lod.indexCount, lod.error });
+        }
+    }
+
+    MeshId id;
+    if (!_freeIds.empty()) {
+        id = _freeIds.back();
+        _freeIds.pop_back();
+        _meshes[id] = std::move(range);
+        _alive[id] = 1;
+    } else {
+        id = static_cast<MeshId>(_meshes.size());
+        _meshes.push_back(std::move(range));
+        _alive.push_back(1);
+    }
+    return id;
+}
+
+void GeometryPool::remove(MeshId id) {
+    if (id >= _meshes.size() || !_alive[id]) {
+        throw std::runtime_error("invalid geometry pool mesh id");
+    }
+    const MeshRange& range = _meshes[id];
+    _vertexRanges.free(static_cast<uint64_t>(range.vertexOffset), range.vertexCount);
+    _indexRanges.free(range.firstIndex, range.indexCount);
+    _meshes[id] = {};
+    _alive[id] = 0;
+    _freeIds.push_back(id);
+}
+
+const GeometryPool::MeshRange& GeometryPool::getRange(MeshId id) const {
+    if (id >= _meshes.size() || !_alive[id]) {
+        throw std::runtime_error("invalid geometry pool mesh id");
+    }
+    return _meshes[id];
+}
+
+VkDrawIndexedIndirectCommand GeometryPool::getDrawCommand(MeshId id, uint32_t lod, uint32_t instanceCount, uint32_t firstInstance) const {
+    const MeshRange& range = getRange(id);
+    if (lod >= range.lods.size()) {
+        throw std::runtime_error("LOD level out of range");
+    }
+    VkDrawIndexedIndirectCommand command{};
+    command.indexCount = range.lods[lod].indexCount;
+    command.instanceCount = instanceCount;
+    command.firstIndex = range.lods[lod].firstIndex;
+    command.vertexOffset = range.vertexOffset;
+    command.firstInstance = firstInstance;
+    return command;
+}
+
+void GeometryPool::allocate(uint32_t vertexCount, uint32_t indexCount, uint64_t& vertexOffset, uint64_t& indexOffset) {
+    if (_vertexRanges.allocate(vertexCount, vertexOffset)) {
+        if (_indexRanges.allocate(indexCount, indexOffset)) return;
+        _vertexRanges.free(vertexOffset, vertexCount);
+    }
+
+    // 空闲总量足够时整理即可，否则扩容到至少两倍
+    uint64_t vertexCapacity = _vertexRanges.getCapacity();
+    if (vertexCapacity - _vertexRanges.getUsed() < vertexCount) {
+        vertexCapacity = std::max(vertexCapacity * 2, _vertexRanges.getUsed() + vertexCount);
+    }
+    uint64_t indexCapacity = _indexRanges.getCapacity();
+    if (indexCapacity - _indexRanges.getUsed() < indexCount) {
+        indexCapacity = std::max(indexCapacity * 2, _indexRanges.getUsed() + indexCount);
+    }
+    if (vertexCapacity > static_cast<uint64_t>(INT32_MAX) || indexCapacity > UINT32_MAX) {
+        throw std::runtime_error("geometry pool exceeds the addressable vertex/index range");
+    }
+    relocate(vertexCapacity, indexCapacity);
+
+    if (!_vertexRanges.allocate(vertexCount, vertexOffset) || !_indexRanges.allocate(indexCount, indexOffset)) {
+        throw std::runtime_error("failed to allocate from geometry pool");
+    }
+}
+
+void GeometryPool::compact() {
+    relocate(_vertexRanges.getCapacity(), _indexRanges.getCapacity());
+}
+
+void GeometryPool::relocate(uint64_t vertexCapacity, uint64_t indexCapacity) {
+    // 拷贝源中可能还有当前批次里尚未提交的上传，先提交并等待，搬运完成后再为调用方重新开启批次
+    const bool wasBatching = _submitter.isBatching();
+    if (wasBatching) {
+        _submitter.wait(_submitter.flush());
+    }
+
+    Buffers next = createBuffers(vertexCapacity, indexCapacity);
+
+    std::vector<MeshId> live;
+    for (MeshId id = 0; id < _meshes.size(); ++id) {
+        if (_alive[id]) live.push_back(id);
+    }
+
+    // 相邻的区间在新旧缓冲区中都连续时合并成一个拷贝区域
+    auto appendCopy = [](std::vector<VkBufferCopy>& copies, VkDeviceSize src, VkDeviceSize dst, VkDeviceSize size) {
+        if (!copies.empty()) {
+            VkBufferCopy& last = copies.back();
+            if (last.srcOffset + last.size == src && last.dstOffset + last.size == dst) {
+                last.size += size;
+                return;
+            }
+        }
+        copies.push_back({ src, dst, size });
+    };
+
+    // 顶点与索引的排列顺序可能不同，分别按原偏移排序后依次紧密排列，保持原有的相对顺序
+    std::vector<VkBufferCopy> vertexCopies, positionCopies, indexCopies;
+    std::sort(live.begin(), live.end(), [&](MeshId a, MeshId b) { return _meshes[a].vertexOffset < _meshes[b].vertexOffset; });
+    uint64_t vertexCursor = 0;
+    for (MeshId id : live) {
+        MeshRange& range = _meshes[id];
+        const uint64_t source = static_cast<uint64_t>(range.vertexOffset);
+        appendCopy(vertexCopies, source * _vertexStride, vertexCursor * _vertexStride, static_cast<VkDeviceSize>(range.vertexCount) * _vertexStride);
+        if (_layout == VertexLayout::Split) {
+            appendCopy(positionCopies, source * _positionStride, vertexCursor * _positionStride, static_cast<VkDeviceSize>(range.vertexCount) * _positionStride);
+        }
+        range.vertexOffset = static_cast<int32_t>(vertexCursor);
+        vertexCursor += range.vertexCount;
+    }
+
+    std::sort(live.begin(), live.end(), [&](MeshId a, MeshId b) { return _meshes[a].firstIndex < _meshes[b].firstIndex; });
+    uint64_t indexCursor = 0;
+    for (MeshId id : live) {
+        MeshRange& range = _meshes[id];
+        appendCopy(indexCopies, static_cast<VkDeviceSize>(range.firstIndex) * _indexSize, indexCursor * _indexSize,
+            static_cast<VkDeviceSize>(range.indexCount) * _indexSize);
+        for (LodLevel& lod : range.lods) {
+            lod.firstIndex = lod.firstIndex - range.firstIndex + static_cast<uint32_t>(indexCursor);
+        }
+        range.firstIndex = static_cast<uint32_t>(indexCursor);
+        indexCursor += range.indexCount;
+    }
+
+    if (!live.empty()) {
+        // 非批处理模式下 submit 会等待拷贝完成，之后旧缓冲区可以安全销毁
+        _submitter.submit([&](VkCommandBuffer cmd) {
+            vkCmdCopyBuffer(cmd, _vertexBuffer->GetBuffer(), next.vertex->GetBuffer(), static_cast<uint32_t>(vertexCopies.size()), vertexCopies.data());
+            if (!positionCopies.empty()) {
+                vkCmdCopyBuffer(cmd, _positionBuffer->GetBuffer(), next.position->GetBuffer(), static_cast<uint32_t>(positionCopies.size()), positionCopies.data());
+            }
+            vkCmdCopyBuffer(cmd, _indexBuffer->GetBuffer(), next.index->GetBuffer(), static_cast<uint32_t>(indexCopies.size()), indexCopies.data());
+        });
+    }
+
+    _vertexBuffer = std::move(next.vertex);
+    _positionBuffer = std::move(next.position);
+    _indexBuffer = std::move(next.index);
+    _vertexRanges.reset(vertexCapacity, vertexCursor);
+    _indexRanges.reset(indexCapacity, indexCursor);
+
+    if (wasBatching) {
+        _submitter.beginBatch();
+    }
+    std::cout << "[INFO] geometry pool relocated " << live.size() << " meshes: "
+              << vertexCursor << "/" << vertexCapacity << " vertices, "
+              << indexCursor << "/" << indexCapacity << " indices" << std::endl;
+}
+
+GeometryPool::Stats GeometryPool::getStats() const {
+    Stats stats;
+    stats.meshCount = static_cast<uint32_t>(_meshes.size() - _freeIds.size());
+    stats.vertexCapacity = _vertexRanges.getCapacity();
+    stats.usedVertices = _vertexRanges.getUsed();
+    stats.largestFreeVertices = _vertexRanges.getLargestFree();
+    stats.indexCapacity = _indexRanges.getCapacity();
+    stats.usedIndices = _indexRanges.getUsed();
+    stats.largestFreeIndices = _indexRanges.getLargestFree();
+    return stats;
+}
+
+void GeometryPool::bind(VkCommandBuffer cmd) const {
+    if (_layout == VertexLayout::Split) {
+        VkBuffer buffers[] = { _positionBuffer->GetBuffer(), _vertexBuffer->GetBuffer() };
+        VkDeviceSize offsets[] = { 0, 0 };
+        vkCmdBindVertexBuffers(cmd, 0, 2, buffers, offsets);
+    } else {
+        VkBuffer buffer = _vertexBuffer->GetBuffer();
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(cmd, 0, 1, &buffer, &offset);
+    }
+    vkCmdBindIndexBuffer(cmd, _indexBuffer->GetBuffer(), 0, _indexType);
+}
+
+void GeometryPool::bindPositions(VkCommandBuffer cmd) const {
+    VkBuffer buffer = _layout == VertexLayout::Split ? _positionBuffer->GetBuffer() : _vertexBuffer->GetBuffer();
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &buffer, &offset);
+    vkCmdBindIndexBuffer(cmd, _indexBuffer->GetBuffer(), 0, _indexType);
+}
+
+void GeometryPool::recordDrawIndirect(VkCommandBuffer cmd, VkBuffer commandBuffer, VkDeviceSize offset, uint32_t drawCount) const {
+    constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    while (drawCount > 0) {
+        uint32_t count = std::min(drawCount, _maxDrawIndirectCount);
+        vkCmdDrawIndexedIndirect(cmd, commandBuffer, offset, count, stride);
+        offset += static_cast<VkDeviceSize>(count) * stride;
+        drawCount -= count;
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanBuffer.h"
+#include "Model.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <vector>
+
+class ImmediateSubmitter;
+
+/*
+ * @class GeometryPool
+ * @brief 全局几何大缓冲区：一个顶点缓冲区 + 一个索引缓冲区，按网格子分配。
+ *
+ * 每个网格占用顶点缓冲区中连续的 vertexCount 个顶点和索引缓冲区中连续的一段索引（含全部 LOD），
+ * 索引保持相对网格自身的第一个顶点，绘制时通过 vertexOffset 定位，因此上传时不需要改写索引。
+ * 整个场景只需绑定一次顶点/索引缓冲区，每个网格（或 LOD 级别）对应一条 VkDrawIndexedIndirectCommand，
+ * 可以写进间接绘制缓冲区后用一次 vkCmdDrawIndexedIndirect（multiDrawIndirect）提交。
+ *
+ * 两个缓冲区各用一个首次适配的空闲区间表管理（单位分别为顶点和索引），释放时与相邻空闲区间合并。
+ * 空间不足时先整理（compact），仍然不够再把容量扩大到至少两倍；两者都会新建缓冲区并用 vkCmdCopyBuffer
+ * 把存活的网格紧密地搬过去，之后 getRange() 返回的偏移会改变，调用方需要重新生成间接绘制命令。
+ * 新建缓冲区会替换旧的 VkBuffer：调用 add()/compact() 时须确保 GPU 不再使用旧缓冲区（例如在帧之间等待渲染围栏）。
+ *
+ * 所有网格共用构造时指定的 VertexFormat 与 VertexLayout；Split 布局额外有一个位置缓冲区，与顶点（属性）缓冲区共用相同的顶点区间。
+ * 量化格式的反量化参数仍然是逐网格的（见 MeshRange::dequantization），需要通过逐实例/逐绘制数据传给着色器。
+ */
+class GeometryPool {
+public:
+    using MeshId = uint32_t;
+    static constexpr MeshId kInvalidMesh = UINT32_MAX;
+
+    struct MeshRange {
+        uint32_t firstIndex;        // 在池索引缓冲区中的起点
+        uint32_t indexCount;        // 占用的索引数（含全部 LOD）
+        int32_t vertexOffset;       // 在池顶点缓冲区中的起点
+        uint32_t vertexCount;
+        std::vector<LodLevel> lods; // firstIndex 已换算为池内位置；没有 LOD 链时只有一级
+        PositionDequantization dequantization;
+    };
+
+    struct Stats {
+        uint32_t meshCount = 0;
+        uint64_t vertexCapacity = 0;
+        uint64_t usedVertices = 0;
+        uint64_t largestFreeVertices = 0;   // 最大的连续空闲区间，与空闲总量相比可以看出碎片程度
+        uint64_t indexCapacity = 0;
+        uint64_t usedIndices = 0;
+        uint64_t largestFreeIndices = 0;
+    };
+
+    /*
+     * @param vertexCapacity 初始顶点容量（顶点个数）
+     * @param indexCapacity 初始索引容量（索引个数）
+     * @param indexType 池内的索引类型；UINT16 时单个网格不能超过 65536 个顶点（索引相对网格，与池大小无关）
+     */
+    GeometryPool(VulkanContext& context, ImmediateSubmitter& submitter, VertexFormat format = VertexFormat::Float32,
+        VertexLayout layout = VertexLayout::Interleaved, uint32_t vertexCapacity = 1u << 20, uint32_t indexCapacity = 4u << 20,
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32);
+    ~GeometryPool();
+
+    // 禁止拷贝
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    /*
+     * @brief 按池的格式打包模型并上传，LOD 链随索引一起放入池中。
+     * 上传通过 ImmediateSubmitter 完成：批处理模式下记录进当前批次，由调用方 flush。
+     */
+    MeshId add(const Model& model);
+    // mesh 的格式与布局必须与池一致；lods 为空时把全部索引视为一级
+    MeshId add(const PackedMesh& mesh, std::span<const LodLevel> lods = {});
+    // 释放网格占用的区间；GPU 可能仍在读取的数据不会被覆盖，直到下一次 add 复用这段空间
+    void remove(MeshId id);
+
+    const MeshRange& getRange(MeshId id) const;
+    VkDrawIndexedIndirectCommand getDrawCommand(MeshId id, uint32_t lod = 0, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+
+    // 把存活的网格紧密排列到缓冲区开头，消除碎片
+    void compact();
+    Stats getStats() const;
+
+    // 一次绑定整个场景的顶点（Split 布局为位置 + 属性两个绑定）与索引缓冲区
+    void bind(VkCommandBuffer cmd) const;
+    // 只绑定位置流（Split 布局）或完整顶点（Interleaved），用于深度预 pass、阴影等只需位置的管线
+    void bindPositions(VkCommandBuffer cmd) const;
+
+    /*
+     * @brief 用 commandBuffer 中从 offset 开始的 drawCount 条 VkDrawIndexedIndirectCommand 绘制。
+     * 支持 multiDrawIndirect 时一次提交（超过 maxDrawIndirectCount 时分段），否则逐条提交。
+     * 调用方负责先 bind()。
+     */
+    void recordDrawIndirect(VkCommandBuffer cmd, VkBuffer commandBuffer, VkDeviceSize offset, uint32_t drawCount) const;
+
+    bool supportsMultiDrawIndirect() const { return _maxDrawIndirectCount > 1; }
+    VertexFormat getFormat() const { return _format; }
+    VertexLayout getLayout() const { return _layout; }
+    VkIndexType getIndexType() const { return _indexType; }
+    VulkanBuffer& getVertexBuffer() const { return *_vertexBuffer; }
+    VulkanBuffer& getIndexBuffer() const { return *_indexBuffer; }
+    // 仅 Split 布局，其余情况为空
+    VulkanBuffer* getPositionBuffer() const { return _positionBuffer.get(); }
+
+private:
+    // 首次适配的区间分配器，空闲区间按起点有序存放，释放时与前后相邻的空闲区间合并
+    class RangeAllocator {
+    public:
+        // [0, used) 视为已占用，其余为一个空闲区间
+        void reset(uint64_t capacity, uint64_t used);
+        bool allocate(uint64_t size, uint64_t& offset);
+        void free(uint64_t offset, uint64_t size);
+
+        uint64_t getCapacity() const { return _capacity; }
+        uint64_t getUsed() const { return _used; }
+        uint64_t getLargestFree() const;
+
+    private:
+        std::map<uint64_t, uint64_t> _free;    // 起点 -> 长度
+        uint64_t _capacity = 0;
+        uint64_t _used = 0;
+    };
+
+    struct Buffers {
+        std::unique_ptr<VulkanBuffer> vertex;
+        std::unique_ptr<VulkanBuffer> position;
+        std::unique_ptr<VulkanBuffer> index;
+    };
+
+    Buffers createBuffers(uint64_t vertexCapacity, uint64_t indexCapacity) const;
+    // 为 vertexCount 个顶点和 indexCount 个索引分配区间，必要时整理或扩容
+    void allocate(uint32_t vertexCount, uint32_t indexCount, uint64_t& vertexOffset, uint64_t& indexOffset);
+    // 新建指定容量的缓冲区并把存活的网格紧密地拷贝过去
+    void relocate(uint64_t vertexCapacity, uint64_t indexCapacity);
+
+    VulkanContext& _context;
+    ImmediateSubmitter& _submitter;
+    VertexFormat _format;
+    VertexLayout _layout;
+    VkIndexType _indexType;
+    uint32_t _vertexStride;     // Interleaved：完整顶点；Split：属性流
+    uint32_t _positionStride;   // 仅 Split
+    uint32_t _indexSize;
+    uint32_t _maxDrawIndirectCount = 1;
+
+    std::unique_ptr<VulkanBuffer> _vertexBuffer;
+    std::unique_ptr<VulkanBuffer> _positionBuffer;
+    std::unique_ptr<VulkanBuffer> _indexBuffer;
+    RangeAllocator _vertexRanges;
+    RangeAllocator _indexRanges;
+
+    std::vector<MeshRange> _meshes;
+    std::vector<uint8_t> _alive;
+    std::vector<MeshId> _freeIds;
+};
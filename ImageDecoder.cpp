@@ -0,0 +1,180 @@
+#include "ImageDecoder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// --- 分配钩子 ---
+// 每个线程同一时间只解码一张图，目标内存放在 thread_local 中，工作线程之间互不干扰
+
+namespace {
+    struct DecodeTarget {
+        void* memory = nullptr;
+        size_t minSize = 0;     // 最终 RGBA8 图像的大小，更小的分配是中间缓冲区
+        size_t size = 0;        // 目标内存可用的容量，不超过 minSize + kDecodeSlack
+        bool inUse = false;     // 目标内存当前是否已被 stb 的某次分配占用
+    };
+    thread_local DecodeTarget t_target;
+}
+
+static void* decoderMalloc(size_t size) {
+    if (t_target.memory && !t_target.inUse && size >= t_target.minSize && size <= t_target.size) {
+        t_target.inUse = true;
+        return t_target.memory;
+    }
+    return malloc(size);
+}
+
+static void decoderFree(void* pointer) {
+    if (pointer && pointer == t_target.memory) {
+        t_target.inUse = false;
+        return;
+    }
+    free(pointer);
+}
+
+static void* decoderRealloc(void* pointer, size_t newSize) {
+    if (pointer && pointer == t_target.memory) {
+        if (newSize <= t_target.size) return pointer;
+        // 目标内存放不下，搬到堆上，目标内存重新变为可用
+        void* moved = malloc(newSize);
+        if (moved) {
+            memcpy(moved, pointer, t_target.size);
+            t_target.inUse = false;
+        }
+        return moved;
+    }
+    return realloc(pointer, newSize);
+}
+
+#define STBI_MALLOC(size) decoderMalloc(size)
+#define STBI_REALLOC(pointer, newSize) decoderRealloc(pointer, newSize)
+#define STBI_FREE(pointer) decoderFree(pointer)
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+bool ImageDecoder::readInfo(const std::string& path, Info& info) {
+    int width, height, channels;
+    if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+        return false;
+    }
+    info.width = static_cast<uint32_t>(width);
+    info.height = static_cast<uint32_t>(height);
+    info.channels = static_cast<uint32_t>(channels);
+    return true;
+}
+
+bool ImageDecoder::decodeRGBA8Into(const std::string& path, void* dst, size_t dstSize, Info& info, bool* zeroCopy) {
+    if (zeroCopy) *zeroCopy = false;
+    if (!readInfo(path, info) || dstSize < info.rgba8Size()) {
+        return false;
+    }
+
+    // 1. 让大小为最终图像（加上 stb 额外申请的几个字节）的那次分配落在 dst 上
+    t_target.memory = dst;
+    t_target.minSize = info.rgba8Size();
+    t_target.size = std::min(dstSize, info.decodeSize());
+    t_target.inUse = false;
+
+    int width, height, channels;
+    stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+    t_target = {};
+
+    if (!pixels) {
+        return false;
+    }
+    if (static_cast<uint32_t>(width) != info.width || static_cast<uint32_t>(height) != info.height) {
+        // 文件在 readInfo 与解码之间被替换了
+        if (pixels != dst) free(pixels);
+        return false;
+    }
+
+    // 2. 最终输出落在堆上（中间缓冲区恰好占用过 dst 等情况），退化为一次拷贝
+    if (pixels != dst) {
+        memcpy(dst, pixels, info.rgba8Size());
+        free(pixels);
+    } else if (zeroCopy) {
+        *zeroCopy = true;
+    }
+    return true;
+}
+
+unsigned char* ImageDecoder::decodeRGBA8(const std::string& path, Info& info) {
+    int width, height, channels;
+    stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (pixels) {
+        info.width = static_cast<uint32_t>(width);
+        info.height = static_cast<uint32_t>(height);
+        info.channels = static_cast<uint32_t>(channels);
+    }
+    return pixels;
+}
+
+void ImageDecoder::freePixels(void* pixels) {
+    stbi_image_free(pixels);
+}
+
+const char* ImageDecoder::failureReason() {
+    return stbi_failure_reason();
+}
+
+size_t ImageDecoder::getPeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);            // macOS 以字节为单位
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;     // Linux 以 KB 为单位
+#endif
+#endif
+}
+
+void ImageDecoder::benchmark(const std::string& path) {
+    Info info;
+    if (!readInfo(path, info)) {
+        std::cerr << "[WARNING] image decode benchmark: failed to read " << path << std::endl;
+        return;
+    }
+    std::vector<uint8_t> dst(info.decodeSize(), 0);
+    auto toMB = [](size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+
+    // 1. 直接解码进目标内存
+    size_t before = getPeakResidentBytes();
+    bool zeroCopy = false;
+    bool succeeded = decodeRGBA8Into(path, dst.data(), dst.size(), info, &zeroCopy);
+    size_t after = getPeakResidentBytes();
+    std::cout << "[INFO] decode " << path << " (" << info.width << "x" << info.height << ") into staging: "
+              << (succeeded ? (zeroCopy ? "zero-copy" : "copied") : "failed") << ", peak RSS "
+              << toMB(before) << " -> " << toMB(after) << " MB" << std::endl;
+
+    // 2. 原来的路径：解码到堆上再拷贝
+    before = getPeakResidentBytes();
+    unsigned char* pixels = decodeRGBA8(path, info);
+    if (pixels) {
+        memcpy(dst.data(), pixels, info.rgba8Size());
+        freePixels(pixels);
+    }
+    after = getPeakResidentBytes();
+    std::cout << "[INFO] decode " << path << " to heap + memcpy: " << (pixels ? "ok" : "failed") << ", peak RSS "
+              << toMB(before) << " -> " << toMB(after) << " MB" << std::endl;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * @class ImageDecoder
+ * @brief stb_image 的封装，支持把像素直接解码进调用方给出的内存（例如持久映射的暂存区）。
+ *
+ * stb_image 的实现放在 ImageDecoder.cpp 中，并通过 STBI_MALLOC/STBI_FREE 钩子接管分配：
+ * 解码期间，若 stb 申请的大小在 [RGBA8 图像大小, RGBA8 图像大小 + kDecodeSlack] 之内，就直接返回目标内存，
+ * 省去一次整图大小的堆分配和一次 memcpy。stb 的 JPEG 输出会多申请 1 字节（n*w*h+1），
+ * 因此目标内存应按 Info::decodeSize() 申请。
+ * 某些格式（如 16 位 PNG、需要通道转换的 PNG）的最终输出可能仍落在堆上，
+ * 此时退化为一次 memcpy，结果不受影响。
+ */
+class ImageDecoder {
+public:
+    // 目标内存在图像大小之外预留的字节数，容纳 stb 输出缓冲区的额外分配
+    static constexpr size_t kDecodeSlack = 1;
+
+    struct Info {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t channels = 0;      // 文件中的原始通道数
+
+        size_t rgba8Size() const { return static_cast<size_t>(width) * height * 4; }
+        // decodeRGBA8Into 的目标内存大小：图像本身加上 kDecodeSlack
+        size_t decodeSize() const { return rgba8Size() + kDecodeSlack; }
+    };
+
+    // 只读取文件头，拿到尺寸和通道数
+    static bool readInfo(const std::string& path, Info& info);
+
+    /*
+     * @brief 把图片解码为 RGBA8 写入 dst。
+     * @param dstSize dst 的容量，必须不小于 info.rgba8Size()；不小于 info.decodeSize() 时所有格式都能直接解码进 dst
+     * @param zeroCopy 可选输出：为 true 表示 stb 直接在 dst 上完成解码，没有发生额外拷贝
+     * @return 失败（文件缺失、格式不支持、尺寸与 info 不符等）时返回 false
+     */
+    static bool decodeRGBA8Into(const std::string& path, void* dst, size_t dstSize, Info& info, bool* zeroCopy = nullptr);
+
+    // 传统路径：解码到 stb 分配的堆内存，使用完毕后调用 freePixels
+    static unsigned char* decodeRGBA8(const std::string& path, Info& info);
+    static void freePixels(void* pixels);
+
+    static const char* failureReason();
+
+    // 进程的峰值常驻内存（字节），无法获取时返回 0
+    static size_t getPeakResidentBytes();
+
+    /*
+     * @brief 分别用 decodeRGBA8Into 与堆路径（decodeRGBA8 + memcpy）解码 path，打印每次解码前后的峰值常驻内存。
+     * 峰值只增不减，因此先测直接解码，再测堆路径；目标内存在测量前分配并写满，模拟持久映射的暂存区。
+     */
+    static void benchmark(const std::string& path);
+};
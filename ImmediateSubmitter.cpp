@@ -1,5 +1,8 @@
 #include "ImmediateSubmitter.h"
 #include <stdexcept>
+#include <cstring>
+#include <chrono>
+#include <iostream>
 
 // 辅助函数，确定布局转换的阶段和访问掩码
 // 您可以根据需要扩展这个函数以支持更多的转换类型
@@ -36,83 +39,142 @@ static void getPipelineStageAndAccessMasks(
 }
 
 
-ImmediateSubmitter::ImmediateSubmitter(VulkanContext& context, VulkanQueue& queue)
-    : _context(context), _queue(queue) {
-    
-    // 1. 创建一个专用于一次性命令的命令池
-    VkCommandPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.queueFamilyIndex = _queue.getFamilyIndex();
-    // VK_COMMAND_POOL_CREATE_TRANSIENT_BIT 提示驱动这个池的命令缓冲区是短暂的，可能带来性能优化
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; 
-    
-    if (vkCreateCommandPool(_context.getDevice(), &poolInfo, nullptr, &_commandPool) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create immediate submit command pool!");
+ImmediateSubmitter::ImmediateSubmitter(VulkanContext& context, VulkanQueue& queue, VkDeviceSize stagingSize)
+    : _context(context), _queue(queue), _commandBuffers(context.getDevice(), queue.getFamilyIndex()),
+      _staging(context, stagingSize) {
+}
+
+ImmediateSubmitter::~ImmediateSubmitter() {
+    if (isBatching()) {
+        flush();
     }
+    retire(_submissionCount, true);
+}
+
+void ImmediateSubmitter::beginBatch() {
+    if (isBatching()) return;
+    // 命令缓冲区从回收池中取出，已处于记录状态
+    _batchCmd = _commandBuffers.begin();
+}
+
+void ImmediateSubmitter::recordPendingBarriers(bool finalBarrier) {
+    VkPipelineStageFlags srcStages = _pendingSrcStages;
+    VkPipelineStageFlags dstStages = _pendingDstStages;
 
-    // 2. 创建一个用于同步的 Fence，初始状态为已触发，以便第一次等待可以立即通过
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    if (vkCreateFence(_context.getDevice(), &fenceInfo, nullptr, &_fence) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create immediate submit fence!");
+    // 批次结束时，让本批次所有传输写入对后续的顶点/索引/着色器读取可见
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                  VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    bool withMemoryBarrier = finalBarrier && _hasTransferWrites;
+    if (withMemoryBarrier) {
+        srcStages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dstStages |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
     }
-    // 立即重置，使其进入未触发状态
-    vkResetFences(_context.getDevice(), 1, &_fence);
+
+    if (_pendingImageBarriers.empty() && !withMemoryBarrier) return;
+
+    vkCmdPipelineBarrier(_batchCmd,
+        srcStages, dstStages,
+        0,
+        withMemoryBarrier ? 1 : 0, withMemoryBarrier ? &memoryBarrier : nullptr,
+        0, nullptr,
+        static_cast<uint32_t>(_pendingImageBarriers.size()), _pendingImageBarriers.data()
+    );
+
+    _pendingImageBarriers.clear();
+    _pendingSrcStages = 0;
+    _pendingDstStages = 0;
 }
 
-ImmediateSubmitter::~ImmediateSubmitter() {
-    vkDestroyFence(_context.getDevice(), _fence, nullptr);
-    vkDestroyCommandPool(_context.getDevice(), _commandPool, nullptr);
+UploadTicket ImmediateSubmitter::flush() {
+    if (!isBatching()) return {};
+
+    // 1. 记录剩余的布局转换与收尾屏障
+    recordPendingBarriers(true);
+    _hasTransferWrites = false;
+
+    // 2. 结束记录并提交，完成情况由回收池的 fence 追踪
+    VkCommandBuffer cmd = _batchCmd;
+    _batchCmd = VK_NULL_HANDLE;
+    CommandBufferPool::Ticket ticket = _commandBuffers.submit(cmd, _queue.getQueue());
+
+    // 3. 把本批次用到的暂存空间归属到这次提交，完成后统一回收
+    uint64_t submissionId = ++_submissionCount;
+    _staging.commit(submissionId);
+    _inFlight.push_back({submissionId, ticket, std::move(_oversizeStaging)});
+    _oversizeStaging.clear();
+
+    return {submissionId};
 }
 
-void ImmediateSubmitter::submit(std::function<void(VkCommandBuffer cmd)>&& function) {
-    VkDevice device = _context.getDevice();
-    VkQueue queue = _queue.getQueue();
-
-    // 1. 分配命令缓冲区
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = _commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer cmd;
-    if (vkAllocateCommandBuffers(device, &allocInfo, &cmd) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate immediate command buffer!");
+void ImmediateSubmitter::retire(uint64_t upTo, bool wait) {
+    while (!_inFlight.empty()) {
+        InFlightBatch& batch = _inFlight.front();
+        if (wait && batch.id <= upTo) {
+            _commandBuffers.wait(batch.ticket);
+        } else if (!_commandBuffers.isComplete(batch.ticket)) {
+            break;
+        }
+        // 批次按顺序提交到同一个队列，前面的完成了才检查后面的；命令缓冲区由回收池回收
+        _completedId = batch.id;
+        _staging.release(batch.id);
+        _inFlight.pop_front();
     }
+}
 
-    // 2. 开始记录命令
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    vkBeginCommandBuffer(cmd, &beginInfo);
+void ImmediateSubmitter::wait(UploadTicket ticket) {
+    if (ticket.value <= _completedId) return;
+    retire(ticket.value, true);
+}
 
-    // 3. 执行调用者提供的、用于记录具体命令的函数
-    function(cmd);
+bool ImmediateSubmitter::isComplete(UploadTicket ticket) {
+    if (ticket.value <= _completedId) return true;
+    retire(0, false);
+    return ticket.value <= _completedId;
+}
 
-    // 4. 结束记录
-    vkEndCommandBuffer(cmd);
+void ImmediateSubmitter::submit(std::function<void(VkCommandBuffer cmd)>&& function) {
+    // 批处理模式下直接记录进当前批次；否则单独开一个批次并立即等待完成
+    bool immediate = !isBatching();
+    if (immediate) beginBatch();
 
-    // 5. 将命令提交到队列
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &cmd;
+    // 之前挂起的布局转换必须在这些命令之前生效
+    recordPendingBarriers(false);
+    function(_batchCmd);
+    _hasTransferWrites = true;
 
-    // 使用 fence 来等待执行完成
-    // 首先重置 fence 为未触发状态
-    vkResetFences(device, 1, &_fence);
-    
-    if (vkQueueSubmit(queue, 1, &submitInfo, _fence) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to submit immediate command buffer!");
+    if (immediate) wait(flush());
+}
+
+StagingRing::Allocation ImmediateSubmitter::allocateStaging(VkDeviceSize size, VkDeviceSize alignment) {
+    StagingRing::Allocation allocation;
+    if (_staging.tryAllocate(size, alignment, allocation)) {
+        return allocation;
     }
 
-    // 6. 阻塞CPU，直到GPU完成命令
-    vkWaitForFences(device, 1, &_fence, VK_TRUE, UINT64_MAX);
+    // 环被更早的批次占满时，等它们完成后再试一次
+    if (!_inFlight.empty() && size <= _staging.getCapacity()) {
+        retire(_submissionCount, true);
+        if (_staging.tryAllocate(size, alignment, allocation)) {
+            return allocation;
+        }
+    }
 
-    // 7. 释放临时的命令缓冲区
-    vkFreeCommandBuffers(device, _commandPool, 1, &cmd);
+    // 仍然放不下（单次请求过大，或当前批次自身已占满环），退化为一个临时 buffer
+    auto buffer = std::make_unique<VulkanBuffer>(
+        _context,
+        size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+    allocation.buffer = buffer->GetBuffer();
+    allocation.offset = 0;
+    allocation.data = buffer->GetMappedMemory();
+    _oversizeStaging.push_back(std::move(buffer));
+    return allocation;
 }
 
 // --- 高级便利函数的实现 ---
@@ -127,61 +189,56 @@ void ImmediateSubmitter::copyBuffer(VulkanBuffer& src, VulkanBuffer& dst, VkDevi
     });
 }
 
-void ImmediateSubmitter::copyDataToBuffer(void* src, VulkanBuffer& dst, VkDeviceSize size) {
-    // 1. 创建 staging buffer
-    VulkanBuffer staging(
-        _context,
-        size,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    );
-    staging.SetData(src, size);
-    // 3. 把 staging buffer 的内容复制到真正的 buffer
+void ImmediateSubmitter::copyDataToBuffer(const void* src, VulkanBuffer& dst, VkDeviceSize size, VkDeviceSize dstOffset) {
+    // 1. 从暂存环中切出一段并写入数据
+    StagingRing::Allocation staging = allocateStaging(size);
+    memcpy(staging.data, src, static_cast<size_t>(size));
+    // 2. 把暂存数据复制到真正的 buffer
     submit([&](VkCommandBuffer cmd) {        
         VkBufferCopy copyRegion{};
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
+        copyRegion.srcOffset = staging.offset;
+        copyRegion.dstOffset = dstOffset;
         copyRegion.size = size;
-        vkCmdCopyBuffer(cmd,staging.GetBuffer(),dst.GetBuffer(),1,&copyRegion);
+        vkCmdCopyBuffer(cmd,staging.buffer,dst.GetBuffer(),1,&copyRegion);
     });
 }
 
-void ImmediateSubmitter::transitionImageLayout(VulkanImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, VkImageAspectFlags aspectMask) {
-    submit([&image, format, oldLayout, newLayout, mipLevels, aspectMask](VkCommandBuffer cmd) {
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = oldLayout;
-        barrier.newLayout = newLayout;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = image.getImage();
-        barrier.subresourceRange.aspectMask = aspectMask;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = mipLevels;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-
-        VkPipelineStageFlags sourceStage;
-        VkAccessFlags sourceAccessMask;
-        VkPipelineStageFlags destinationStage;
-        VkAccessFlags destinationAccessMask;
-        
-        getPipelineStageAndAccessMasks(oldLayout, newLayout, sourceStage, sourceAccessMask, destinationStage, destinationAccessMask);
-        
-        barrier.srcAccessMask = sourceAccessMask;
-        barrier.dstAccessMask = destinationAccessMask;
-
-        vkCmdPipelineBarrier(cmd,
-            sourceStage, destinationStage,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier
-        );
-    });
+void ImmediateSubmitter::transitionImageLayout(VulkanImage& image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, VkImageAspectFlags aspectMask) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image.getImage();
+    barrier.subresourceRange.aspectMask = aspectMask;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = mipLevels;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    VkPipelineStageFlags sourceStage;
+    VkAccessFlags sourceAccessMask;
+    VkPipelineStageFlags destinationStage;
+    VkAccessFlags destinationAccessMask;
+    
+    getPipelineStageAndAccessMasks(oldLayout, newLayout, sourceStage, sourceAccessMask, destinationStage, destinationAccessMask);
+    
+    barrier.srcAccessMask = sourceAccessMask;
+    barrier.dstAccessMask = destinationAccessMask;
+
+    // 不立即记录：挂起到下一条命令之前，与相邻的转换合并成一次屏障调用
+    bool immediate = !isBatching();
+    if (immediate) beginBatch();
+
+    _pendingImageBarriers.push_back(barrier);
+    _pendingSrcStages |= sourceStage;
+    _pendingDstStages |= destinationStage;
+
+    if (immediate) wait(flush());
 }
 
-void ImmediateSubmitter::copyBufferToImage(VulkanBuffer buffer, VulkanImage image, uint32_t width, uint32_t height) {
+void ImmediateSubmitter::copyBufferToImage(VulkanBuffer& buffer, VulkanImage& image, uint32_t width, uint32_t height) {
     submit([&image, &buffer, width, height](VkCommandBuffer cmd) {
         VkBufferImageCopy region{};
         region.bufferOffset = 0;
@@ -198,3 +255,41 @@ void ImmediateSubmitter::copyBufferToImage(VulkanBuffer buffer, VulkanImage imag
     });
 }
 
+// --- 基准测试 ---
+
+ImmediateSubmitter::BenchmarkResult ImmediateSubmitter::benchmark(uint32_t uploadCount, VkDeviceSize uploadSize) {
+    if (isBatching()) {
+        throw std::runtime_error("ImmediateSubmitter::benchmark cannot run inside a batch!");
+    }
+    BenchmarkResult result;
+    // 每次上传写入目标 buffer 中互不重叠的一段，两种方式使用相同的数据和目标
+    std::vector<uint8_t> data(static_cast<size_t>(uploadSize), 0x5A);
+    VulkanBuffer target(_context, uploadSize * uploadCount, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // 1. 每次上传一个命令缓冲区，提交后立即等待
+    uint64_t submissionsBefore = _submissionCount;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < uploadCount; ++i) {
+        copyDataToBuffer(data.data(), target, uploadSize, uploadSize * i);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    result.perUploadMs = std::chrono::duration<double, std::milli>(end - start).count();
+    uint64_t perUploadSubmissions = _submissionCount - submissionsBefore;
+
+    // 2. 所有上传记录进同一个批次（暂存环占满时会自动等待更早的批次），最后等待一次
+    submissionsBefore = _submissionCount;
+    start = std::chrono::high_resolution_clock::now();
+    beginBatch();
+    for (uint32_t i = 0; i < uploadCount; ++i) {
+        copyDataToBuffer(data.data(), target, uploadSize, uploadSize * i);
+    }
+    wait(flush());
+    end = std::chrono::high_resolution_clock::now();
+    result.batchedMs = std::chrono::duration<double, std::milli>(end - start).count();
+    uint64_t batchedSubmissions = _submissionCount - submissionsBefore;
+
+    std::cout << "[INFO] upload benchmark " << uploadCount << " x " << uploadSize / 1024 << " KB: per-upload "
+              << result.perUploadMs << " ms (" << perUploadSubmissions << " submits), batched "
+              << result.batchedMs << " ms (" << batchedSubmissions << " submits)" << std::endl;
+    return result;
+}
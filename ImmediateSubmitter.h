@@ -4,20 +4,36 @@
 #include <functional> // 用于 std::function
 #include "VulkanImage.h"
 #include "VulkanBuffer.h"
+#include "StagingRing.h"
+#include "CommandBufferPool.h"
+#include <memory>
+#include <vector>
+#include <deque>
+
+class MipmapGenerator;
 
 /*
  * @class ImmediateSubmitter
  * @brief 一个用于执行一次性、同步GPU命令的工具类。
  *
- * 这个类封装了一个命令池和一个围栏，提供了一个简单的接口来提交
+ * 这个类封装了一个命令缓冲区回收池，提供了一个简单的接口来提交
  * 简短的命令（如资源拷贝、布局转换）并立即等待其完成。
  * 这对于资源初始化非常有用。
+ * 上传数据时使用内部持久映射的 StagingRing，不再为每次上传新建暂存缓冲区。
  * 注意：这是一个阻塞操作，不应该在性能敏感的主渲染循环中频繁使用。
+ *
+ * 批处理模式：beginBatch() 之后的所有 submit/拷贝/布局转换都记录进同一个命令缓冲区，
+ * 相邻的布局转换会合并成一次 vkCmdPipelineBarrier，最后由 flush() 一次性提交，
+ * 返回的 UploadTicket 可以稍后用 wait()/isComplete() 查询，不必逐次阻塞。
  */
+struct UploadTicket {
+    uint64_t value = 0;     // 0 表示空票据，总是视为已完成
+};
+
 class ImmediateSubmitter {
 public:
     // 构造函数需要知道使用哪个设备和队列来提交命令。
-    ImmediateSubmitter(VulkanContext& context, VulkanQueue& queue);
+    ImmediateSubmitter(VulkanContext& context, VulkanQueue& queue, VkDeviceSize stagingSize = 32ull * 1024 * 1024);
     ~ImmediateSubmitter();
 
     // 禁止拷贝和赋值
@@ -30,19 +46,85 @@ public:
      */
     void submit(std::function<void(VkCommandBuffer cmd)>&& function);
 
+    /*
+     * @brief 开启批处理模式。之后的命令在同一个命令缓冲区中立即记录，直到 flush()。
+     * 批处理期间 submit 的 lambda 会被立刻调用，因此按引用捕获局部变量仍然安全。
+     */
+    void beginBatch();
+
+    /*
+     * @brief 结束当前批次并提交到队列，不等待 GPU。
+     * @return 可用于 wait()/isComplete() 的票据；批次为空时返回空票据。
+     */
+    UploadTicket flush();
+
+    // 阻塞直到票据对应的批次（以及它之前的所有批次）执行完成
+    void wait(UploadTicket ticket);
+    bool isComplete(UploadTicket ticket);
+    bool isBatching() const { return _batchCmd != VK_NULL_HANDLE; }
+
+    /*
+     * @brief 申请一段暂存空间，数据写入 data 后即可在下一次 submit 中作为拷贝源。
+     * 空间在该次提交完成后自动回收；超出环容量的请求退化为临时 buffer。
+     * 批处理中环被占满时，会先等待更早的批次完成以腾出空间。
+     */
+    StagingRing::Allocation allocateStaging(VkDeviceSize size, VkDeviceSize alignment = 16);
+
     // --- 为了方便使用而提供的高级便利函数 ---
     
     void copyBuffer(VulkanBuffer &src, VulkanBuffer &dst, VkDeviceSize size);
     
-    void copyDataToBuffer(void* src, VulkanBuffer& dst, VkDeviceSize size);
+    // dstOffset 为目标 buffer 中的写入位置，用于向子分配的大 buffer 上传一段数据
+    void copyDataToBuffer(const void* src, VulkanBuffer& dst, VkDeviceSize size, VkDeviceSize dstOffset = 0);
 
-    void transitionImageLayout(VulkanImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels = 1, VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+    // 布局转换不会立即记录，而是挂起到下一条拷贝命令（或 flush）之前，与其它转换合并
+    void transitionImageLayout(VulkanImage& image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels = 1, VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
     
-    void copyBufferToImage(VulkanBuffer buffer, VulkanImage image, uint32_t width, uint32_t height);
+    void copyBufferToImage(VulkanBuffer& buffer, VulkanImage& image, uint32_t width, uint32_t height);
+
+    // 纹理工厂生成 mip 链时使用的计算路径；为空时只使用 blit / CPU 路径。生成器由调用方持有
+    void setMipmapGenerator(MipmapGenerator* generator) { _mipmapGenerator = generator; }
+    MipmapGenerator* getMipmapGenerator() const { return _mipmapGenerator; }
+
+    struct BenchmarkResult {
+        double perUploadMs = 0.0;   // 每次上传单独提交并等待
+        double batchedMs = 0.0;     // 所有上传记录进一个批次，一次提交
+    };
+
+    /*
+     * @brief 比较 uploadCount 次 uploadSize 字节的 buffer 上传在逐次提交与批处理下的总耗时（毫秒，含等待 GPU 完成）。
+     * 不能在批处理期间调用。
+     */
+    BenchmarkResult benchmark(uint32_t uploadCount, VkDeviceSize uploadSize = 64 * 1024);
     
 private:
+    struct InFlightBatch {
+        uint64_t id;
+        CommandBufferPool::Ticket ticket;
+        std::vector<std::unique_ptr<VulkanBuffer>> oversizeStaging;
+    };
+
+    // 把挂起的布局转换（以及 flush 时的全局内存屏障）合并为一次 vkCmdPipelineBarrier
+    void recordPendingBarriers(bool finalBarrier);
+    // 回收所有已完成的批次；wait 为 true 时阻塞到 id <= upTo 的批次完成
+    void retire(uint64_t upTo, bool wait);
+
     VulkanContext& _context;
     VulkanQueue& _queue;
-    VkCommandPool _commandPool;
-    VkFence _fence;
+    CommandBufferPool _commandBuffers;
+
+    // 当前正在记录的批次
+    VkCommandBuffer _batchCmd = VK_NULL_HANDLE;
+    std::vector<VkImageMemoryBarrier> _pendingImageBarriers;
+    VkPipelineStageFlags _pendingSrcStages = 0;
+    VkPipelineStageFlags _pendingDstStages = 0;
+    bool _hasTransferWrites = false;
+
+    std::deque<InFlightBatch> _inFlight;
+    uint64_t _completedId = 0;
+
+    StagingRing _staging;
+    uint64_t _submissionCount = 0;
+    std::vector<std::unique_ptr<VulkanBuffer>> _oversizeStaging; // 放不进环的临时暂存，所属批次完成后释放
+    MipmapGenerator* _mipmapGenerator = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "Ktx2File.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const uint8_t kKtx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    // KTX2 文件头（identifier 之后），所有字段均为小端。
+    // 文件中 sgdByteOffset 紧跟在 13 个 uint32 之后，按 4 字节打包避免编译器插入填充
+#pragma pack(push, 4)
+    struct Ktx2Header {
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        // 索引
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+#pragma pack(pop)
+    static_assert(sizeof(Ktx2Header) == 68, "unexpected KTX2 header layout");
+}
+
+Ktx2File::Ktx2File(const std::string& path) : _path(path), _file(path, std::ios::binary) {
+    if (!_file.is_open()) {
+        throw std::runtime_error("failed to open KTX2 file: " + path);
+    }
+
+    // 1. 标识与头部
+    uint8_t identifier[12];
+    Ktx2Header header{};
+    _file.read(reinterpret_cast<char*>(identifier), sizeof(identifier));
+    _file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!_file || memcmp(identifier, kKtx2Identifier, sizeof(identifier)) != 0) {
+        throw std::runtime_error("not a KTX2 file: " + path);
+    }
+    if (header.supercompressionScheme != 0) {
+        throw std::runtime_error("supercompressed KTX2 is not supported: " + path);
+    }
+    if (header.vkFormat == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error("KTX2 file without a Vulkan format (Basis Universal?) is not supported: " + path);
+    }
+    if (header.pixelDepth > 1 || std::max(header.layerCount, 1u) > 1 || header.faceCount > 1) {
+        throw std::runtime_error("only 2D KTX2 textures are supported: " + path);
+    }
+
+    _format = static_cast<VkFormat>(header.vkFormat);
+    _width = header.pixelWidth;
+    _height = std::max(header.pixelHeight, 1u);
+
+    // 2. level 索引紧跟在头部之后；levelCount 为 0 表示只有基础级、由使用方自行生成 mip
+    uint32_t levelCount = std::max(header.levelCount, 1u);
+    _levels.resize(levelCount);
+    _file.read(reinterpret_cast<char*>(_levels.data()), levelCount * sizeof(Level));
+    if (!_file) {
+        throw std::runtime_error("truncated KTX2 level index: " + path);
+    }
+}
+
+void Ktx2File::readLevel(uint32_t level, void* dst) {
+    const Level& info = _levels[level];
+    _file.seekg(static_cast<std::streamoff>(info.byteOffset));
+    _file.read(static_cast<char*>(dst), static_cast<std::streamsize>(info.byteLength));
+    if (!_file) {
+        throw std::runtime_error("failed to read KTX2 level data: " + _path);
+    }
+}
+
+bool Ktx2File::getFormatInfo(VkFormat format, FormatInfo& info) {
+    info = FormatInfo{};
+    switch (format) {
+        // --- 非压缩 ---
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            info.isSrgb = true;
+            [[fallthrough]];
+        case VK_FORMAT_R8G8B8A8_UNORM:
+            info.bytesPerBlock = 4;
+            return true;
+
+        // --- BC ---
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            info.isSrgb = true;
+            [[fallthrough]];
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+            info.bytesPerBlock = 8;
+            break;
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            info.isSrgb = true;
+            [[fallthrough]];
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+            info.bytesPerBlock = 16;
+            break;
+
+        // --- ASTC：块大小不同，每块都是 16 字节 ---
+#define ASTC_CASE(w, h) \
+        case VK_FORMAT_ASTC_##w##x##h##_SRGB_BLOCK: info.isSrgb = true; [[fallthrough]]; \
+        case VK_FORMAT_ASTC_##w##x##h##_UNORM_BLOCK: \
+            info.blockWidth = w; info.blockHeight = h; info.bytesPerBlock = 16; info.isCompressed = true; \
+            return true;
+        ASTC_CASE(4, 4)
+        ASTC_CASE(5, 4)
+        ASTC_CASE(5, 5)
+        ASTC_CASE(6, 5)
+        ASTC_CASE(6, 6)
+        ASTC_CASE(8, 5)
+        ASTC_CASE(8, 6)
+        ASTC_CASE(8, 8)
+        ASTC_CASE(10, 5)
+        ASTC_CASE(10, 6)
+        ASTC_CASE(10, 8)
+        ASTC_CASE(10, 10)
+        ASTC_CASE(12, 10)
+        ASTC_CASE(12, 12)
+#undef ASTC_CASE
+
+        default:
+            return false;
+    }
+
+    // BC 系列统一为 4x4 块
+    info.blockWidth = 4;
+    info.blockHeight = 4;
+    info.isCompressed = true;
+    return true;
+}
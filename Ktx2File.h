@@ -0,0 +1,62 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * @class Ktx2File
+ * @brief KTX2 容器的最小读取器。
+ *
+ * 只解析头部与 level 索引，像素数据按 level 直接从文件读到调用方给出的内存
+ * （通常是持久映射的暂存区）。不支持超压缩（BasisLZ / Zstd），遇到时抛出异常。
+ */
+class Ktx2File {
+public:
+    struct Level {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    // 纹素块描述：非压缩格式的块为 1x1
+    struct FormatInfo {
+        uint32_t blockWidth = 1;
+        uint32_t blockHeight = 1;
+        uint32_t bytesPerBlock = 0;
+        bool isCompressed = false;
+        bool isSrgb = false;
+    };
+
+    explicit Ktx2File(const std::string& path);
+
+    // 禁止拷贝
+    Ktx2File(const Ktx2File&) = delete;
+    Ktx2File& operator=(const Ktx2File&) = delete;
+
+    VkFormat getFormat() const { return _format; }
+    uint32_t getWidth() const { return _width; }
+    uint32_t getHeight() const { return _height; }
+    uint32_t getLevelCount() const { return static_cast<uint32_t>(_levels.size()); }
+    const Level& getLevel(uint32_t level) const { return _levels[level]; }
+
+    // 第 level 级 mip 的尺寸（纹素）
+    uint32_t getLevelWidth(uint32_t level) const { return std::max(1u, _width >> level); }
+    uint32_t getLevelHeight(uint32_t level) const { return std::max(1u, _height >> level); }
+
+    // 把第 level 级的数据读入 dst（至少 getLevel(level).byteLength 字节）
+    void readLevel(uint32_t level, void* dst);
+
+    // 返回 false 表示不认识的格式
+    static bool getFormatInfo(VkFormat format, FormatInfo& info);
+
+private:
+    std::string _path;
+    std::ifstream _file;
+    VkFormat _format = VK_FORMAT_UNDEFINED;
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+    std::vector<Level> _levels;
+};
@@ -0,0 +1,78 @@
+#include "LodSelector.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+float LodSelector::getProjectionScale(float fovY, float viewportHeight) {
+    return viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+}
+
+uint32_t LodSelector::selectLevel(std::span<const LodLevel> levels, const glm::vec3& center, float radius,
+    const glm::vec3& cameraPosition, float projectionScale, float objectScale, float pixelThreshold) {
+    if (levels.empty()) {
+        throw std::runtime_error("cannot select from an empty LOD chain");
+    }
+    float distance = glm::distance(center, cameraPosition) - radius * objectScale;
+    if (distance <= 0.0f) return 0;
+
+    // 误差随级别单调增加，从最粗的一级往回找第一个满足阈值的
+    const float pixelsPerUnit = objectScale * projectionScale / distance;
+    for (size_t level = levels.size() - 1; level > 0; --level) {
+        if (levels[level].error * pixelsPerUnit <= pixelThreshold) {
+            return static_cast<uint32_t>(level);
+        }
+    }
+    return 0;
+}
+
+LodSelector::CrowdStats LodSelector::benchmarkCrowd(std::span<const LodLevel> levels, const MeshBounds& bounds, uint32_t rows, uint32_t cols,
+    float spacing, float fovY, float viewportHeight, float pixelThreshold) {
+    CrowdStats stats;
+    stats.instances = rows * cols;
+    stats.levelHistogram.assign(levels.size(), 0);
+
+    const glm::vec3 localCenter = (bounds.min + bounds.max) * 0.5f;
+    const float radius = 0.5f * glm::length(bounds.max - bounds.min);
+    const float step = 2.0f * radius * spacing;
+    const float projectionScale = getProjectionScale(fovY, viewportHeight);
+    const glm::vec3 cameraPosition(0.0f, radius, 2.0f * radius);
+
+    std::vector<glm::vec3> centers;
+    centers.reserve(stats.instances);
+    for (uint32_t r = 0; r < rows; ++r) {
+        for (uint32_t c = 0; c < cols; ++c) {
+            glm::vec3 offset((c - (cols - 1) * 0.5f) * step, 0.0f, -(r * step));
+            centers.push_back(localCenter + offset);
+        }
+    }
+
+    // 选择本身很便宜，重复多次取平均
+    constexpr int kRepeats = 16;
+    std::vector<uint32_t> selected(centers.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+        for (size_t i = 0; i < centers.size(); ++i) {
+            selected[i] = selectLevel(levels, centers[i], radius, cameraPosition, projectionScale, 1.0f, pixelThreshold);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.selectMs = std::chrono::duration<double, std::milli>(end - start).count() / kRepeats;
+
+    for (uint32_t level : selected) {
+        stats.levelHistogram[level]++;
+        stats.fullTriangles += levels[0].indexCount / 3;
+        stats.lodTriangles += levels[level].indexCount / 3;
+    }
+
+    std::cout << "[INFO] LOD crowd benchmark: " << stats.instances << " instances, triangles "
+              << stats.fullTriangles << " -> " << stats.lodTriangles << " ("
+              << (stats.lodTriangles ? static_cast<double>(stats.fullTriangles) / stats.lodTriangles : 0.0) << "x), selection "
+              << stats.selectMs << " ms, levels:";
+    for (uint32_t count : stats.levelHistogram) {
+        std::cout << " " << count;
+    }
+    std::cout << std::endl;
+    return stats;
+}
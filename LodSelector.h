@@ -0,0 +1,37 @@
+#pragma once
+#include "Model.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ * @class LodSelector
+ * @brief 按屏幕空间误差为每个物体选择 LOD。
+ *
+ * 一级的几何误差 error（物体空间距离）投影到屏幕上约为
+ *   error * objectScale / distance * projectionScale  像素，
+ * 其中 projectionScale = viewportHeight / (2 * tan(fovY / 2))，distance 取相机到包围球表面的距离。
+ * 选择投影误差不超过 pixelThreshold 的最粗一级；相机在包围球内时总是 LOD0。
+ */
+class LodSelector {
+public:
+    struct CrowdStats {
+        uint32_t instances = 0;
+        uint64_t fullTriangles = 0;     // 全部使用 LOD0 时提交的三角形数
+        uint64_t lodTriangles = 0;      // 按 LOD 选择后提交的三角形数
+        std::vector<uint32_t> levelHistogram;
+        double selectMs = 0.0;          // 为全部实例选择一次 LOD 的 CPU 耗时
+    };
+
+    static float getProjectionScale(float fovY, float viewportHeight);
+
+    static uint32_t selectLevel(std::span<const LodLevel> levels, const glm::vec3& center, float radius,
+        const glm::vec3& cameraPosition, float projectionScale, float objectScale = 1.0f, float pixelThreshold = 1.0f);
+
+    /*
+     * @brief 人群场景：rows x cols 个实例排在 XZ 平面上，间距为包围球直径的 spacing 倍，
+     * 相机位于第一排前方、略高于地面并朝 -Z 看去。统计提交的三角形数与选择耗时。
+     */
+    static CrowdStats benchmarkCrowd(std::span<const LodLevel> levels, const MeshBounds& bounds, uint32_t rows = 32, uint32_t cols = 32,
+        float spacing = 1.5f, float fovY = 1.0471976f, float viewportHeight = 1080.0f, float pixelThreshold = 1.0f);
+};
@@ -0,0 +1,105 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("failed to open file for mapping: " + path);
+    }
+    _file = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        close();
+        throw std::runtime_error("failed to query file size: " + path);
+    }
+    _size = static_cast<size_t>(fileSize.QuadPart);
+    if (_size == 0) return;
+
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping == nullptr) {
+        close();
+        throw std::runtime_error("failed to create file mapping: " + path);
+    }
+    _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr) {
+        close();
+        throw std::runtime_error("failed to map file: " + path);
+    }
+#else
+    _fd = open(path.c_str(), O_RDONLY);
+    if (_fd < 0) {
+        throw std::runtime_error("failed to open file for mapping: " + path);
+    }
+
+    struct stat info;
+    if (fstat(_fd, &info) != 0) {
+        close();
+        throw std::runtime_error("failed to query file size: " + path);
+    }
+    _size = static_cast<size_t>(info.st_size);
+    if (_size == 0) return;
+
+    void* mapped = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        throw std::runtime_error("failed to map file: " + path);
+    }
+    _data = static_cast<const uint8_t*>(mapped);
+    // 网格/模型文件基本都是顺序读取
+    madvise(mapped, _size, MADV_SEQUENTIAL);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+#ifdef _WIN32
+        _file = std::exchange(other._file, nullptr);
+        _mapping = std::exchange(other._mapping, nullptr);
+#else
+        _fd = std::exchange(other._fd, -1);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (_data != nullptr) UnmapViewOfFile(_data);
+    if (_mapping != nullptr) CloseHandle(_mapping);
+    if (_file != nullptr) CloseHandle(_file);
+    _mapping = nullptr;
+    _file = nullptr;
+#else
+    if (_data != nullptr) munmap(const_cast<uint8_t*>(_data), _size);
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+#endif
+    _data = nullptr;
+    _size = 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * @class MappedFile
+ * @brief 只读内存映射文件（Windows: MapViewOfFile，其它平台: mmap）。
+ *
+ * 映射在对象析构时解除；空文件的 data() 为 nullptr、size() 为 0。
+ * 打开失败抛出 std::runtime_error。
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    // 禁止拷贝，允许移动
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    void close();
+
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void* _file = nullptr;      // HANDLE
+    void* _mapping = nullptr;   // HANDLE
+#else
+    int _fd = -1;
+#endif
+};
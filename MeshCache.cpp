@@ -0,0 +1,174 @@
+#include "MeshCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    const char kMagic[8] = { 'M', 'E', 'S', 'H', 'C', 'A', 'C', 'H' };
+
+    struct MeshCacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t vertexStride;      // sizeof(Vertex)，布局变化时缓存自动失效
+        uint64_t pathHash;
+        uint64_t sourceSize;
+        int64_t sourceMtime;
+        uint64_t sourceHash;
+        uint64_t vertexCount;
+        uint64_t vertexOffset;
+        uint64_t indexCount;
+        uint64_t indexOffset;
+        uint64_t submeshCount;
+        uint64_t submeshOffset;
+        uint64_t lodCount;
+        uint64_t lodOffset;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + 15) & ~uint64_t(15);
+    }
+
+    uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    // 每次处理 8 字节的 64 位哈希，只用于判断源文件是否变化，不追求密码学强度
+    uint64_t hashBytes(const uint8_t* data, size_t size) {
+        const uint64_t k0 = 0x9E3779B97F4A7C15ull;
+        const uint64_t k1 = 0xBF58476D1CE4E5B9ull;
+        uint64_t h = size * k0;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            memcpy(&word, data + i, 8);
+            h = rotl(h ^ (word * k0), 29) * k1;
+        }
+        if (i < size) {
+            uint64_t word = 0;
+            memcpy(&word, data + i, size - i);
+            h = rotl(h ^ (word * k0), 29) * k1;
+        }
+        h ^= h >> 32;
+        h *= k0;
+        h ^= h >> 29;
+        return h;
+    }
+
+    uint64_t hashFile(const std::string& path) {
+        MappedFile file(path);
+        return hashBytes(file.data(), file.size());
+    }
+
+    int64_t getMtime(const std::string& path) {
+        return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+    }
+}
+
+std::unique_ptr<MeshCache> MeshCache::open(const std::string& sourcePath) {
+    std::string cachePath = getCachePath(sourcePath);
+    std::error_code ec;
+    if (!std::filesystem::exists(cachePath, ec)) return nullptr;
+
+    try {
+        MappedFile file(cachePath);
+        if (file.size() < sizeof(MeshCacheHeader)) return nullptr;
+
+        // 1. 头部与格式检查
+        MeshCacheHeader header;
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+            || header.vertexStride != sizeof(Vertex)
+            || header.pathHash != hashBytes(reinterpret_cast<const uint8_t*>(sourcePath.data()), sourcePath.size())) {
+            return nullptr;
+        }
+        auto fits = [&](uint64_t offset, uint64_t count, uint64_t stride) {
+            return offset % 16 == 0 && offset <= file.size() && count <= (file.size() - offset) / stride;
+        };
+        if (!fits(header.vertexOffset, header.vertexCount, sizeof(Vertex))
+            || !fits(header.indexOffset, header.indexCount, sizeof(uint32_t))
+            || !fits(header.submeshOffset, header.submeshCount, sizeof(Submesh))
+            || !fits(header.lodOffset, header.lodCount, sizeof(LodLevel))) {
+            return nullptr;
+        }
+
+        // 2. 源文件检查：大小必须一致；mtime 不同时再比较内容哈希。源文件不存在时直接使用缓存
+        if (std::filesystem::exists(sourcePath, ec)) {
+            uint64_t sourceSize = std::filesystem::file_size(sourcePath);
+            if (sourceSize != header.sourceSize) {
+                std::cout << "[INFO] mesh cache is stale: " << cachePath << std::endl;
+                return nullptr;
+            }
+            if (getMtime(sourcePath) != header.sourceMtime && hashFile(sourcePath) != header.sourceHash) {
+                std::cout << "[INFO] mesh cache is stale: " << cachePath << std::endl;
+                return nullptr;
+            }
+        }
+
+        // 3. 直接指向映射内存
+        const uint8_t* base = file.data();
+        auto cache = std::unique_ptr<MeshCache>(new MeshCache(std::move(file)));
+        cache->_vertices = { reinterpret_cast<const Vertex*>(base + header.vertexOffset), static_cast<size_t>(header.vertexCount) };
+        cache->_indices = { reinterpret_cast<const uint32_t*>(base + header.indexOffset), static_cast<size_t>(header.indexCount) };
+        cache->_submeshes = { reinterpret_cast<const Submesh*>(base + header.submeshOffset), static_cast<size_t>(header.submeshCount) };
+        cache->_lods = { reinterpret_cast<const LodLevel*>(base + header.lodOffset), static_cast<size_t>(header.lodCount) };
+        cache->_bounds.min = { header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] };
+        cache->_bounds.max = { header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] };
+        return cache;
+    } catch (const std::exception& e) {
+        std::cerr << "[WARNING] failed to read mesh cache " << cachePath << ": " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void MeshCache::write(const std::string& sourcePath, std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+    const MeshBounds& bounds, std::span<const Submesh> submeshes, std::span<const LodLevel> lods) {
+    MeshCacheHeader header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.vertexStride = sizeof(Vertex);
+    header.pathHash = hashBytes(reinterpret_cast<const uint8_t*>(sourcePath.data()), sourcePath.size());
+    header.sourceSize = std::filesystem::file_size(sourcePath);
+    header.sourceMtime = getMtime(sourcePath);
+    header.sourceHash = hashFile(sourcePath);
+
+    header.vertexCount = vertices.size();
+    header.vertexOffset = alignUp(sizeof(MeshCacheHeader));
+    header.indexCount = indices.size();
+    header.indexOffset = alignUp(header.vertexOffset + vertices.size_bytes());
+    header.submeshCount = submeshes.size();
+    header.submeshOffset = alignUp(header.indexOffset + indices.size_bytes());
+    header.lodCount = lods.size();
+    header.lodOffset = alignUp(header.submeshOffset + submeshes.size_bytes());
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = bounds.min[i];
+        header.boundsMax[i] = bounds.max[i];
+    }
+
+    // 先写临时文件，完整写完再替换，避免读到截断的缓存
+    std::string cachePath = getCachePath(sourcePath);
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("failed to create mesh cache: " + tempPath);
+        }
+        const char padding[16] = {};
+        auto writeSection = [&](uint64_t offset, const void* data, size_t size) {
+            out.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(out.tellp())));
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(header.vertexOffset, vertices.data(), vertices.size_bytes());
+        writeSection(header.indexOffset, indices.data(), indices.size_bytes());
+        writeSection(header.submeshOffset, submeshes.data(), submeshes.size_bytes());
+        writeSection(header.lodOffset, lods.data(), lods.size_bytes());
+        if (!out) {
+            throw std::runtime_error("failed to write mesh cache: " + tempPath);
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath);
+}
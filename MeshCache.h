@@ -0,0 +1,48 @@
+#pragma once
+#include "Model.h"
+#include "MappedFile.h"
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+/*
+ * @class MeshCache
+ * @brief 去重后网格的二进制缓存（<源文件>.meshcache）。
+ *
+ * 文件布局：MeshCacheHeader | Vertex[] | uint32_t[] | Submesh[] | LodLevel[]，各段按 16 字节对齐。
+ * 头部记录源文件的大小、修改时间与内容哈希，以及路径哈希；加载时整个文件被内存映射，
+ * 顶点与索引直接指向映射内存，不做任何解析或拷贝。
+ *
+ * 有效性：版本、顶点布局与路径一致，源文件大小相同，且修改时间相同或内容哈希相同
+ * （例如重新检出后 mtime 变了但内容未变）。
+ */
+class MeshCache {
+public:
+    static constexpr uint32_t kVersion = 3;   // 2: 写入前经过 MeshOptimizer 重排；3: 附带 LOD 链
+
+    // 缓存缺失、过期或损坏时返回 nullptr
+    static std::unique_ptr<MeshCache> open(const std::string& sourcePath);
+
+    // 写入缓存；先写临时文件再改名，避免中途失败留下半个文件。失败时抛出异常
+    static void write(const std::string& sourcePath, std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+        const MeshBounds& bounds, std::span<const Submesh> submeshes, std::span<const LodLevel> lods);
+
+    static std::string getCachePath(const std::string& sourcePath) { return sourcePath + ".meshcache"; }
+
+    std::span<const Vertex> getVertices() const { return _vertices; }
+    std::span<const uint32_t> getIndices() const { return _indices; }
+    std::span<const Submesh> getSubmeshes() const { return _submeshes; }
+    std::span<const LodLevel> getLods() const { return _lods; }
+    const MeshBounds& getBounds() const { return _bounds; }
+
+private:
+    explicit MeshCache(MappedFile&& file) : _file(std::move(file)) {}
+
+    MappedFile _file;
+    std::span<const Vertex> _vertices;
+    std::span<const uint32_t> _indices;
+    std::span<const Submesh> _submeshes;
+    std::span<const LodLevel> _lods;
+    MeshBounds _bounds{};
+};
@@ -0,0 +1,340 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+    constexpr uint32_t kInvalid = std::numeric_limits<uint32_t>::max();
+
+    // Forsyth 算法参数（沿用原文推荐值）
+    constexpr uint32_t kForsythCacheSize = 32;
+    constexpr float kCacheDecayPower = 1.5f;
+    constexpr float kLastTriScore = 0.75f;
+    constexpr float kValenceBoostScale = 2.0f;
+    constexpr float kValenceBoostPower = 0.5f;
+    constexpr uint32_t kValenceTableSize = 64;
+
+    struct ScoreTables {
+        float cache[kForsythCacheSize];
+        float valence[kValenceTableSize];
+
+        ScoreTables() {
+            for (uint32_t i = 0; i < kForsythCacheSize; ++i) {
+                // 刚用过的三个顶点得分固定，避免总是沿同一条边扩展出细长的三角形带
+                cache[i] = i < 3 ? kLastTriScore
+                    : std::pow(1.0f - float(i - 3) / float(kForsythCacheSize - 3), kCacheDecayPower);
+            }
+            valence[0] = 0.0f;
+            for (uint32_t i = 1; i < kValenceTableSize; ++i) {
+                valence[i] = kValenceBoostScale * std::pow(float(i), -kValenceBoostPower);
+            }
+        }
+    };
+
+    float vertexScore(const ScoreTables& tables, int cachePosition, uint32_t remaining) {
+        if (remaining == 0) return -1.0f;
+        float score = cachePosition < 0 ? 0.0f : tables.cache[cachePosition];
+        score += remaining < kValenceTableSize ? tables.valence[remaining]
+            : kValenceBoostScale * std::pow(float(remaining), -kValenceBoostPower);
+        return score;
+    }
+
+    // 对一段索引做 Forsyth 重排；localId 是长度为全局顶点数、全部为 kInvalid 的暂存数组，返回前恢复原状
+    void forsythRange(std::span<uint32_t> indices, std::vector<uint32_t>& localId) {
+        static const ScoreTables tables;
+        const size_t triCount = indices.size() / 3;
+        if (triCount < 2) return;
+
+        // 1. 把子网格用到的顶点压缩成局部编号，后续数组只与子网格大小相关
+        std::vector<uint32_t> globals;
+        std::vector<uint32_t> triVertices(triCount * 3);
+        for (size_t i = 0; i < triCount * 3; ++i) {
+            uint32_t v = indices[i];
+            if (localId[v] == kInvalid) {
+                localId[v] = static_cast<uint32_t>(globals.size());
+                globals.push_back(v);
+            }
+            triVertices[i] = localId[v];
+        }
+        for (uint32_t v : globals) localId[v] = kInvalid;
+        const size_t vertexCount = globals.size();
+
+        // 2. 顶点 -> 三角形邻接表
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (uint32_t v : triVertices) remaining[v]++;
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + remaining[v];
+        std::vector<uint32_t> adjacency(triCount * 3);
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t t = 0; t < triCount; ++t) {
+                for (int k = 0; k < 3; ++k) adjacency[fill[triVertices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+
+        // 3. 初始分数
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) vScore[v] = vertexScore(tables, -1, remaining[v]);
+        std::vector<float> tScore(triCount);
+        for (size_t t = 0; t < triCount; ++t) {
+            tScore[t] = vScore[triVertices[t * 3]] + vScore[triVertices[t * 3 + 1]] + vScore[triVertices[t * 3 + 2]];
+        }
+        std::vector<uint8_t> emitted(triCount, 0);
+
+        uint32_t cache[kForsythCacheSize + 3];
+        uint32_t cacheCount = 0;
+        uint32_t best = static_cast<uint32_t>(std::max_element(tScore.begin(), tScore.end()) - tScore.begin());
+        size_t deadEndCursor = 0;
+
+        std::vector<uint32_t> output;
+        output.reserve(triCount * 3);
+        for (size_t emittedCount = 0; emittedCount < triCount; ++emittedCount) {
+            // 缓存里没有候选三角形时，按原顺序取下一个未输出的
+            if (best == kInvalid) {
+                while (emitted[deadEndCursor]) deadEndCursor++;
+                best = static_cast<uint32_t>(deadEndCursor);
+            }
+
+            emitted[best] = 1;
+            const uint32_t* tri = &triVertices[best * 3];
+            for (int k = 0; k < 3; ++k) {
+                uint32_t v = tri[k];
+                output.push_back(globals[v]);
+                // 从邻接表中移除该三角形
+                uint32_t* list = &adjacency[offsets[v]];
+                uint32_t* last = list + remaining[v] - 1;
+                *std::find(list, last + 1, best) = *last;
+                remaining[v]--;
+            }
+
+            // 新缓存：本三角形的三个顶点在前，其余按原顺序后移
+            uint32_t newCache[kForsythCacheSize + 3];
+            uint32_t newCount = 0;
+            for (int k = 0; k < 3; ++k) newCache[newCount++] = tri[k];
+            for (uint32_t i = 0; i < cacheCount; ++i) {
+                uint32_t v = cache[i];
+                if (v != tri[0] && v != tri[1] && v != tri[2]) newCache[newCount++] = v;
+            }
+
+            // 更新缓存内顶点及其三角形的分数，同时找出下一个最优三角形
+            best = kInvalid;
+            float bestScore = -std::numeric_limits<float>::max();
+            for (uint32_t i = 0; i < newCount; ++i) {
+                uint32_t v = newCache[i];
+                cachePosition[v] = i < kForsythCacheSize ? static_cast<int>(i) : -1;
+                float score = vertexScore(tables, cachePosition[v], remaining[v]);
+                float delta = score - vScore[v];
+                vScore[v] = score;
+                for (uint32_t j = 0; j < remaining[v]; ++j) {
+                    uint32_t t = adjacency[offsets[v] + j];
+                    tScore[t] += delta;
+                    if (tScore[t] > bestScore) {
+                        bestScore = tScore[t];
+                        best = t;
+                    }
+                }
+            }
+            cacheCount = std::min(newCount, kForsythCacheSize);
+            std::copy(newCache, newCache + cacheCount, cache);
+        }
+        std::copy(output.begin(), output.end(), indices.begin());
+    }
+
+    /*
+     * FIFO 后变换缓存模拟。timestamps[v] 为顶点进入缓存时的计数器值，计数器与其差值不超过 cacheSize
+     * 即仍在缓存中；reset 只需把计数器推过一个缓存长度，不用清空数组。
+     * timestamps 在多次模拟间复用，调用方用完后通过 clear 把用到的顶点清零
+     */
+    struct FifoCache {
+        std::vector<uint32_t>& timestamps;
+        uint32_t cacheSize;
+        uint32_t counter;
+
+        FifoCache(std::vector<uint32_t>& ts, uint32_t size) : timestamps(ts), cacheSize(size), counter(size + 1) {}
+
+        void reset() { counter += cacheSize + 1; }
+
+        uint32_t addTriangle(const uint32_t* tri) {
+            uint32_t misses = 0;
+            for (int k = 0; k < 3; ++k) {
+                if (counter - timestamps[tri[k]] > cacheSize) {
+                    timestamps[tri[k]] = counter++;
+                    misses++;
+                }
+            }
+            return misses;
+        }
+
+        void clear(std::span<const uint32_t> indices) {
+            for (uint32_t v : indices) timestamps[v] = 0;
+        }
+    };
+
+    size_t countCacheMisses(std::span<const uint32_t> indices, std::vector<uint32_t>& timestamps, uint32_t cacheSize) {
+        FifoCache cache(timestamps, cacheSize);
+        size_t misses = 0;
+        for (size_t t = 0; t < indices.size() / 3; ++t) {
+            misses += cache.addTriangle(&indices[t * 3]);
+        }
+        cache.clear(indices);
+        return misses;
+    }
+
+    void overdrawRange(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold, std::vector<uint32_t>& timestamps) {
+        const size_t triCount = indices.size() / 3;
+        if (triCount < 2) return;
+
+        // 1. 硬边界：三个顶点全部未命中的三角形，在这里断开不会损失缓存命中
+        std::vector<uint32_t> hardStarts;
+        size_t missesBefore = 0;
+        {
+            FifoCache cache(timestamps, 16);
+            for (size_t t = 0; t < triCount; ++t) {
+                uint32_t misses = cache.addTriangle(&indices[t * 3]);
+                if (t == 0 || misses == 3) hardStarts.push_back(static_cast<uint32_t>(t));
+                missesBefore += misses;
+            }
+            cache.clear(indices);
+        }
+        hardStarts.push_back(static_cast<uint32_t>(triCount));
+
+        // 软边界：顶点缓存优化后的硬边界很少，再把每个硬簇切成小簇。从簇头开始用空缓存累计，
+        // 一旦累计 ACMR 不超过 threshold × 该硬簇的 ACMR 就断开，切分后缓存效率的损失因此有上界
+        std::vector<uint32_t> clusterStarts;
+        {
+            FifoCache cache(timestamps, 16);
+            for (size_t h = 0; h + 1 < hardStarts.size(); ++h) {
+                const uint32_t start = hardStarts[h];
+                const uint32_t end = hardStarts[h + 1];
+
+                cache.reset();
+                size_t clusterMisses = 0;
+                for (uint32_t t = start; t < end; ++t) clusterMisses += cache.addTriangle(&indices[t * 3]);
+                const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+                clusterStarts.push_back(start);
+                cache.reset();
+                size_t runningMisses = 0, runningTriangles = 0;
+                for (uint32_t t = start; t + 1 < end; ++t) {
+                    runningMisses += cache.addTriangle(&indices[t * 3]);
+                    runningTriangles++;
+                    if (static_cast<float>(runningMisses) <= clusterThreshold * static_cast<float>(runningTriangles)) {
+                        clusterStarts.push_back(t + 1);
+                        cache.reset();
+                        runningMisses = 0;
+                        runningTriangles = 0;
+                    }
+                }
+            }
+            cache.clear(indices);
+        }
+        if (clusterStarts.size() < 2) return;
+        clusterStarts.push_back(static_cast<uint32_t>(triCount));
+
+        // 2. 面积加权的簇中心与法线
+        const size_t clusterCount = clusterStarts.size() - 1;
+        std::vector<glm::vec3> centroids(clusterCount), normals(clusterCount);
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (size_t c = 0; c < clusterCount; ++c) {
+            glm::vec3 centroid(0.0f), normal(0.0f);
+            float area = 0.0f;
+            for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+                const glm::vec3& p0 = vertices[indices[t * 3 + 0]].position;
+                const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+                const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+                glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                float a = glm::length(n);
+                centroid += (p0 + p1 + p2) * (a / 3.0f);
+                normal += n;
+                area += a;
+            }
+            meshCentroid += centroid;
+            meshArea += area;
+            centroids[c] = area > 0.0f ? centroid / area : vertices[indices[clusterStarts[c] * 3]].position;
+            normals[c] = normal;
+        }
+        if (meshArea > 0.0f) meshCentroid = meshCentroid / meshArea;
+
+        // 3. 沿簇法线离网格中心越远的簇越靠外，先画
+        std::vector<float> keys(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c) {
+            float length = glm::length(normals[c]);
+            keys[c] = length > 0.0f ? glm::dot(centroids[c] - meshCentroid, normals[c] / length) : 0.0f;
+        }
+        std::vector<uint32_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+        std::vector<uint32_t> sorted;
+        sorted.reserve(indices.size());
+        for (uint32_t c : order) {
+            sorted.insert(sorted.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+        }
+
+        // 4. 缓存效率下降超过阈值时保留原顺序
+        const size_t missesAfter = countCacheMisses(sorted, timestamps, 16);
+        if (static_cast<float>(missesAfter) <= static_cast<float>(missesBefore) * threshold) {
+            std::copy(sorted.begin(), sorted.end(), indices.begin());
+        }
+    }
+}
+
+MeshOptimizer::Report MeshOptimizer::optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+    std::span<const Submesh> submeshes, float overdrawThreshold) {
+    Report report{};
+    report.before = analyzeVertexCache(indices, vertices.size());
+
+    std::vector<uint32_t> scratch(vertices.size(), kInvalid);
+    std::vector<uint32_t> timestamps(vertices.size(), 0);
+    auto forEachSubmesh = [&](auto&& fn) {
+        if (submeshes.empty()) {
+            fn(std::span<uint32_t>(indices));
+            return;
+        }
+        for (const Submesh& submesh : submeshes) {
+            fn(std::span<uint32_t>(indices).subspan(submesh.firstIndex, submesh.indexCount));
+        }
+    };
+    forEachSubmesh([&](std::span<uint32_t> range) { forsythRange(range, scratch); });
+    forEachSubmesh([&](std::span<uint32_t> range) { overdrawRange(range, vertices, overdrawThreshold, timestamps); });
+    optimizeVertexFetch(vertices, indices);
+
+    report.after = analyzeVertexCache(indices, vertices.size());
+    return report;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount) {
+    std::vector<uint32_t> scratch(vertexCount, kInvalid);
+    forsythRange(indices, scratch);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold) {
+    std::vector<uint32_t> timestamps(vertices.size(), 0);
+    overdrawRange(indices, vertices, threshold, timestamps);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices) {
+    std::vector<uint32_t> remap(vertices.size(), kInvalid);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+    for (uint32_t& index : indices) {
+        if (remap[index] == kInvalid) {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    // 未被引用的顶点直接丢弃
+    vertices = std::move(reordered);
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+    if (indices.empty() || vertexCount == 0) return { 0.0f, 0.0f };
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    size_t misses = countCacheMisses(indices, timestamps, cacheSize);
+    return { static_cast<float>(misses) / static_cast<float>(indices.size() / 3),
+             static_cast<float>(misses) / static_cast<float>(vertexCount) };
+}
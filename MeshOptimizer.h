@@ -0,0 +1,41 @@
+#pragma once
+#include "Model.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ * @class MeshOptimizer
+ * @brief 加载后的网格优化：顶点缓存重排、减少 overdraw 的簇排序、顶点读取重排。
+ *
+ * 1. optimizeVertexCache：Forsyth 线性时间算法，按 LRU 缓存位置与剩余价数给顶点打分，贪心输出三角形
+ * 2. optimizeOverdraw：以 FIFO 缓存完全未命中的位置切分三角形簇，按簇中心沿簇法线到网格中心的距离
+ *    从外到内排序（外侧面先画，更容易挡住后面的像素）；ACMR 变差超过 threshold 倍时放弃排序
+ * 3. optimizeVertexFetch：按索引中首次引用的顺序重排顶点，顶点读取变为近似顺序访问
+ *
+ * 三角形只在各 Submesh 内部重排，子网格的范围保持不变。
+ */
+class MeshOptimizer {
+public:
+    // ACMR：每个三角形平均的缓存未命中数（理想值约 0.5）；ATVR：未命中数 / 顶点数（理想值 1.0）
+    struct CacheStats {
+        float acmr;
+        float atvr;
+    };
+
+    struct Report {
+        CacheStats before;
+        CacheStats after;
+    };
+
+    // 依次执行三个步骤并返回前后的缓存统计；vertices 与 indices 会被原地改写
+    static Report optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::span<const Submesh> submeshes,
+        float overdrawThreshold = 1.05f);
+
+    static void optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount);
+    static void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold = 1.05f);
+    static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices);
+
+    // 用 FIFO 缓存模拟后处理顶点缓存（cacheSize 取常见硬件的 16）
+    static CacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = 16);
+};
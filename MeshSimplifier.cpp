@@ -0,0 +1,308 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+namespace {
+    enum class VertexKind : uint8_t {
+        Manifold,   // 内部顶点，可以折叠到任意相邻顶点
+        Border,     // 恰好两条开放边，只能沿开放边折叠
+        Locked,     // 接缝或非流形顶点，不移动
+    };
+
+    // 对称矩阵 A、向量 b、常数 c 表示的二次误差 p^T A p + 2 b^T p + c，w 为累计权重
+    struct Quadric {
+        float a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+        float b0 = 0, b1 = 0, b2 = 0;
+        float c = 0;
+        float w = 0;
+
+        void addPlane(const glm::vec3& n, float d, float weight) {
+            a00 += weight * n.x * n.x; a11 += weight * n.y * n.y; a22 += weight * n.z * n.z;
+            a01 += weight * n.x * n.y; a02 += weight * n.x * n.z; a12 += weight * n.y * n.z;
+            b0 += weight * n.x * d; b1 += weight * n.y * d; b2 += weight * n.z * d;
+            c += weight * d * d;
+            w += weight;
+        }
+
+        void add(const Quadric& q) {
+            a00 += q.a00; a11 += q.a11; a22 += q.a22;
+            a01 += q.a01; a02 += q.a02; a12 += q.a12;
+            b0 += q.b0; b1 += q.b1; b2 += q.b2;
+            c += q.c;
+            w += q.w;
+        }
+
+        // 按权重归一化后即为到各平面的加权平均平方距离
+        float evaluate(const glm::vec3& p) const {
+            float e = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+                    + 2.0f * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+                    + 2.0f * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+            return w > 0.0f ? std::max(e / w, 0.0f) : 0.0f;
+        }
+    };
+
+    // 开放边相对表面的权重，越大轮廓越不容易收缩
+    constexpr float kBorderWeight = 10.0f;
+
+    struct Collapse {
+        uint32_t v0;
+        uint32_t v1;
+        float cost;
+    };
+
+    // 位置相同的顶点映射到同一个代表顶点（下标最小者）
+    std::vector<uint32_t> buildPositionRemap(std::span<const Vertex> vertices, std::vector<uint8_t>& isSeam) {
+        std::vector<uint32_t> order(vertices.size());
+        std::iota(order.begin(), order.end(), 0u);
+        auto key = [&](uint32_t v) {
+            const glm::vec3& p = vertices[v].position;
+            return std::make_tuple(p.x, p.y, p.z);
+        };
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return key(a) < key(b) || (key(a) == key(b) && a < b);
+        });
+
+        std::vector<uint32_t> remap(vertices.size());
+        isSeam.assign(vertices.size(), 0);
+        for (size_t i = 0; i < order.size();) {
+            size_t j = i + 1;
+            while (j < order.size() && key(order[j]) == key(order[i])) ++j;
+            for (size_t k = i; k < j; ++k) {
+                remap[order[k]] = order[i];
+                isSeam[order[k]] = j - i > 1 ? 1 : 0;
+            }
+            i = j;
+        }
+        return remap;
+    }
+
+    uint64_t edgeKey(uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+    size_t targetIndexCount, float targetError, float* outError) {
+    const size_t vertexCount = vertices.size();
+    std::vector<uint8_t> isSeam;
+    const std::vector<uint32_t> remap = buildPositionRemap(vertices, isSeam);
+    auto position = [&](uint32_t v) -> const glm::vec3& { return vertices[v].position; };
+
+    std::vector<uint32_t> result(indices.begin(), indices.end());
+    const size_t targetTriangles = targetIndexCount / 3;
+    const float errorLimit = targetError * targetError;
+    float maxCost = 0.0f;
+
+    // 1. 每个位置的二次误差：相邻三角形平面（面积加权）
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i + 2 < result.size(); i += 3) {
+        const glm::vec3& p0 = position(result[i]);
+        glm::vec3 n = glm::cross(position(result[i + 1]) - p0, position(result[i + 2]) - p0);
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n = n / length;
+        float d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; ++k) {
+            quadrics[remap[result[i + k]]].addPlane(n, d, length * 0.5f);
+        }
+    }
+
+    // 开放边：加入过该边且垂直于所在三角形的约束平面，防止轮廓向内收缩
+    std::vector<uint64_t> edges;
+    for (size_t i = 0; i < result.size(); i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            edges.push_back(edgeKey(remap[result[i + k]], remap[result[i + (k + 1) % 3]]));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t i = 0; i + 2 < result.size(); i += 3) {
+        const glm::vec3& p0 = position(result[i]);
+        glm::vec3 normal = glm::cross(position(result[i + 1]) - p0, position(result[i + 2]) - p0);
+        for (int k = 0; k < 3; ++k) {
+            uint32_t a = remap[result[i + k]], b = remap[result[i + (k + 1) % 3]];
+            if (std::binary_search(edges.begin(), edges.end(), edgeKey(b, a))) continue;
+            glm::vec3 edgeDir = position(b) - position(a);
+            glm::vec3 plane = glm::cross(edgeDir, normal);
+            float planeLength = glm::length(plane);
+            if (planeLength <= 0.0f) continue;
+            plane = plane / planeLength;
+            float d = -glm::dot(plane, position(a));
+            float weight = glm::dot(edgeDir, edgeDir) * kBorderWeight;
+            quadrics[a].addPlane(plane, d, weight);
+            quadrics[b].addPlane(plane, d, weight);
+        }
+    }
+
+    std::vector<VertexKind> kinds(vertexCount);
+    std::vector<uint32_t> openEdgeCount(vertexCount);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> collapseTarget(vertexCount);
+    std::vector<uint8_t> locked(vertexCount);
+
+    while (result.size() / 3 > targetTriangles) {
+        const size_t triangleCount = result.size() / 3;
+
+        // 2. 有向边集合（按位置），反向边不存在的即为开放边
+        edges.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                edges.push_back(edgeKey(remap[result[i + k]], remap[result[i + (k + 1) % 3]]));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        auto isOpen = [&](uint32_t a, uint32_t b) {
+            return !std::binary_search(edges.begin(), edges.end(), edgeKey(remap[b], remap[a]));
+        };
+
+        std::fill(openEdgeCount.begin(), openEdgeCount.end(), 0u);
+        for (uint64_t edge : edges) {
+            uint32_t a = static_cast<uint32_t>(edge >> 32), b = static_cast<uint32_t>(edge);
+            if (!std::binary_search(edges.begin(), edges.end(), edgeKey(b, a))) {
+                openEdgeCount[a]++;
+                openEdgeCount[b]++;
+            }
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            if (isSeam[v]) {
+                kinds[v] = VertexKind::Locked;
+            } else {
+                uint32_t open = openEdgeCount[remap[v]];
+                kinds[v] = open == 0 ? VertexKind::Manifold : (open == 2 ? VertexKind::Border : VertexKind::Locked);
+            }
+        }
+
+        // 3. 顶点 -> 三角形邻接（CSR）
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+        for (uint32_t v : result) adjacencyOffsets[v + 1]++;
+        for (size_t v = 0; v < vertexCount; ++v) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); ++i) {
+                adjacency[cursor[result[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // 4. 候选折叠：每条边取两个方向中合法且代价较小的一个
+        candidates.clear();
+        auto canCollapse = [&](uint32_t v0, uint32_t v1) {
+            if (remap[v0] == remap[v1]) return false;
+            if (kinds[v0] == VertexKind::Manifold) return true;
+            return kinds[v0] == VertexKind::Border && (isOpen(v0, v1) || isOpen(v1, v0));
+        };
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = result[i + k], b = result[i + (k + 1) % 3];
+                Collapse best{ 0, 0, -1.0f };
+                if (canCollapse(a, b)) best = { a, b, quadrics[remap[a]].evaluate(position(b)) };
+                if (canCollapse(b, a)) {
+                    float cost = quadrics[remap[b]].evaluate(position(a));
+                    if (best.cost < 0.0f || cost < best.cost) best = { b, a, cost };
+                }
+                if (best.cost >= 0.0f && best.cost <= errorLimit) candidates.push_back(best);
+            }
+        }
+        if (candidates.empty()) break;
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) {
+            return a.cost < b.cost;
+        });
+
+        // 5. 按代价贪心执行；一次折叠锁住 v0 的一环邻域，保证同一轮的翻转检查仍然有效
+        std::iota(collapseTarget.begin(), collapseTarget.end(), 0u);
+        std::fill(locked.begin(), locked.end(), 0);
+        size_t removed = 0;
+        for (const Collapse& collapse : candidates) {
+            if (triangleCount - removed <= targetTriangles) break;
+            if (locked[collapse.v0] || locked[collapse.v1]) continue;
+
+            const glm::vec3& target = position(collapse.v1);
+            bool flipped = false;
+            size_t degenerate = 0;
+            for (uint32_t a = adjacencyOffsets[collapse.v0]; a < adjacencyOffsets[collapse.v0 + 1]; ++a) {
+                const uint32_t* tri = &result[adjacency[a] * 3];
+                if (remap[tri[0]] == remap[collapse.v1] || remap[tri[1]] == remap[collapse.v1] || remap[tri[2]] == remap[collapse.v1]) {
+                    degenerate++;
+                    continue;
+                }
+                glm::vec3 p[3] = { position(tri[0]), position(tri[1]), position(tri[2]) };
+                glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                for (int k = 0; k < 3; ++k) {
+                    if (tri[k] == collapse.v0) p[k] = target;
+                }
+                glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+                if (glm::dot(before, after) <= 0.0f) {
+                    flipped = true;
+                    break;
+                }
+            }
+            if (flipped) continue;
+
+            collapseTarget[collapse.v0] = collapse.v1;
+            locked[collapse.v0] = locked[collapse.v1] = 1;
+            for (uint32_t a = adjacencyOffsets[collapse.v0]; a < adjacencyOffsets[collapse.v0 + 1]; ++a) {
+                const uint32_t* tri = &result[adjacency[a] * 3];
+                locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+            }
+            quadrics[remap[collapse.v1]].add(quadrics[remap[collapse.v0]]);
+            maxCost = std::max(maxCost, collapse.cost);
+            removed += degenerate;
+        }
+        if (removed == 0) break;
+
+        // 6. 应用折叠并移除（按位置）退化的三角形
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            uint32_t a = collapseTarget[result[i]], b = collapseTarget[result[i + 1]], c = collapseTarget[result[i + 2]];
+            if (remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c]) continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (outError) *outError = std::sqrt(maxCost);
+    return result;
+}
+
+std::vector<LodLevel> MeshSimplifier::generateLods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices,
+    const MeshBounds& bounds) {
+    return generateLods(vertices, indices, bounds, LodOptions{});
+}
+
+std::vector<LodLevel> MeshSimplifier::generateLods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices,
+    const MeshBounds& bounds, const LodOptions& options) {
+    std::vector<LodLevel> levels;
+    levels.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.0f });
+
+    const float radius = 0.5f * glm::length(bounds.max - bounds.min);
+    const float budget = options.maxError * radius;
+    std::vector<uint32_t> previous(indices.begin(), indices.end());
+    float accumulated = 0.0f;
+
+    // 每一级在上一级的结果上继续简化，误差累加，保证相对原始网格的误差不超过预算
+    for (uint32_t level = 1; level < options.maxLevels && accumulated < budget; ++level) {
+        size_t target = static_cast<size_t>(previous.size() / 3 * options.reduction) * 3;
+        float stepError = 0.0f;
+        std::vector<uint32_t> next = simplify(vertices, previous, target, budget - accumulated, &stepError);
+        if (next.empty() || next.size() > previous.size() * options.minReduction) break;
+
+        MeshOptimizer::optimizeVertexCache(next, vertices.size());
+        accumulated += stepError;
+        levels.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(next.size()), accumulated });
+        indices.insert(indices.end(), next.begin(), next.end());
+        previous = std::move(next);
+    }
+
+    std::cout << "[INFO] generated " << levels.size() << " LOD levels, triangles:";
+    for (const LodLevel& level : levels) {
+        std::cout << " " << level.indexCount / 3;
+    }
+    std::cout << std::endl;
+    return levels;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Model.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ * @class MeshSimplifier
+ * @brief 基于二次误差度量（QEM）的边折叠简化，只改写索引，不新增顶点。
+ *
+ * 每个顶点累积相邻三角形平面的二次误差（按面积加权），开放边额外加一个垂直于表面的约束平面以保持轮廓。
+ * 每一轮为所有边计算“把 v0 折叠到 v1”的代价（v0 的二次误差在 v1 位置处的值，即平方距离），
+ * 按代价从小到大贪心执行互不相邻的折叠，直到三角形数达到目标或最小代价超过误差上限。
+ *
+ * 约束：
+ * - 与其他顶点位置相同的顶点（法线/UV 接缝）保持不动，但可以作为折叠目标；
+ * - 边界顶点只能沿开放边折叠到另一个边界顶点；
+ * - 会翻转相邻三角形朝向的折叠被拒绝。
+ *
+ * 由于结果只引用原有顶点，各级 LOD 可以和 LOD0 共用同一个顶点缓冲区，索引依次追加在同一个索引缓冲区中。
+ */
+class MeshSimplifier {
+public:
+    struct LodOptions {
+        uint32_t maxLevels = 5;         // 含 LOD0
+        float reduction = 0.5f;         // 每一级相对上一级的目标三角形比例
+        float maxError = 0.05f;         // 累计误差上限，相对包围球半径
+        float minReduction = 0.9f;      // 一级减少不到 10% 时停止生成
+    };
+
+    /*
+     * @brief 简化 indices，返回新的索引列表。
+     * @param targetError 允许的最大误差（物体空间距离）
+     * @param outError 实际产生的最大误差（物体空间距离），可为空
+     */
+    static std::vector<uint32_t> simplify(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+        size_t targetIndexCount, float targetError, float* outError = nullptr);
+
+    /*
+     * @brief 以 indices 的全部内容为 LOD0 生成 LOD 链，各级索引追加到 indices 末尾。
+     * 每一级在上一级的基础上简化，LodLevel::error 为相对原始网格的累计误差（物体空间距离）。
+     * 每一级都会重新做顶点缓存重排。
+     */
+    static std::vector<LodLevel> generateLods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices,
+        const MeshBounds& bounds, const LodOptions& options);
+    static std::vector<LodLevel> generateLods(std::span<const Vertex> vertices, std::vector<uint32_t>& indices,
+        const MeshBounds& bounds);
+};
@@ -0,0 +1,120 @@
+#include "MeshletBuilder.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t kUnused = std::numeric_limits<uint32_t>::max();
+
+    void computeBounds(Meshlet& meshlet, const MeshletMesh& mesh, std::span<const Vertex> vertices) {
+        // 包围球：以 AABB 中心为球心
+        glm::vec3 minPos(std::numeric_limits<float>::max());
+        glm::vec3 maxPos(std::numeric_limits<float>::lowest());
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            const glm::vec3& p = vertices[mesh.vertices[meshlet.vertexOffset + i]].position;
+            minPos = glm::min(minPos, p);
+            maxPos = glm::max(maxPos, p);
+        }
+        meshlet.center = (minPos + maxPos) * 0.5f;
+        meshlet.radius = 0.0f;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            meshlet.radius = std::max(meshlet.radius, glm::distance(meshlet.center, vertices[mesh.vertices[meshlet.vertexOffset + i]].position));
+        }
+
+        // 法线锥：轴为单位法线之和的方向，半角由与轴夹角最大的法线决定
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangleCount);
+        glm::vec3 axis(0.0f);
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+            uint32_t packed = mesh.triangles[meshlet.triangleOffset + t];
+            const glm::vec3& p0 = vertices[mesh.vertices[meshlet.vertexOffset + (packed & 0xFF)]].position;
+            const glm::vec3& p1 = vertices[mesh.vertices[meshlet.vertexOffset + ((packed >> 8) & 0xFF)]].position;
+            const glm::vec3& p2 = vertices[mesh.vertices[meshlet.vertexOffset + ((packed >> 16) & 0xFF)]].position;
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(n);
+            if (area <= 0.0f) continue;   // 退化三角形不可见，不影响锥
+            normals.push_back(n / area);
+            axis += n / area;
+        }
+
+        float axisLength = glm::length(axis);
+        meshlet.coneAxis = axisLength > 0.0f ? axis / axisLength : glm::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.coneCutoff = 1.0f;
+        if (axisLength <= 0.0f || normals.empty()) return;
+
+        float minDot = 1.0f;
+        for (const glm::vec3& n : normals) {
+            minDot = std::min(minDot, glm::dot(n, meshlet.coneAxis));
+        }
+        // 锥半角超过约 84° 时剔除几乎不会成功，直接关闭；否则阈值为 sin(半角)
+        meshlet.coneCutoff = minDot <= 0.1f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+MeshletMesh MeshletBuilder::build(std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::span<const Submesh> submeshes,
+    uint32_t maxVertices, uint32_t maxTriangles) {
+    if (maxVertices < 3 || maxVertices > 256 || maxTriangles == 0) {
+        throw std::runtime_error("meshlet limits must allow at least one triangle and at most 256 vertices");
+    }
+
+    MeshletMesh mesh;
+    mesh.meshlets.reserve(indices.size() / 3 / maxTriangles + submeshes.size() + 1);
+    mesh.vertices.reserve(indices.size() / 2);
+    mesh.triangles.reserve(indices.size() / 3);
+
+    // localIndex[v] 为全局顶点在当前簇中的局部下标，簇结束时只复位用到的顶点
+    std::vector<uint32_t> localIndex(vertices.size(), kUnused);
+    Meshlet current{};
+
+    auto finish = [&]() {
+        if (current.triangleCount == 0) return;
+        computeBounds(current, mesh, vertices);
+        for (uint32_t i = 0; i < current.vertexCount; ++i) {
+            localIndex[mesh.vertices[current.vertexOffset + i]] = kUnused;
+        }
+        mesh.meshlets.push_back(current);
+        current = {};
+        current.vertexOffset = static_cast<uint32_t>(mesh.vertices.size());
+        current.triangleOffset = static_cast<uint32_t>(mesh.triangles.size());
+    };
+
+    std::vector<Submesh> ranges(submeshes.begin(), submeshes.end());
+    if (ranges.empty()) {
+        ranges.push_back({ 0, static_cast<uint32_t>(indices.size()) });
+    }
+    for (const Submesh& range : ranges) {
+        for (uint32_t i = range.firstIndex; i + 2 < range.firstIndex + range.indexCount; i += 3) {
+            const uint32_t tri[3] = { indices[i], indices[i + 1], indices[i + 2] };
+            uint32_t newVertices = 0;
+            for (int k = 0; k < 3; ++k) {
+                bool seen = localIndex[tri[k]] != kUnused || (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+                newVertices += seen ? 0 : 1;
+            }
+            if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles) {
+                finish();
+            }
+
+            uint32_t packed = 0;
+            for (int k = 0; k < 3; ++k) {
+                if (localIndex[tri[k]] == kUnused) {
+                    localIndex[tri[k]] = current.vertexCount++;
+                    mesh.vertices.push_back(tri[k]);
+                }
+                packed |= localIndex[tri[k]] << (8 * k);
+            }
+            mesh.triangles.push_back(packed);
+            current.triangleCount++;
+        }
+        finish();   // 簇不跨越子网格
+    }
+
+    mesh.maxTriangleCount = static_cast<uint32_t>(mesh.triangles.size());
+    if (!mesh.meshlets.empty()) {
+        std::cout << "[INFO] built " << mesh.meshlets.size() << " meshlets, avg "
+                  << static_cast<float>(mesh.vertices.size()) / mesh.meshlets.size() << " vertices / "
+                  << static_cast<float>(mesh.triangles.size()) / mesh.meshlets.size() << " triangles" << std::endl;
+    }
+    return mesh;
+}
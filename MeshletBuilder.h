@@ -0,0 +1,44 @@
+#pragma once
+#include "Model.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 与 res/meshlet_common.hlsli 中的 Meshlet 一致（48 字节，可直接上传为结构化缓冲区）
+struct Meshlet {
+    glm::vec3 center;           // 包围球
+    float radius;
+    glm::vec3 coneAxis;         // 法线锥：所有三角形法线都在轴附近
+    float coneCutoff;           // 背面剔除阈值，1 表示锥太宽、不做剔除
+    uint32_t vertexOffset;      // 在 MeshletMesh::vertices 中的起始位置
+    uint32_t triangleOffset;    // 在 MeshletMesh::triangles 中的起始位置
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+
+struct MeshletMesh {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;     // 局部顶点 -> 全局顶点下标
+    std::vector<uint32_t> triangles;    // 每个三角形一个 uint：三个 8 位局部下标（x | y << 8 | z << 16）
+    uint32_t maxTriangleCount = 0;      // 展开后的三角形总数，用于分配剔除输出的索引缓冲区
+};
+
+/*
+ * @class MeshletBuilder
+ * @brief 把 Model 的顶点/索引切分成小簇（meshlet），并计算每个簇的包围球与法线锥。
+ *
+ * 按索引顺序贪心装填：当前簇的顶点数或三角形数将要超出上限时开始新簇。输入最好先经过
+ * MeshOptimizer 的顶点缓存重排，这样相邻三角形共享顶点，簇既满又紧凑。簇不跨越子网格。
+ *
+ * 法线锥的剔除条件（相机在物体空间）：
+ *   dot(center - camera, coneAxis) >= coneCutoff * length(center - camera) + radius
+ * 约定与渲染管线相同：物体空间中逆时针为正面。
+ */
+class MeshletBuilder {
+public:
+    static constexpr uint32_t kMaxVertices = 64;
+    static constexpr uint32_t kMaxTriangles = 124;
+
+    static MeshletMesh build(std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::span<const Submesh> submeshes,
+        uint32_t maxVertices = kMaxVertices, uint32_t maxTriangles = kMaxTriangles);
+};
@@ -0,0 +1,250 @@
+#include "MeshletCuller.h"
+#include "ImmediateSubmitter.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    VkDescriptorSetLayout createPushDescriptorLayout(VkDevice device, uint32_t bindingCount, VkShaderStageFlags stages) {
+        std::vector<VkDescriptorSetLayoutBinding> bindings(bindingCount);
+        for (uint32_t i = 0; i < bindingCount; ++i) {
+            bindings[i] = { i, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stages, nullptr };
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        layoutInfo.bindingCount = bindingCount;
+        layoutInfo.pBindings = bindings.data();
+
+        VkDescriptorSetLayout layout;
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create meshlet descriptor set layout!");
+        }
+        return layout;
+    }
+
+    // 写入推送描述符所需的结构，buffers 中依次对应 binding 0..n-1
+    void pushStorageBuffers(PFN_vkCmdPushDescriptorSetKHR pushDescriptorSet, VkCommandBuffer cmd, VkPipelineBindPoint bindPoint,
+        VkPipelineLayout layout, std::initializer_list<VkBuffer> buffers) {
+        VkDescriptorBufferInfo infos[8];
+        VkWriteDescriptorSet writes[8]{};
+        uint32_t count = 0;
+        for (VkBuffer buffer : buffers) {
+            infos[count] = { buffer, 0, VK_WHOLE_SIZE };
+            writes[count].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[count].dstBinding = count;
+            writes[count].descriptorCount = 1;
+            writes[count].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[count].pBufferInfo = &infos[count];
+            count++;
+        }
+        pushDescriptorSet(cmd, bindPoint, layout, 0, count, writes);
+    }
+
+    MeshletCuller::PushConstants makePushConstants(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, uint32_t meshletCount) {
+        MeshletCuller::PushConstants constants{};
+        constants.viewProjection = viewProjection;
+        constants.cameraPosition = glm::vec4(cameraPosition, 1.0f);
+        constants.meshletCount = meshletCount;
+        return constants;
+    }
+}
+
+MeshletCuller::MeshletCuller(VulkanContext& context, ImmediateSubmitter& submitter, const MeshletMesh& mesh, const std::string& shaderPath)
+    : _context(context) {
+    if (mesh.meshlets.empty()) {
+        throw std::runtime_error("cannot create a meshlet culler for an empty mesh!");
+    }
+    // 与 MipmapGenerator 相同，缓冲区通过推送描述符绑定
+    if (!_context.isDeviceExtensionEnabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+        std::cout << "[WARNING] VK_KHR_push_descriptor is not supported, GPU meshlet culling is disabled." << std::endl;
+        return;
+    }
+    _vkCmdPushDescriptorSetKHR = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+        vkGetDeviceProcAddr(_context.getDevice(), "vkCmdPushDescriptorSetKHR"));
+    if (_vkCmdPushDescriptorSetKHR == nullptr) {
+        throw std::runtime_error("failed to load vkCmdPushDescriptorSetKHR!");
+    }
+
+    _meshletCount = static_cast<uint32_t>(mesh.meshlets.size());
+    _maxIndexCount = mesh.maxTriangleCount * 3;
+
+    // 1. 簇数据只读，上传一次；输出索引缓冲区按全部三角形可见的情况分配
+    const VkBufferUsageFlags storage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    VkDeviceSize meshletsSize = mesh.meshlets.size() * sizeof(Meshlet);
+    VkDeviceSize verticesSize = mesh.vertices.size() * sizeof(uint32_t);
+    VkDeviceSize trianglesSize = mesh.triangles.size() * sizeof(uint32_t);
+    _meshlets = std::make_unique<VulkanBuffer>(_context, meshletsSize, storage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    _meshletVertices = std::make_unique<VulkanBuffer>(_context, verticesSize, storage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    _meshletTriangles = std::make_unique<VulkanBuffer>(_context, trianglesSize, storage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    _indexOutput = std::make_unique<VulkanBuffer>(_context, static_cast<VkDeviceSize>(_maxIndexCount) * sizeof(uint32_t),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    _drawCommand = std::make_unique<VulkanBuffer>(_context, sizeof(VkDrawIndexedIndirectCommand),
+        storage | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // instanceCount 固定为 1，每次剔除前只复位 indexCount
+    VkDrawIndexedIndirectCommand initialCommand{ 0, 1, 0, 0, 0 };
+    submitter.beginBatch();
+    submitter.copyDataToBuffer(mesh.meshlets.data(), *_meshlets, meshletsSize);
+    submitter.copyDataToBuffer(mesh.vertices.data(), *_meshletVertices, verticesSize);
+    submitter.copyDataToBuffer(mesh.triangles.data(), *_meshletTriangles, trianglesSize);
+    submitter.copyDataToBuffer(&initialCommand, *_drawCommand, sizeof(initialCommand));
+    submitter.wait(submitter.flush());
+
+    // 2. 剔除管线；网格着色器路径只需要布局，管线由调用方通过 PipelineBuilder 创建
+    createCullPipeline(shaderPath);
+    if (_context.isDeviceExtensionEnabled(VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+        _vkCmdDrawMeshTasksEXT = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(
+            vkGetDeviceProcAddr(_context.getDevice(), "vkCmdDrawMeshTasksEXT"));
+        if (_vkCmdDrawMeshTasksEXT != nullptr) {
+            createMeshSetLayout();
+        }
+    }
+    std::cout << "[SUCCESS] Meshlet culler created: " << _meshletCount << " meshlets, mesh shaders "
+              << (isMeshShaderSupported() ? "enabled" : "unavailable") << "." << std::endl;
+}
+
+MeshletCuller::~MeshletCuller() {
+    _pipeline.reset();
+    if (_cullSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(_context.getDevice(), _cullSetLayout, nullptr);
+    }
+    if (_meshSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(_context.getDevice(), _meshSetLayout, nullptr);
+    }
+}
+
+void MeshletCuller::createCullPipeline(const std::string& shaderPath) {
+    VkDevice device = _context.getDevice();
+
+    // 簇、簇顶点、簇三角形、间接绘制参数、输出索引
+    _cullSetLayout = createPushDescriptorLayout(device, 5, VK_SHADER_STAGE_COMPUTE_BIT);
+
+    VkPushConstantRange pushConstantRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants) };
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &_cullSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    VkPipelineLayout pipelineLayout;
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create meshlet cull pipeline layout!");
+    }
+
+    VkShaderModule shaderModule = _context.createShaderModule(_context.readFile(shaderPath));
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.layout = pipelineLayout;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "CSMain";
+
+    VkPipeline pipeline;
+    VkResult result = vkCreateComputePipelines(device, _context.getPipelineCache().get(), 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(device, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        throw std::runtime_error("failed to create meshlet cull pipeline!");
+    }
+    _pipeline = std::make_unique<VulkanPipeline>(_context, pipeline, pipelineLayout, true,
+        std::vector<VkPushConstantRange>{ pushConstantRange });
+}
+
+void MeshletCuller::createMeshSetLayout() {
+    // 簇、簇顶点、簇三角形、顶点数据
+    _meshSetLayout = createPushDescriptorLayout(_context.getDevice(), 4, VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT);
+}
+
+void MeshletCuller::recordCull(VkCommandBuffer cmd, const glm::mat4& viewProjection, const glm::vec3& cameraPosition) {
+    if (!isAvailable()) return;
+
+    // 1. 上一帧的间接绘制/索引读取结束后才能覆盖参数与输出索引（写后读只需执行依赖）
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+    vkCmdFillBuffer(cmd, _drawCommand->GetBuffer(), 0, sizeof(uint32_t), 0);
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    // 2. 每个工作组一个簇；超过单维上限时折叠到 y 维，着色器按 x + y * 65535 还原
+    _pipeline->bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+    pushStorageBuffers(_vkCmdPushDescriptorSetKHR, cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline->getLayout(), {
+        _meshlets->GetBuffer(), _meshletVertices->GetBuffer(), _meshletTriangles->GetBuffer(),
+        _drawCommand->GetBuffer(), _indexOutput->GetBuffer() });
+    PushConstants constants = makePushConstants(viewProjection, cameraPosition, _meshletCount);
+    _pipeline->pushConstants(cmd, constants);
+    uint32_t groupsX = std::min(_meshletCount, kMaxGroupsPerDimension);
+    uint32_t groupsY = (_meshletCount + kMaxGroupsPerDimension - 1) / kMaxGroupsPerDimension;
+    vkCmdDispatch(cmd, groupsX, groupsY, 1);
+
+    // 3. 结果对间接绘制参数读取和索引读取可见
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void MeshletCuller::recordDraw(VkCommandBuffer cmd) {
+    if (!isAvailable()) return;
+    vkCmdBindIndexBuffer(cmd, _indexOutput->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexedIndirect(cmd, _drawCommand->GetBuffer(), 0, 1, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+bool MeshletCuller::isMeshletVisible(const Meshlet& meshlet, const glm::mat4& viewProjection, const glm::vec3& cameraPosition) {
+    // 视锥平面取自矩阵的行（Vulkan 深度范围 [0, w]）：左右、上下、近、远
+    glm::vec4 rows[4];
+    for (int r = 0; r < 4; ++r) {
+        rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+    }
+    const glm::vec4 planes[6] = {
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[2],           rows[3] - rows[2],
+    };
+    for (const glm::vec4& plane : planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -meshlet.radius * length) {
+            return false;
+        }
+    }
+
+    // 法线锥：整簇背对相机时剔除
+    glm::vec3 toCenter = meshlet.center - cameraPosition;
+    return glm::dot(toCenter, meshlet.coneAxis) < meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius;
+}
+
+void MeshletCuller::configureMeshPipeline(PipelineBuilder& builder, const std::string& taskShaderPath, const std::string& meshShaderPath) const {
+    if (!isMeshShaderSupported()) {
+        throw std::runtime_error("mesh shaders are not supported on this device!");
+    }
+    builder.addShaderStage(VK_SHADER_STAGE_TASK_BIT_EXT, taskShaderPath, "ASMain");
+    builder.addShaderStage(VK_SHADER_STAGE_MESH_BIT_EXT, meshShaderPath, "MSMain");
+    builder.addDescriptorSetLayout(_meshSetLayout);
+    builder.addPushConstants<PushConstants>(VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT);
+}
+
+void MeshletCuller::recordDrawMeshTasks(VkCommandBuffer cmd, VulkanPipeline& pipeline, VulkanBuffer& vertexBuffer,
+    const glm::mat4& viewProjection, const glm::vec3& cameraPosition) {
+    if (!isMeshShaderSupported()) {
+        throw std::runtime_error("mesh shaders are not supported on this device!");
+    }
+    pipeline.bind(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    pushStorageBuffers(_vkCmdPushDescriptorSetKHR, cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.getLayout(), {
+        _meshlets->GetBuffer(), _meshletVertices->GetBuffer(), _meshletTriangles->GetBuffer(), vertexBuffer.GetBuffer() });
+    PushConstants constants = makePushConstants(viewProjection, cameraPosition, _meshletCount);
+    pipeline.pushConstants(cmd, constants);
+
+    // 每个任务工作组测试 32 个簇，并为其中可见的簇各派发一个网格工作组
+    uint32_t taskGroups = (_meshletCount + kTaskGroupSize - 1) / kTaskGroupSize;
+    _vkCmdDrawMeshTasksEXT(cmd, std::min(taskGroups, kMaxGroupsPerDimension),
+        (taskGroups + kMaxGroupsPerDimension - 1) / kMaxGroupsPerDimension, 1);
+}
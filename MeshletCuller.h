@@ -0,0 +1,97 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanPipeline.h"
+#include "VulkanBuffer.h"
+#include "MeshletBuilder.h"
+#include <memory>
+#include <string>
+
+class ImmediateSubmitter;
+
+/*
+ * @class MeshletCuller
+ * @brief 在 GPU 上按簇剔除，两条路径：
+ *
+ * - 计算着色器（res/meshlet_cull.hlsl）：每个工作组处理一个簇，做视锥与法线锥测试，
+ *   可见簇的三角形展开成全局索引写入紧凑的索引缓冲区，并累加 VkDrawIndexedIndirectCommand::indexCount，
+ *   之后用 vkCmdDrawIndexedIndirect 绘制，CPU 不需要读回任何数据。
+ * - 网格着色器（res/meshlet_mesh.hlsl，需要 VK_EXT_mesh_shader）：任务着色器做同样的测试，
+ *   网格着色器直接从存储缓冲区读取顶点输出三角形，不经过索引缓冲区。
+ *
+ * 两条路径都要求 VK_KHR_push_descriptor；不支持时 isAvailable() 为 false，调用方应退回普通的索引绘制。
+ * 矩阵为物体空间到裁剪空间（proj * view * model），相机位置也在物体空间，
+ * 因此法线锥测试与 MeshletBuilder 的约定一致（逆时针为正面）。
+ */
+class MeshletCuller {
+public:
+    // 与 res/meshlet_common.hlsli 中的 CullParams 一致
+    struct PushConstants {
+        glm::mat4 viewProjection;
+        glm::vec4 cameraPosition;
+        uint32_t meshletCount;
+        uint32_t pad[3];
+    };
+
+    MeshletCuller(VulkanContext& context, ImmediateSubmitter& submitter, const MeshletMesh& mesh,
+        const std::string& shaderPath = "res/meshlet_cull.spv");
+    ~MeshletCuller();
+
+    // 禁止拷贝
+    MeshletCuller(const MeshletCuller&) = delete;
+    MeshletCuller& operator=(const MeshletCuller&) = delete;
+
+    bool isAvailable() const { return _pipeline != nullptr; }
+    uint32_t getMeshletCount() const { return _meshletCount; }
+
+    /*
+     * @brief 记录剔除命令：复位间接绘制参数、dispatch、再用屏障让结果对 vkCmdDrawIndexedIndirect 可见。
+     * 必须在 vkCmdBeginRendering 之前调用。
+     */
+    void recordCull(VkCommandBuffer cmd, const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+
+    // 绑定剔除后的索引缓冲区并发起间接绘制；调用方负责绑定图形管线与顶点缓冲区（原始顶点，vertexOffset 为 0）
+    void recordDraw(VkCommandBuffer cmd);
+
+    // 与着色器相同的测试，供 CPU 侧校验或做粗粒度剔除
+    static bool isMeshletVisible(const Meshlet& meshlet, const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+
+    // --- 网格着色器路径 ---
+    bool isMeshShaderSupported() const { return _meshSetLayout != VK_NULL_HANDLE; }
+
+    /*
+     * @brief 为 builder 添加任务/网格着色器阶段、set 0 的推送描述符布局和推送常量。
+     * 片元着色器与其余描述符集（set 1 起）由调用方添加；顶点输入与图元装配状态对网格管线无效。
+     */
+    void configureMeshPipeline(PipelineBuilder& builder, const std::string& taskShaderPath = "res/meshlet_task.spv",
+        const std::string& meshShaderPath = "res/meshlet_mesh.spv") const;
+
+    /*
+     * @brief 用网格着色器绘制所有可见簇。pipeline 需由 configureMeshPipeline 配置，
+     * vertexBuffer 为 VertexFormat::Float32 的顶点数据，创建时需带 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT。
+     */
+    void recordDrawMeshTasks(VkCommandBuffer cmd, VulkanPipeline& pipeline, VulkanBuffer& vertexBuffer,
+        const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+
+private:
+    static constexpr uint32_t kMaxGroupsPerDimension = 65535;
+    static constexpr uint32_t kTaskGroupSize = 32;     // 与 meshlet_mesh.hlsl 中 ASMain 的线程数一致
+
+    void createCullPipeline(const std::string& shaderPath);
+    void createMeshSetLayout();
+
+    VulkanContext& _context;
+    uint32_t _meshletCount = 0;
+    uint32_t _maxIndexCount = 0;
+
+    std::unique_ptr<VulkanBuffer> _meshlets;
+    std::unique_ptr<VulkanBuffer> _meshletVertices;
+    std::unique_ptr<VulkanBuffer> _meshletTriangles;
+    std::unique_ptr<VulkanBuffer> _indexOutput;     // 剔除后的索引，按可见簇的到达顺序紧密排列
+    std::unique_ptr<VulkanBuffer> _drawCommand;     // VkDrawIndexedIndirectCommand
+
+    VkDescriptorSetLayout _cullSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout _meshSetLayout = VK_NULL_HANDLE;
+    std::unique_ptr<VulkanPipeline> _pipeline;
+    PFN_vkCmdPushDescriptorSetKHR _vkCmdPushDescriptorSetKHR = nullptr;
+    PFN_vkCmdDrawMeshTasksEXT _vkCmdDrawMeshTasksEXT = nullptr;
+};
@@ -0,0 +1,499 @@
+#include "MipmapGenerator.h"
+#include "VulkanImage.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIPMAP_USE_SSE2 1
+#endif
+
+namespace {
+    // 与 res/spd.hlsl 中的 Params 一致
+    struct PushConstants {
+        uint32_t mips;
+        uint32_t numWorkGroups;
+        uint32_t srgb;
+        uint32_t pad;
+    };
+
+    bool isSrgbFormat(VkFormat format) {
+        return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB;
+    }
+
+    // CPU 路径的纹素类型
+    enum class TexelKind { Byte4, Srgb4, Float4 };
+
+    bool getTexelKind(VkFormat format, TexelKind& kind) {
+        switch (format) {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_UINT:
+                kind = TexelKind::Byte4;
+                return true;
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                kind = TexelKind::Srgb4;
+                return true;
+            case VK_FORMAT_R32G32B32A32_SFLOAT:
+                kind = TexelKind::Float4;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // sRGB <-> 线性查表，alpha 不参与转换
+    struct SrgbTables {
+        float toLinear[256];
+        uint8_t toSrgb[4096];
+
+        SrgbTables() {
+            for (int i = 0; i < 256; ++i) {
+                float c = i / 255.0f;
+                toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < 4096; ++i) {
+                float c = i / 4095.0f;
+                float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                toSrgb[i] = static_cast<uint8_t>(std::clamp(s, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+    };
+
+    const SrgbTables& getSrgbTables() {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    // 以下三个函数都是 2x2 盒式滤波；源尺寸为奇数时丢弃最后一行/列（与 blit 链一致），尺寸为 1 的方向夹取到边界
+    void downsampleByte4(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight, uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight) {
+        for (uint32_t y = 0; y < dstHeight; ++y) {
+            const uint8_t* row0 = src + static_cast<size_t>(std::min(2 * y, srcHeight - 1)) * srcWidth * 4;
+            const uint8_t* row1 = src + static_cast<size_t>(std::min(2 * y + 1, srcHeight - 1)) * srcWidth * 4;
+            uint8_t* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+            uint32_t x = 0;
+#ifdef MIPMAP_USE_SSE2
+            // 每次处理两行各 4 个纹素，输出 2 个纹素；16 位累加保证结果与标量版本逐位一致
+            if (srcWidth >= 2) {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i bias = _mm_set1_epi16(2);
+                for (; x + 2 <= dstWidth; x += 2) {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+                    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                    __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+                    sum = _mm_srli_epi16(_mm_add_epi16(sum, bias), 2);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, zero));
+                }
+            }
+#endif
+            for (; x < dstWidth; ++x) {
+                uint32_t x0 = std::min(2 * x, srcWidth - 1) * 4;
+                uint32_t x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+                for (uint32_t c = 0; c < 4; ++c) {
+                    out[x * 4 + c] = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+                }
+            }
+        }
+    }
+
+    void downsampleSrgb4(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight, uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight) {
+        const SrgbTables& tables = getSrgbTables();
+        for (uint32_t y = 0; y < dstHeight; ++y) {
+            const uint8_t* row0 = src + static_cast<size_t>(std::min(2 * y, srcHeight - 1)) * srcWidth * 4;
+            const uint8_t* row1 = src + static_cast<size_t>(std::min(2 * y + 1, srcHeight - 1)) * srcWidth * 4;
+            uint8_t* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+            for (uint32_t x = 0; x < dstWidth; ++x) {
+                uint32_t x0 = std::min(2 * x, srcWidth - 1) * 4;
+                uint32_t x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+                for (uint32_t c = 0; c < 3; ++c) {
+                    float sum = tables.toLinear[row0[x0 + c]] + tables.toLinear[row0[x1 + c]]
+                              + tables.toLinear[row1[x0 + c]] + tables.toLinear[row1[x1 + c]];
+                    out[x * 4 + c] = tables.toSrgb[static_cast<uint32_t>(sum * 0.25f * 4095.0f + 0.5f)];
+                }
+                out[x * 4 + 3] = static_cast<uint8_t>((row0[x0 + 3] + row0[x1 + 3] + row1[x0 + 3] + row1[x1 + 3] + 2) >> 2);
+            }
+        }
+    }
+
+    void downsampleFloat4(const float* src, uint32_t srcWidth, uint32_t srcHeight, float* dst, uint32_t dstWidth, uint32_t dstHeight) {
+        for (uint32_t y = 0; y < dstHeight; ++y) {
+            const float* row0 = src + static_cast<size_t>(std::min(2 * y, srcHeight - 1)) * srcWidth * 4;
+            const float* row1 = src + static_cast<size_t>(std::min(2 * y + 1, srcHeight - 1)) * srcWidth * 4;
+            float* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+            for (uint32_t x = 0; x < dstWidth; ++x) {
+                uint32_t x0 = std::min(2 * x, srcWidth - 1) * 4;
+                uint32_t x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+#ifdef MIPMAP_USE_SSE2
+                __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)),
+                                        _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+                _mm_storeu_ps(out + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+                for (uint32_t c = 0; c < 4; ++c) {
+                    out[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+                }
+#endif
+            }
+        }
+    }
+}
+
+MipmapGenerator::MipmapGenerator(VulkanContext& context, const std::string& shaderPath) : _context(context) {
+    // 计算路径通过推送描述符绑定每张图像的视图，避免管理描述符集的生命周期
+    if (!_context.isDeviceExtensionEnabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+        std::cout << "[WARNING] VK_KHR_push_descriptor is not supported, compute mipmap generation is disabled." << std::endl;
+        return;
+    }
+    _vkCmdPushDescriptorSetKHR = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+        vkGetDeviceProcAddr(_context.getDevice(), "vkCmdPushDescriptorSetKHR"));
+    if (_vkCmdPushDescriptorSetKHR == nullptr) {
+        throw std::runtime_error("failed to load vkCmdPushDescriptorSetKHR!");
+    }
+
+    createPipeline(shaderPath);
+
+    _counters = std::make_unique<VulkanBuffer>(
+        _context,
+        kMaxLayers * sizeof(uint32_t),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+    memset(_counters->GetMappedMemory(), 0, kMaxLayers * sizeof(uint32_t));
+    _computeAvailable = true;
+}
+
+MipmapGenerator::~MipmapGenerator() {
+    _pipeline.reset();
+    if (_setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(_context.getDevice(), _setLayout, nullptr);
+    }
+}
+
+void MipmapGenerator::createPipeline(const std::string& shaderPath) {
+    VkDevice device = _context.getDevice();
+
+    // 1. 推送描述符布局：mip0（采样）、mip1..12（存储）、计数器、mip6（一致性存储）
+    VkDescriptorSetLayoutBinding bindings[4]{};
+    bindings[0] = { 0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr };
+    bindings[1] = { 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kMaxComputeMips, VK_SHADER_STAGE_COMPUTE_BIT, nullptr };
+    bindings[2] = { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr };
+    bindings[3] = { 3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr };
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    layoutInfo.bindingCount = 4;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create mipmap descriptor set layout!");
+    }
+
+    // 2. 管线布局 + 计算管线
+    VkPushConstantRange pushConstantRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants) };
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &_setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    VkPipelineLayout pipelineLayout;
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create mipmap pipeline layout!");
+    }
+
+    VkShaderModule shaderModule = _context.createShaderModule(_context.readFile(shaderPath));
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.layout = pipelineLayout;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "CSMain";
+
+    VkPipeline pipeline;
+    VkResult result = vkCreateComputePipelines(device, _context.getPipelineCache().get(), 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(device, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        throw std::runtime_error("failed to create mipmap compute pipeline!");
+    }
+    _pipeline = std::make_unique<VulkanPipeline>(_context, pipeline, pipelineLayout, true,
+        std::vector<VkPushConstantRange>{ pushConstantRange });
+}
+
+bool MipmapGenerator::supportsCompute(VkFormat format, uint32_t width, uint32_t height, uint32_t layerCount) const {
+    if (!_computeAvailable) return false;
+    if (format != VK_FORMAT_R8G8B8A8_UNORM && format != VK_FORMAT_R8G8B8A8_SRGB) return false;
+    // 第二阶段只由一个工作组处理 mip6，要求 mip6 不超过 64x64
+    if (std::max(width, height) > 4096 || layerCount > kMaxLayers) return false;
+
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(_context.getPhysicalDevice(), VK_FORMAT_R8G8B8A8_UNORM, &properties);
+    return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+}
+
+MipmapGenerator::Path MipmapGenerator::selectPath(VulkanContext& context, const MipmapGenerator* generator, VkFormat format, uint32_t width, uint32_t height, uint32_t layerCount) {
+    if (generator != nullptr && generator->supportsCompute(format, width, height, layerCount)) {
+        return Path::Compute;
+    }
+
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(context.getPhysicalDevice(), format, &properties);
+    const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    if ((properties.optimalTilingFeatures & blitFeatures) == blitFeatures) {
+        return Path::Blit;
+    }
+    if (canGenerateOnCpu(format)) {
+        return Path::Cpu;
+    }
+    throw std::runtime_error("texture format supports neither linear blitting nor CPU mipmap generation!");
+}
+
+VkImageCreateFlags MipmapGenerator::getComputeImageFlags(VkFormat format) {
+    // SRGB 图像不能直接作为存储图像，以 UNORM 别名写入，由着色器手动编码
+    return isSrgbFormat(format) ? (VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT) : 0;
+}
+
+void MipmapGenerator::recordCompute(VkCommandBuffer cmd, VulkanImage& image) {
+    uint32_t mips = image._mipLevels - 1;
+    if (mips == 0) {
+        image.recordTransitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        return;
+    }
+    uint32_t layerCount = image._arrayLayers;
+    bool srgb = isSrgbFormat(image._format);
+
+    // 1. 按级创建二维数组视图：[0] 为 mip0 的采样视图，其余为各级的存储视图
+    if (image._mipViews.empty()) {
+        image._mipViews.push_back(_context.createImageView(image._image, image._format, VK_IMAGE_ASPECT_COLOR_BIT, 1,
+            VK_IMAGE_VIEW_TYPE_2D_ARRAY, layerCount, 0, VK_IMAGE_USAGE_SAMPLED_BIT));
+        for (uint32_t level = 1; level <= mips; ++level) {
+            image._mipViews.push_back(_context.createImageView(image._image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, 1,
+                VK_IMAGE_VIEW_TYPE_2D_ARRAY, layerCount, level, VK_IMAGE_USAGE_STORAGE_BIT));
+        }
+    }
+
+    // 2. mip0 转为只读，其余级转为 GENERAL；同一屏障让上一次 dispatch 对计数器的复位可见
+    VkImageMemoryBarrier barriers[2]{};
+    for (auto& barrier : barriers) {
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image._image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.layerCount = layerCount;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    }
+    barriers[0].subresourceRange.baseMipLevel = 0;
+    barriers[0].subresourceRange.levelCount = 1;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barriers[1].subresourceRange.baseMipLevel = 1;
+    barriers[1].subresourceRange.levelCount = mips;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[1].srcAccessMask = 0;
+    barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    VkMemoryBarrier counterBarrier{};
+    counterBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    counterBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    counterBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &counterBarrier, 0, nullptr, 2, barriers);
+
+    // 3. 推送描述符；多余的存储槽位指向最后一级，着色器不会访问
+    VkDescriptorImageInfo srcInfo{ VK_NULL_HANDLE, image._mipViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    VkDescriptorImageInfo dstInfos[kMaxComputeMips];
+    for (uint32_t i = 0; i < kMaxComputeMips; ++i) {
+        dstInfos[i] = { VK_NULL_HANDLE, image._mipViews[std::min(i + 1, mips)], VK_IMAGE_LAYOUT_GENERAL };
+    }
+    VkDescriptorBufferInfo counterInfo{ _counters->GetBuffer(), 0, VK_WHOLE_SIZE };
+
+    VkWriteDescriptorSet writes[4]{};
+    for (uint32_t i = 0; i < 4; ++i) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+    }
+    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    writes[0].pImageInfo = &srcInfo;
+    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    writes[1].descriptorCount = kMaxComputeMips;
+    writes[1].pImageInfo = dstInfos;
+    writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writes[2].pBufferInfo = &counterInfo;
+    writes[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    writes[3].pImageInfo = &dstInfos[5];
+
+    _pipeline->bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+    _vkCmdPushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline->getLayout(), 0, 4, writes);
+
+    // 4. 一次 dispatch 写出所有级别，每个工作组负责 mip0 中 64x64 的区域
+    uint32_t groupsX = (image._extent.width + 63) / 64;
+    uint32_t groupsY = (image._extent.height + 63) / 64;
+    PushConstants constants{ mips, groupsX * groupsY, srgb ? 1u : 0u, 0 };
+    _pipeline->pushConstants(cmd, constants);
+    vkCmdDispatch(cmd, groupsX, groupsY, layerCount);
+
+    // 5. 生成的各级转为着色器只读
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barriers[1].srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barriers[1]);
+
+    image._layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+}
+
+// --- CPU 路径 ---
+
+bool MipmapGenerator::canGenerateOnCpu(VkFormat format) {
+    TexelKind kind;
+    return getTexelKind(format, kind);
+}
+
+uint32_t MipmapGenerator::getTexelSize(VkFormat format) {
+    TexelKind kind;
+    if (!getTexelKind(format, kind)) return 0;
+    return kind == TexelKind::Float4 ? 16 : 4;
+}
+
+VkDeviceSize MipmapGenerator::getCpuChainSize(VkFormat format, uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t layerCount) {
+    VkDeviceSize size = 0;
+    for (uint32_t level = 1; level < mipLevels; ++level) {
+        VkDeviceSize levelSize = static_cast<VkDeviceSize>(std::max(1u, width >> level)) * std::max(1u, height >> level)
+            * getTexelSize(format) * layerCount;
+        size += alignUp(levelSize, 16);
+    }
+    return size;
+}
+
+void MipmapGenerator::generateOnCpu(VkFormat format, const void* base, uint32_t width, uint32_t height, uint32_t mipLevels,
+    uint32_t layerCount, void* dst, std::vector<VkDeviceSize>& levelOffsets) {
+    TexelKind kind;
+    if (!getTexelKind(format, kind)) {
+        throw std::runtime_error("unsupported format for CPU mipmap generation!");
+    }
+    uint32_t texelSize = getTexelSize(format);
+
+    levelOffsets.clear();
+    const uint8_t* src = static_cast<const uint8_t*>(base);
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    uint32_t srcWidth = width;
+    uint32_t srcHeight = height;
+    VkDeviceSize offset = 0;
+
+    // 每一级都由上一级生成，上一级在 dst 中（或 base）
+    for (uint32_t level = 1; level < mipLevels; ++level) {
+        uint32_t dstWidth = std::max(1u, srcWidth / 2);
+        uint32_t dstHeight = std::max(1u, srcHeight / 2);
+        size_t srcLayerSize = static_cast<size_t>(srcWidth) * srcHeight * texelSize;
+        size_t dstLayerSize = static_cast<size_t>(dstWidth) * dstHeight * texelSize;
+        uint8_t* levelData = out + offset;
+
+        for (uint32_t layer = 0; layer < layerCount; ++layer) {
+            const uint8_t* layerSrc = src + layer * srcLayerSize;
+            uint8_t* layerDst = levelData + layer * dstLayerSize;
+            switch (kind) {
+                case TexelKind::Byte4:
+                    downsampleByte4(layerSrc, srcWidth, srcHeight, layerDst, dstWidth, dstHeight);
+                    break;
+                case TexelKind::Srgb4:
+                    downsampleSrgb4(layerSrc, srcWidth, srcHeight, layerDst, dstWidth, dstHeight);
+                    break;
+                case TexelKind::Float4:
+                    downsampleFloat4(reinterpret_cast<const float*>(layerSrc), srcWidth, srcHeight,
+                        reinterpret_cast<float*>(layerDst), dstWidth, dstHeight);
+                    break;
+            }
+        }
+
+        levelOffsets.push_back(offset);
+        offset += alignUp(dstLayerSize * layerCount, 16);
+        src = levelData;
+        srcWidth = dstWidth;
+        srcHeight = dstHeight;
+    }
+}
+
+// --- 基准测试 ---
+
+MipmapGenerator::BenchmarkResult MipmapGenerator::benchmark(VkQueue queue, uint32_t size, uint32_t layerCount, uint32_t iterations) {
+    BenchmarkResult result;
+    VkDevice device = _context.getDevice();
+    const VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    VkExtent3D extent = { size, size, 1 };
+    uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(size))) + 1;
+    bool computeEnabled = supportsCompute(format, size, size, layerCount);
+
+    // 1. 两张相同的图像，mip0 内容无关紧要
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    std::unique_ptr<VulkanImage> blitImage(new VulkanImage(_context, format, extent, mipLevels, usage,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, layerCount));
+    std::unique_ptr<VulkanImage> computeImage(new VulkanImage(_context, format, extent, mipLevels, usage | getComputeImageUsage(),
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, layerCount));
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = 4;
+    VkQueryPool queryPool;
+    if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create timestamp query pool!");
+    }
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(_context.getPhysicalDevice(), &properties);
+    double nsPerTick = properties.limits.timestampPeriod;
+
+    // 2. 每轮在同一个命令缓冲区中依次记录两种路径，各自前后写时间戳
+    uint32_t queryCount = computeEnabled ? 4 : 2;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        VkCommandBuffer cmd = _context.beginSingleTimeCommands();
+        vkCmdResetQueryPool(cmd, queryPool, 0, 4);
+
+        // 上一轮的内容直接丢弃
+        blitImage->setLayout(VK_IMAGE_LAYOUT_UNDEFINED);
+        computeImage->setLayout(VK_IMAGE_LAYOUT_UNDEFINED);
+        blitImage->recordTransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        computeImage->recordTransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+        blitImage->recordGenerateMipmaps(cmd);
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
+        if (computeEnabled) {
+            vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 2);
+            recordCompute(cmd, *computeImage);
+            vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 3);
+        }
+        _context.endSingleTimeCommands(cmd, queue);
+
+        uint64_t timestamps[4] = {};
+        vkGetQueryPoolResults(device, queryPool, 0, queryCount, sizeof(timestamps), timestamps, sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+        result.blitMs += (timestamps[1] - timestamps[0]) * nsPerTick / 1e6;
+        result.computeMs += (timestamps[3] - timestamps[2]) * nsPerTick / 1e6;
+    }
+    vkDestroyQueryPool(device, queryPool, nullptr);
+
+    if (iterations > 0) {
+        result.blitMs /= iterations;
+        result.computeMs /= iterations;
+    }
+    std::cout << "[INFO] mipmap benchmark " << size << "x" << size << "x" << layerCount
+              << ": blit " << result.blitMs << " ms, compute "
+              << (computeEnabled ? std::to_string(result.computeMs) + " ms" : std::string("n/a")) << std::endl;
+    return result;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanPipeline.h"
+#include "VulkanBuffer.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class VulkanImage;
+
+/*
+ * @class MipmapGenerator
+ * @brief mip 链生成：计算着色器单次 dispatch、blit 链、CPU 下采样三条路径。
+ *
+ * - Compute：res/spd.hlsl，一次 dispatch 写出所有级，前后各一次屏障。
+ *   要求 VK_KHR_push_descriptor、RGBA8（UNORM/SRGB）、mip0 不超过 4096。
+ * - Blit：VulkanImage 原有的逐级 vkCmdBlitImage，要求格式支持线性过滤。
+ * - Cpu：GPU 无法过滤的格式在上传前用 SIMD 盒式滤波生成全部级别。
+ * 三条路径都支持数组层与立方体贴图（6 层）。
+ */
+class MipmapGenerator {
+public:
+    enum class Path { Compute, Blit, Cpu };
+
+    struct BenchmarkResult {
+        double blitMs = 0.0;
+        double computeMs = 0.0;
+    };
+
+    explicit MipmapGenerator(VulkanContext& context, const std::string& shaderPath = "res/spd.spv");
+    ~MipmapGenerator();
+
+    // 禁止拷贝
+    MipmapGenerator(const MipmapGenerator&) = delete;
+    MipmapGenerator& operator=(const MipmapGenerator&) = delete;
+
+    bool supportsCompute(VkFormat format, uint32_t width, uint32_t height, uint32_t layerCount) const;
+
+    // generator 为空时只在 Blit 与 Cpu 之间选择；都不可用时抛出异常
+    static Path selectPath(VulkanContext& context, const MipmapGenerator* generator, VkFormat format, uint32_t width, uint32_t height, uint32_t layerCount);
+
+    // Compute 路径创建图像时额外需要的 usage / flags
+    static VkImageUsageFlags getComputeImageUsage() { return VK_IMAGE_USAGE_STORAGE_BIT; }
+    static VkImageCreateFlags getComputeImageFlags(VkFormat format);
+
+    /*
+     * @brief 记录计算着色器生成 mip 链的命令。
+     * 调用前所有级别处于 TRANSFER_DST_OPTIMAL 且 mip0 已写好，结束后整张图像为 SHADER_READ_ONLY_OPTIMAL。
+     */
+    void recordCompute(VkCommandBuffer cmd, VulkanImage& image);
+
+    // --- CPU 路径 ---
+    static bool canGenerateOnCpu(VkFormat format);
+    static uint32_t getTexelSize(VkFormat format);
+
+    // mip1..mipLevels-1 的总字节数；按级排列，每级内各层紧密相连
+    static VkDeviceSize getCpuChainSize(VkFormat format, uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t layerCount);
+
+    /*
+     * @brief 由 base（各层的 mip0 紧密相连）生成 mip1 起的各级，写入 dst。
+     * @param levelOffsets 输出每一级（从 mip1 开始）在 dst 中的偏移
+     */
+    static void generateOnCpu(VkFormat format, const void* base, uint32_t width, uint32_t height, uint32_t mipLevels,
+        uint32_t layerCount, void* dst, std::vector<VkDeviceSize>& levelOffsets);
+
+    /*
+     * @brief 用时间戳查询比较 blit 链与计算着色器在同一尺寸上的 GPU 耗时（毫秒，多次取平均）。
+     * @param queue 图形队列
+     */
+    BenchmarkResult benchmark(VkQueue queue, uint32_t size = 2048, uint32_t layerCount = 1, uint32_t iterations = 10);
+
+private:
+    static constexpr uint32_t kMaxComputeMips = 12;
+    static constexpr uint32_t kMaxLayers = 256;
+
+    void createPipeline(const std::string& shaderPath);
+
+    VulkanContext& _context;
+    bool _computeAvailable = false;
+    VkDescriptorSetLayout _setLayout = VK_NULL_HANDLE;
+    std::unique_ptr<VulkanPipeline> _pipeline;
+    std::unique_ptr<VulkanBuffer> _counters; // 每层一个原子计数器，由最后一个工作组复位
+    PFN_vkCmdPushDescriptorSetKHR _vkCmdPushDescriptorSetKHR = nullptr;
+};
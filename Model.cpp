@@ -1,11 +1,122 @@
 #include "Model.h"
+#include "MeshCache.h"
+#include "ObjParser.h"
+#include "VertexWelder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexCompressor.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
 #include <stdexcept>
 #include <iostream>
+#include <cstring>
 #include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <thread>
 
-Model::Model(const std::string& filePath)
+Model::Model(const std::string& filePath, bool useCache, uint32_t parseThreads)
+{
+    // 1. 优先使用二进制缓存：映射后直接使用，不做解析
+    if (useCache) {
+        _cache = MeshCache::open(filePath);
+        if (_cache) {
+            _vertexView = _cache->getVertices();
+            _indexView = _cache->getIndices();
+            submeshes.assign(_cache->getSubmeshes().begin(), _cache->getSubmeshes().end());
+            lods.assign(_cache->getLods().begin(), _cache->getLods().end());
+            bounds = _cache->getBounds();
+            std::cout << "Loaded model from cache: " << _vertexView.size() << " vertices, "
+                      << _indexView.size() << " indices\n";
+            return;
+        }
+    }
+
+    // 2. 多线程解析 OBJ，再针对顶点缓存、overdraw 与顶点读取重排，最后生成 LOD 链（索引追加在 LOD0 之后）
+    loadObj(filePath, parseThreads);
+    MeshOptimizer::Report report = MeshOptimizer::optimize(vertices, indices, submeshes);
+    std::cout << "[INFO] mesh optimized: ACMR " << report.before.acmr << " -> " << report.after.acmr
+              << ", ATVR " << report.before.atvr << " -> " << report.after.atvr << std::endl;
+    lods = MeshSimplifier::generateLods(vertices, indices, bounds);
+    _vertexView = vertices;
+    _indexView = indices;
+
+    // 3. 写入缓存，失败不影响本次加载
+    if (useCache) {
+        try {
+            MeshCache::write(filePath, vertices, indices, bounds, submeshes, lods);
+        } catch (const std::exception& e) {
+            std::cerr << "[WARNING] failed to write mesh cache: " << e.what() << std::endl;
+        }
+    }
+}
+
+namespace {
+    // ObjParser::Index 与 tinyobj::index_t 字段同名，两条解析路径共用
+    template <typename IndexT>
+    Vertex makeVertex(const std::vector<float>& positions, const std::vector<float>& normals, const std::vector<float>& texcoords,
+        const IndexT& index)
+    {
+        Vertex vertex{};
+
+        if (index.vertex_index >= 0) {
+            vertex.position = {
+                positions[3 * index.vertex_index + 0],
+                positions[3 * index.vertex_index + 1],
+                positions[3 * index.vertex_index + 2]
+            };
+        }
+
+        if (index.normal_index >= 0) {
+            vertex.normal = {
+                normals[3 * index.normal_index + 0],
+                normals[3 * index.normal_index + 1],
+                normals[3 * index.normal_index + 2]
+            };
+        }
+
+        if (index.texcoord_index >= 0) {
+            vertex.texCoord = {
+                texcoords[2 * index.texcoord_index + 0],
+                1.0f - texcoords[2 * index.texcoord_index + 1] // 翻转 V 轴（OBJ 通常需要）
+            };
+        }
+        return vertex;
+    }
+}
+
+void Model::loadObj(const std::string& filePath, uint32_t parseThreads)
+{
+    ObjParser::Result obj = ObjParser::parse(filePath, parseThreads);
+
+    for (size_t s = 0; s < obj.shapeStarts.size(); ++s) {
+        size_t first = obj.shapeStarts[s];
+        size_t last = s + 1 < obj.shapeStarts.size() ? obj.shapeStarts[s + 1] : obj.indices.size();
+        submeshes.push_back({ static_cast<uint32_t>(first), static_cast<uint32_t>(last - first) });
+    }
+
+    // 展开所有角点后一次性焊接；shape 之间共享顶点，与 tinyobj 路径一致
+    std::vector<Vertex> corners(obj.indices.size());
+    for (size_t i = 0; i < obj.indices.size(); ++i) {
+        corners[i] = makeVertex(obj.positions, obj.normals, obj.texcoords, obj.indices[i]);
+    }
+    VertexWelder::Options weldOptions{};
+    weldOptions.threadCount = parseThreads ? parseThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    VertexWelder::weld(corners, vertices, indices, weldOptions);
+
+    // 包围盒
+    bounds.min = glm::vec3(std::numeric_limits<float>::max());
+    bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+    for (const auto& vertex : vertices) {
+        bounds.min = glm::min(bounds.min, vertex.position);
+        bounds.max = glm::max(bounds.max, vertex.position);
+    }
+
+    std::cout << "Loaded model: " << vertices.size() << " vertices, "
+              << indices.size() << " indices\n";
+}
+
+void Model::loadObjReference(const std::string& filePath, std::vector<Vertex>& outVertices, std::vector<uint32_t>& outIndices)
 {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
@@ -16,46 +127,39 @@ Model::Model(const std::string& filePath)
         throw std::runtime_error(err);
     }
 
+    // 参考实现：保持最初的 unordered_map 去重，用来校验 ObjParser 与 VertexWelder
     std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-
     for (const auto& shape : shapes) {
         for (const auto& index : shape.mesh.indices) {
-            Vertex vertex{};
-
-            if (index.vertex_index >= 0) {
-                vertex.position = {
-                    attrib.vertices[3 * index.vertex_index + 0],
-                    attrib.vertices[3 * index.vertex_index + 1],
-                    attrib.vertices[3 * index.vertex_index + 2]
-                };
-            }
-
-            if (index.normal_index >= 0) {
-                vertex.normal = {
-                    attrib.normals[3 * index.normal_index + 0],
-                    attrib.normals[3 * index.normal_index + 1],
-                    attrib.normals[3 * index.normal_index + 2]
-                };
-            }
-
-            if (index.texcoord_index >= 0) {
-                vertex.texCoord = {
-                    attrib.texcoords[2 * index.texcoord_index + 0],
-                    1.0f - attrib.texcoords[2 * index.texcoord_index + 1] // 翻转 V 轴（OBJ 通常需要）
-                };
-            }
+            Vertex vertex = makeVertex(attrib.vertices, attrib.normals, attrib.texcoords, index);
 
             if (uniqueVertices.count(vertex) == 0) {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.push_back(vertex);
+                uniqueVertices[vertex] = static_cast<uint32_t>(outVertices.size());
+                outVertices.push_back(vertex);
             }
 
-            indices.push_back(uniqueVertices[vertex]);
+            outIndices.push_back(uniqueVertices[vertex]);
         }
     }
+}
 
-    std::cout << "Loaded model: " << vertices.size() << " vertices, "
-              << indices.size() << " indices\n";
+bool Model::verifyObjParser(const std::string& filePath, uint32_t parseThreads)
+{
+    Model model;
+    model.loadObj(filePath, parseThreads);
+    std::vector<Vertex> refVertices;
+    std::vector<uint32_t> refIndices;
+    loadObjReference(filePath, refVertices, refIndices);
+
+    bool identical = model.vertices.size() == refVertices.size() && model.indices.size() == refIndices.size()
+        && memcmp(model.vertices.data(), refVertices.data(), refVertices.size() * sizeof(Vertex)) == 0
+        && memcmp(model.indices.data(), refIndices.data(), refIndices.size() * sizeof(uint32_t)) == 0;
+    if (identical) {
+        std::cout << "[SUCCESS] ObjParser output matches tinyobjloader: " << filePath << std::endl;
+    } else {
+        std::cerr << "[WARNING] ObjParser output differs from tinyobjloader: " << filePath << std::endl;
+    }
+    return identical;
 }
 
 Model::~Model()
@@ -64,37 +168,17 @@ Model::~Model()
     indices.clear();
 }
 
-std::vector<VkVertexInputBindingDescription> Model::getVertexBindingDescription()
+std::vector<VkVertexInputBindingDescription> Model::getVertexBindingDescription(VertexFormat format, VertexLayout layout, bool positionOnly)
+{
+    return VertexCompressor::getBindingDescription(format, layout, positionOnly);
+}
+
+std::vector<VkVertexInputAttributeDescription> Model::getVertexAttributeDescription(VertexFormat format, VertexLayout layout, bool positionOnly)
 {
-    return {
-        {
-            .binding = 0,
-            .stride = sizeof(Vertex),
-            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-        },
-    };
+    return VertexCompressor::getAttributeDescription(format, layout, positionOnly);
 }
 
-std::vector<VkVertexInputAttributeDescription> Model::getVertexAttributeDescription()
+PackedMesh Model::pack(VertexFormat format, VertexLayout layout) const
 {
-    return {
-        {
-            .location = 0,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(Vertex, position),
-        },
-        {
-            .location = 1,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(Vertex, normal),
-        },
-        {
-            .location = 2,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32_SFLOAT,
-            .offset = offsetof(Vertex, texCoord),
-        },
-    };
+    return VertexCompressor::pack(_vertexView, _indexView, bounds, format, layout);
 }
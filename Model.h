@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <span>
+#include <memory>
 #include <glm/glm.hpp>
 #include <functional>
 #include <vulkan/vulkan.h>
@@ -41,17 +43,94 @@ namespace std {
     };
 }
 
+// 索引缓冲区中的一段，对应 OBJ 中的一个 shape
+struct Submesh {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+};
+
+// LOD 链中的一级：索引缓冲区中的一段，所有级别共用同一个顶点缓冲区
+struct LodLevel {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;        // 相对原始网格的最大几何误差（物体空间距离），LOD0 为 0
+};
+
+struct MeshBounds {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// GPU 端的顶点布局（详见 VertexCompressor）
+enum class VertexFormat {
+    Float32,    // 32 字节：与 Vertex 相同
+    Compact16,  // 16 字节：位置 4x16 UNORM（相对包围盒）+ 八面体法线 2x16 SNORM + UV 2x16 半精度
+    Compact8,   // 12 字节：位置 4x16 UNORM，八面体法线 2x8 SNORM 放在位置的 w 分量里 + UV 2x16 半精度
+};
 
+// 顶点流的组织方式
+enum class VertexLayout {
+    Interleaved,    // 单个绑定，所有属性交错存放
+    Split,          // 绑定 0 为紧密排列的位置流，绑定 1 为法线 + UV 属性流；只需位置的 pass 只读绑定 0
+};
+
+// 量化位置的还原：position = offset + scale * unorm
+struct PositionDequantization {
+    glm::vec3 scale;
+    glm::vec3 offset;
+};
+
+// 打包后可直接上传的顶点与索引数据
+struct PackedMesh {
+    VertexFormat format;
+    VertexLayout layout;
+    uint32_t vertexStride;      // Interleaved：完整顶点；Split：属性流（绑定 1）
+    uint32_t vertexCount;
+    std::vector<uint8_t> vertexData;
+    uint32_t positionStride;    // 仅 Split：位置流（绑定 0）
+    std::vector<uint8_t> positionData;
+    VkIndexType indexType;      // 顶点数不超过 65536 时为 VK_INDEX_TYPE_UINT16
+    uint32_t indexCount;
+    std::vector<uint8_t> indexData;
+    PositionDequantization dequantization;
+};
+
+class MeshCache;
 
 class Model {
 public:
-    Model(const std::string& filePath);
+    // useCache 为 true 时优先读取 <filePath>.meshcache，缺失或过期时解析 OBJ 并重新写入。
+    // parseThreads 为 ObjParser 使用的线程数，0 表示全部硬件线程
+    Model(const std::string& filePath, bool useCache = true, uint32_t parseThreads = 0);
     ~Model();
-    std::vector<Vertex>& getVertices() { return vertices; }
-    std::vector<uint32_t>& getIndices() { return indices; }
-    std::vector<VkVertexInputBindingDescription> getVertexBindingDescription();
-    std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescription();
+    // 命中缓存时直接指向映射内存，生命周期与 Model 相同
+    std::span<const Vertex> getVertices() const { return _vertexView; }
+    std::span<const uint32_t> getIndices() const { return _indexView; }
+    // 子网格只描述 LOD0；索引缓冲区中 LOD0 之后依次是各级简化网格（见 getLods）
+    const std::vector<Submesh>& getSubmeshes() const { return submeshes; }
+    const std::vector<LodLevel>& getLods() const { return lods; }
+    const MeshBounds& getBounds() const { return bounds; }
+    // positionOnly 为 true 时只描述位置（location 0），用于深度预 pass、阴影等只需位置的管线
+    std::vector<VkVertexInputBindingDescription> getVertexBindingDescription(VertexFormat format = VertexFormat::Float32,
+        VertexLayout layout = VertexLayout::Interleaved, bool positionOnly = false);
+    std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescription(VertexFormat format = VertexFormat::Float32,
+        VertexLayout layout = VertexLayout::Interleaved, bool positionOnly = false);
+    // 按指定格式与布局打包顶点，并自动选择 16/32 位索引
+    PackedMesh pack(VertexFormat format, VertexLayout layout = VertexLayout::Interleaved) const;
+
+    // 分别用 ObjParser + VertexWelder 与 tinyobjloader + unordered_map 加载同一文件，检查顶点与索引是否逐字节一致
+    static bool verifyObjParser(const std::string& filePath, uint32_t parseThreads = 0);
 private:
+    Model() = default;
+    void loadObj(const std::string& filePath, uint32_t parseThreads);
+    static void loadObjReference(const std::string& filePath, std::vector<Vertex>& outVertices, std::vector<uint32_t>& outIndices);
+
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
+    std::vector<Submesh> submeshes;
+    std::vector<LodLevel> lods;
+    MeshBounds bounds{};
+    std::unique_ptr<MeshCache> _cache;
+    std::span<const Vertex> _vertexView;
+    std::span<const uint32_t> _indexView;
 };
\ No newline at end of file
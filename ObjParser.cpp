@@ -0,0 +1,402 @@
+#include "ObjParser.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    // 记录中的相对索引（负数）要等合并时才知道前面各块有多少元素，先按块内计数存下来
+    constexpr int kMissing = INT32_MIN;
+
+    struct ChunkIndex {
+        int v, vt, vn;
+        uint8_t relative;   // bit0: v, bit1: vt, bit2: vn
+    };
+
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> texcoords;
+        std::vector<ChunkIndex> indices;
+        std::vector<size_t> shapeStarts;
+        std::string error;
+        size_t errorLine = 0;       // 块内行号（从 1 开始），报错时再换算成文件行号
+    };
+
+    inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+    inline bool isNewLine(char c) { return c == '\r' || c == '\n' || c == '\0'; }
+    inline bool isDigit(char c) { return static_cast<unsigned>(c - '0') < 10u; }
+
+    // 与 tinyobjloader 的 tryParseDouble 逐位一致（包括它的精度特性），不要“优化”成 strtod
+    bool tryParseDouble(const char* s, const char* s_end, double* result) {
+        if (s >= s_end) return false;
+
+        double mantissa = 0.0;
+        int exponent = 0;
+        char sign = '+';
+        char exp_sign = '+';
+        const char* curr = s;
+        int read = 0;
+        bool end_not_reached = false;
+        bool leading_decimal_dots = false;
+
+        if (*curr == '+' || *curr == '-') {
+            sign = *curr;
+            curr++;
+            if ((curr != s_end) && (*curr == '.')) {
+                leading_decimal_dots = true;
+            }
+        } else if (isDigit(*curr)) {
+        } else if (*curr == '.') {
+            leading_decimal_dots = true;
+        } else {
+            return false;
+        }
+
+        // 整数部分
+        end_not_reached = (curr != s_end);
+        if (!leading_decimal_dots) {
+            while (end_not_reached && isDigit(*curr)) {
+                mantissa *= 10;
+                mantissa += static_cast<int>(*curr - 0x30);
+                curr++;
+                read++;
+                end_not_reached = (curr != s_end);
+            }
+            if (read == 0) return false;
+        }
+        if (!end_not_reached) goto assemble;
+
+        // 小数部分
+        if (*curr == '.') {
+            curr++;
+            read = 1;
+            end_not_reached = (curr != s_end);
+            while (end_not_reached && isDigit(*curr)) {
+                static const double pow_lut[] = { 1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001 };
+                const int lut_entries = sizeof pow_lut / sizeof pow_lut[0];
+                mantissa += static_cast<int>(*curr - 0x30) * (read < lut_entries ? pow_lut[read] : std::pow(10.0, -read));
+                read++;
+                curr++;
+                end_not_reached = (curr != s_end);
+            }
+        } else if (*curr == 'e' || *curr == 'E') {
+        } else {
+            goto assemble;
+        }
+        if (!end_not_reached) goto assemble;
+
+        // 指数部分
+        if (*curr == 'e' || *curr == 'E') {
+            curr++;
+            end_not_reached = (curr != s_end);
+            if (end_not_reached && (*curr == '+' || *curr == '-')) {
+                exp_sign = *curr;
+                curr++;
+            } else if (isDigit(*curr)) {
+            } else {
+                return false;
+            }
+
+            read = 0;
+            end_not_reached = (curr != s_end);
+            while (end_not_reached && isDigit(*curr)) {
+                if (exponent > (2147483647 / 10)) return false;
+                exponent *= 10;
+                exponent += static_cast<int>(*curr - 0x30);
+                curr++;
+                read++;
+                end_not_reached = (curr != s_end);
+            }
+            exponent *= (exp_sign == '+' ? 1 : -1);
+            if (read == 0) return false;
+        }
+
+    assemble:
+        *result = (sign == '+' ? 1 : -1) * (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+        return true;
+    }
+
+    // 对应 tinyobj 的 parseReal：跳过空白，取到下一个空白为止，失败时返回默认值 0
+    float parseReal(const char*& token, const char* lineEnd) {
+        while (token < lineEnd && isSpace(*token)) token++;
+        const char* end = token;
+        while (end < lineEnd && !isSpace(*end) && *end != '\r') end++;
+        double value = 0.0;
+        tryParseDouble(token, end, &value);
+        token = end;
+        return static_cast<float>(value);
+    }
+
+    // atoi 语义：可选符号 + 数字，遇到其它字符停止
+    int parseInt(const char* token, const char* lineEnd) {
+        bool negative = false;
+        if (token < lineEnd && (*token == '+' || *token == '-')) {
+            negative = *token == '-';
+            token++;
+        }
+        int value = 0;
+        while (token < lineEnd && isDigit(*token)) {
+            value = value * 10 + (*token - '0');
+            token++;
+        }
+        return negative ? -value : value;
+    }
+
+    // 与 tinyobj 的 fixIndex 相同：正数从 1 开始，负数相对于当前已读到的数量；0 非法
+    bool fixIndex(int idx, size_t localCount, int& value, uint8_t& relative, uint8_t bit) {
+        if (idx > 0) {
+            value = idx - 1;
+            return true;
+        }
+        if (idx == 0) return false;
+        value = static_cast<int>(localCount) + idx;   // 可能为负，表示落在前面的块中
+        relative |= bit;
+        return true;
+    }
+
+    const char* skipComponent(const char* token, const char* lineEnd) {
+        while (token < lineEnd && *token != '/' && !isSpace(*token) && *token != '\r') token++;
+        return token;
+    }
+
+    // 对应 tinyobj 的 parseTriple：i, i/j, i//k, i/j/k
+    bool parseTriple(const char*& token, const char* lineEnd, const Chunk& chunk, ChunkIndex& out) {
+        out = { kMissing, kMissing, kMissing, 0 };
+        if (!fixIndex(parseInt(token, lineEnd), chunk.positions.size() / 3, out.v, out.relative, 1)) return false;
+        token = skipComponent(token, lineEnd);
+        if (token >= lineEnd || *token != '/') return true;
+        token++;
+
+        if (token < lineEnd && *token == '/') {
+            token++;
+            if (!fixIndex(parseInt(token, lineEnd), chunk.normals.size() / 3, out.vn, out.relative, 4)) return false;
+            token = skipComponent(token, lineEnd);
+            return true;
+        }
+
+        if (!fixIndex(parseInt(token, lineEnd), chunk.texcoords.size() / 2, out.vt, out.relative, 2)) return false;
+        token = skipComponent(token, lineEnd);
+        if (token >= lineEnd || *token != '/') return true;
+        token++;
+        if (!fixIndex(parseInt(token, lineEnd), chunk.normals.size() / 3, out.vn, out.relative, 4)) return false;
+        token = skipComponent(token, lineEnd);
+        return true;
+    }
+
+    void parseChunk(Chunk& chunk) {
+        std::vector<ChunkIndex> face;
+        size_t line = 0;
+        const char* cursor = chunk.begin;
+
+        while (cursor < chunk.end) {
+            const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', static_cast<size_t>(chunk.end - cursor)));
+            if (lineEnd == nullptr) lineEnd = chunk.end;
+            const char* token = cursor;
+            cursor = lineEnd + 1;
+            line++;
+
+            while (token < lineEnd && isSpace(*token)) token++;
+            if (token >= lineEnd || *token == '#' || *token == '\r') continue;
+            char next = token + 1 < lineEnd ? token[1] : '\0';
+
+            if (token[0] == 'v' && isSpace(next)) {
+                token += 2;
+                chunk.positions.push_back(parseReal(token, lineEnd));
+                chunk.positions.push_back(parseReal(token, lineEnd));
+                chunk.positions.push_back(parseReal(token, lineEnd));
+            } else if (token[0] == 'v' && next == 'n' && token + 2 < lineEnd && isSpace(token[2])) {
+                token += 3;
+                chunk.normals.push_back(parseReal(token, lineEnd));
+                chunk.normals.push_back(parseReal(token, lineEnd));
+                chunk.normals.push_back(parseReal(token, lineEnd));
+            } else if (token[0] == 'v' && next == 't' && token + 2 < lineEnd && isSpace(token[2])) {
+                token += 3;
+                chunk.texcoords.push_back(parseReal(token, lineEnd));
+                chunk.texcoords.push_back(parseReal(token, lineEnd));
+            } else if (token[0] == 'f' && isSpace(next)) {
+                token += 2;
+                while (token < lineEnd && isSpace(*token)) token++;
+                face.clear();
+                while (token < lineEnd && !isNewLine(*token)) {
+                    ChunkIndex index;
+                    if (!parseTriple(token, lineEnd, chunk, index)) {
+                        chunk.error = "invalid face index";
+                        chunk.errorLine = line;
+                        return;
+                    }
+                    face.push_back(index);
+                    while (token < lineEnd && (isSpace(*token) || *token == '\r')) token++;
+                }
+                // 扇形三角化（与 tinyobj 1.0.x 相同）
+                for (size_t k = 2; k < face.size(); ++k) {
+                    chunk.indices.push_back(face[0]);
+                    chunk.indices.push_back(face[k - 1]);
+                    chunk.indices.push_back(face[k]);
+                }
+            } else if ((token[0] == 'o' || token[0] == 'g') && isSpace(next)) {
+                chunk.shapeStarts.push_back(chunk.indices.size());
+            }
+        }
+    }
+
+    // 把文件切成 count 块，每块都从行首开始
+    std::vector<Chunk> splitChunks(const char* data, size_t size, uint32_t count) {
+        std::vector<Chunk> chunks;
+        const char* begin = data;
+        const char* end = data + size;
+        for (uint32_t i = 0; i < count && begin < end; ++i) {
+            const char* split = (i + 1 == count) ? end : data + size / count * (i + 1);
+            if (split < begin) split = begin;
+            if (split < end) {
+                const char* newline = static_cast<const char*>(memchr(split, '\n', static_cast<size_t>(end - split)));
+                split = newline ? newline + 1 : end;
+            }
+            Chunk chunk{};
+            chunk.begin = begin;
+            chunk.end = split;
+            chunks.push_back(std::move(chunk));
+            begin = split;
+        }
+        return chunks;
+    }
+}
+
+ObjParser::Result ObjParser::parse(const std::string& path, uint32_t threadCount) {
+    MappedFile file(path);
+    const char* data = reinterpret_cast<const char*>(file.data());
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    // 小文件不值得开线程：每块至少 1MB
+    threadCount = static_cast<uint32_t>(std::clamp<size_t>(file.size() >> 20, 1, threadCount));
+
+    std::vector<Chunk> chunks = splitChunks(data, file.size(), threadCount);
+    auto runParallel = [&](auto&& task) {
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            workers.emplace_back(task, i);
+        }
+        if (!chunks.empty()) task(size_t(0));
+        for (auto& worker : workers) worker.join();
+    };
+    auto throwIfFailed = [&]() {
+        for (const auto& chunk : chunks) {
+            if (!chunk.error.empty()) {
+                if (chunk.errorLine == 0) {
+                    throw std::runtime_error(path + ": " + chunk.error);
+                }
+                size_t line = static_cast<size_t>(std::count(data, chunk.begin, '\n')) + chunk.errorLine;
+                throw std::runtime_error(path + ":" + std::to_string(line) + ": " + chunk.error);
+            }
+        }
+    };
+
+    // 1. 各块并行解析
+    runParallel([&](size_t i) { parseChunk(chunks[i]); });
+    throwIfFailed();
+
+    // 2. 前缀和：每块的属性与索引在最终数组中的起始位置
+    struct Bases { size_t v, vt, vn, index; };
+    std::vector<Bases> bases(chunks.size());
+    Bases total{};
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        bases[i] = total;
+        total.v += chunks[i].positions.size() / 3;
+        total.vt += chunks[i].texcoords.size() / 2;
+        total.vn += chunks[i].normals.size() / 3;
+        total.index += chunks[i].indices.size();
+    }
+
+    Result result;
+    result.positions.resize(total.v * 3);
+    result.texcoords.resize(total.vt * 2);
+    result.normals.resize(total.vn * 3);
+    result.indices.resize(total.index);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (size_t start : chunks[i].shapeStarts) {
+            result.shapeStarts.push_back(bases[i].index + start);
+        }
+    }
+
+    // 3. 并行拷贝属性、把相对索引换算成全局索引并做越界检查
+    runParallel([&](size_t i) {
+        Chunk& chunk = chunks[i];
+        const Bases& base = bases[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), result.positions.begin() + base.v * 3);
+        std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), result.texcoords.begin() + base.vt * 2);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), result.normals.begin() + base.vn * 3);
+
+        auto resolve = [](int value, bool relative, size_t chunkBase, size_t count, int& out) {
+            if (value == kMissing) {
+                out = -1;
+                return true;
+            }
+            int64_t global = relative ? static_cast<int64_t>(chunkBase) + value : value;
+            if (global < 0 || global >= static_cast<int64_t>(count)) return false;
+            out = static_cast<int>(global);
+            return true;
+        };
+        Index* out = result.indices.data() + base.index;
+        for (size_t k = 0; k < chunk.indices.size(); ++k) {
+            const ChunkIndex& in = chunk.indices[k];
+            if (!resolve(in.v, in.relative & 1, base.v, total.v, out[k].vertex_index)
+                || !resolve(in.vt, in.relative & 2, base.vt, total.vt, out[k].texcoord_index)
+                || !resolve(in.vn, in.relative & 4, base.vn, total.vn, out[k].normal_index)) {
+                chunk.error = "face index out of range (triangle corner " + std::to_string(base.index + k) + ")";
+                return;
+            }
+        }
+        // 尽早释放块内存，峰值只比最终结果多一份
+        std::vector<float>().swap(chunk.positions);
+        std::vector<float>().swap(chunk.texcoords);
+        std::vector<float>().swap(chunk.normals);
+        std::vector<ChunkIndex>().swap(chunk.indices);
+    });
+    throwIfFailed();
+
+    // 去掉空 shape（与 tinyobj 一样，没有面的 o / g 不产生 shape）
+    std::vector<size_t> shapeStarts;
+    for (size_t start : result.shapeStarts) {
+        if (start < total.index && (shapeStarts.empty() || shapeStarts.back() != start)) {
+            shapeStarts.push_back(start);
+        }
+    }
+    if (total.index > 0 && (shapeStarts.empty() || shapeStarts.front() != 0)) {
+        shapeStarts.insert(shapeStarts.begin(), 0);
+    }
+    result.shapeStarts = std::move(shapeStarts);
+    return result;
+}
+
+std::vector<double> ObjParser::benchmark(const std::string& path, const std::vector<uint32_t>& threadCounts, uint32_t repeats) {
+    double megabytes = 0.0;
+    {
+        MappedFile file(path);
+        megabytes = static_cast<double>(file.size()) / (1024.0 * 1024.0);
+    }
+    // 先完整读一遍，让文件进入页缓存，避免第一组测到的是磁盘速度
+    parse(path, 0);
+
+    std::vector<double> throughput;
+    for (uint32_t threads : threadCounts) {
+        double best = 0.0;
+        for (uint32_t r = 0; r < std::max(repeats, 1u); ++r) {
+            auto start = std::chrono::high_resolution_clock::now();
+            Result result = parse(path, threads);
+            auto end = std::chrono::high_resolution_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            best = std::max(best, megabytes / std::max(seconds, 1e-9));
+        }
+        throughput.push_back(best);
+        std::cout << "[INFO] ObjParser " << path << " (" << megabytes << " MB), " << threads
+            << " thread(s): " << best << " MB/s" << std::endl;
+    }
+    return throughput;
+}
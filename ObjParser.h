@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * @class ObjParser
+ * @brief 多线程 OBJ 解析器。
+ *
+ * 文件被内存映射后按行边界切成若干块，每个线程独立解析 v / vn / vt / f 记录到各自的数组，
+ * 最后按块顺序合并并修正相对（负数）索引。数值解析与 tinyobjloader 的 tryParseDouble / atoi
+ * 逐位一致，多边形按 tinyobj 1.0.x 的方式做扇形三角化，因此 Model 去重后的结果与
+ * tinyobj::LoadObj 完全相同（见 Model::verifyObjParser）。
+ * 只解析几何数据；usemtl / mtllib 等记录被忽略，o / g 用于划分子网格。
+ */
+class ObjParser {
+public:
+    // 字段名与 tinyobj::index_t 一致，缺失的分量为 -1
+    struct Index {
+        int vertex_index;
+        int normal_index;
+        int texcoord_index;
+    };
+
+    struct Result {
+        std::vector<float> positions;   // xyz
+        std::vector<float> normals;     // xyz
+        std::vector<float> texcoords;   // uv
+        std::vector<Index> indices;     // 三角化后的角点，按文件顺序
+        std::vector<size_t> shapeStarts; // 每个 shape 在 indices 中的起始位置（已去掉空 shape）
+    };
+
+    // threadCount 为 0 时使用全部硬件线程；解析出错时抛出 std::runtime_error
+    static Result parse(const std::string& path, uint32_t threadCount = 0);
+
+    // 以不同线程数重复解析同一文件，打印并返回每种线程数下的吞吐量（MB/s）
+    static std::vector<double> benchmark(const std::string& path, const std::vector<uint32_t>& threadCounts, uint32_t repeats = 3);
+};
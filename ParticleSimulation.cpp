@@ -0,0 +1,197 @@
+#include "ParticleSimulation.h"
+#include "ImmediateSubmitter.h"
+#include "PipelineRegistry.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    // 与 res/particle.comp 中的 constant_id 一致
+    constexpr uint32_t kWorkgroupSizeId = 0;
+    constexpr uint32_t kRuntimeParamsId = 1;
+    constexpr uint32_t kSubstepsId = 2;
+    constexpr uint32_t kColorBySpeedId = 3;
+    constexpr uint32_t kApplyDragId = 4;
+
+    constexpr uint32_t kFlagColorBySpeed = 1;
+    constexpr uint32_t kFlagApplyDrag = 2;
+}
+
+ParticleSimulation::ParticleSimulation(VulkanContext& context, ImmediateSubmitter& submitter, PipelineRegistry& registry,
+    std::span<const Particle> particles, const std::string& shaderPath)
+    : _context(context), _registry(registry), _shaderPath(shaderPath) {
+    if (particles.empty()) {
+        throw std::runtime_error("cannot create a particle simulation without particles!");
+    }
+    // 与 MeshletCuller 相同，缓冲区通过推送描述符绑定
+    if (!_context.isDeviceExtensionEnabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+        std::cout << "[WARNING] VK_KHR_push_descriptor is not supported, GPU particle simulation is disabled." << std::endl;
+        return;
+    }
+    _vkCmdPushDescriptorSetKHR = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+        vkGetDeviceProcAddr(_context.getDevice(), "vkCmdPushDescriptorSetKHR"));
+    if (_vkCmdPushDescriptorSetKHR == nullptr) {
+        throw std::runtime_error("failed to load vkCmdPushDescriptorSetKHR!");
+    }
+
+    // 1. 两个缓冲区都写入初始状态，第一次更新从 _buffers[0] 读
+    _particleCount = static_cast<uint32_t>(particles.size());
+    VkDeviceSize size = particles.size_bytes();
+    for (auto& buffer : _buffers) {
+        buffer = std::make_unique<VulkanBuffer>(_context, size,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+    submitter.beginBatch();
+    submitter.copyDataToBuffer(particles.data(), *_buffers[0], size);
+    submitter.copyDataToBuffer(particles.data(), *_buffers[1], size);
+    submitter.wait(submitter.flush());
+
+    // 2. 布局在所有变体间共享，只有特化常量不同
+    const VkDescriptorSetLayoutBinding bindings[] = {
+        { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+        { 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+    };
+    _setLayout = _registry.getDescriptorSetLayout(bindings, VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR);
+    setSettings(_settings);
+
+    std::cout << "[SUCCESS] Particle simulation created: " << _particleCount << " particles." << std::endl;
+}
+
+std::shared_ptr<VulkanPipeline> ParticleSimulation::getPipeline(const Settings& settings, bool runtimeParams) {
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(_context.getPhysicalDevice(), &properties);
+    if (settings.workgroupSize == 0 || settings.workgroupSize > properties.limits.maxComputeWorkGroupSize[0]
+        || settings.workgroupSize > properties.limits.maxComputeWorkGroupInvocations) {
+        throw std::runtime_error("particle workgroup size " + std::to_string(settings.workgroupSize) + " is not supported!");
+    }
+    if (settings.substeps == 0) {
+        throw std::runtime_error("particle simulation needs at least one substep!");
+    }
+
+    // 运行时版本只特化工作组大小，其余参数的默认值不会被使用
+    SpecializationConstants constants;
+    constants.set(kWorkgroupSizeId, settings.workgroupSize);
+    constants.set(kRuntimeParamsId, runtimeParams);
+    if (!runtimeParams) {
+        constants.set(kSubstepsId, settings.substeps);
+        constants.set(kColorBySpeedId, settings.colorBySpeed);
+        constants.set(kApplyDragId, settings.applyDrag);
+    }
+    const VkPushConstantRange pushConstantRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants) };
+    return _registry.getComputePipeline(_shaderPath, _setLayout, std::span<const VkPushConstantRange>(&pushConstantRange, 1), constants);
+}
+
+void ParticleSimulation::setSettings(const Settings& settings) {
+    if (!isAvailable()) return;
+    _pipeline = getPipeline(settings, false);
+    _settings = settings;
+}
+
+void ParticleSimulation::recordDispatch(VkCommandBuffer cmd, VulkanPipeline& pipeline, const Settings& settings, float deltaTime,
+    VulkanBuffer& input, VulkanBuffer& output) {
+    pipeline.bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+
+    VkDescriptorBufferInfo infos[2] = { { input.GetBuffer(), 0, VK_WHOLE_SIZE }, { output.GetBuffer(), 0, VK_WHOLE_SIZE } };
+    VkWriteDescriptorSet writes[2]{};
+    for (uint32_t i = 0; i < 2; ++i) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &infos[i];
+    }
+    _vkCmdPushDescriptorSetKHR(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.getLayout(), 0, 2, writes);
+
+    PushConstants constants{};
+    constants.deltaTime = deltaTime;
+    constants.particleCount = _particleCount;
+    constants.substeps = settings.substeps;
+    constants.flags = (settings.colorBySpeed ? kFlagColorBySpeed : 0) | (settings.applyDrag ? kFlagApplyDrag : 0);
+    pipeline.pushConstants(cmd, constants);
+
+    vkCmdDispatch(cmd, (_particleCount + settings.workgroupSize - 1) / settings.workgroupSize, 1, 1);
+}
+
+void ParticleSimulation::recordUpdate(VkCommandBuffer cmd, float deltaTime) {
+    if (!isAvailable()) return;
+
+    // 1. 上一次更新（或顶点读取）结束后才能覆盖另一个缓冲区
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    const uint32_t next = 1 - _current;
+    recordDispatch(cmd, *_pipeline, _settings, deltaTime, *_buffers[_current], *_buffers[next]);
+    _current = next;
+
+    // 2. 结果对顶点输入可见
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+ParticleSimulation::BenchmarkResult ParticleSimulation::benchmark(VkQueue queue, const Settings& settings, uint32_t iterations) {
+    BenchmarkResult result;
+    if (!isAvailable()) return result;
+
+    VkDevice device = _context.getDevice();
+    std::shared_ptr<VulkanPipeline> runtimePipeline = getPipeline(settings, true);
+    std::shared_ptr<VulkanPipeline> specializedPipeline = getPipeline(settings, false);
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = 4;
+    VkQueryPool queryPool;
+    if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create timestamp query pool!");
+    }
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(_context.getPhysicalDevice(), &properties);
+    double nsPerTick = properties.limits.timestampPeriod;
+
+    // 两个版本读写同一对缓冲区，结果相同；中间的屏障让它们不会重叠执行
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    VulkanBuffer& input = *_buffers[_current];
+    VulkanBuffer& output = *_buffers[1 - _current];
+    const float deltaTime = 1.0f / 60.0f;
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        VkCommandBuffer cmd = _context.beginSingleTimeCommands();
+        vkCmdResetQueryPool(cmd, queryPool, 0, 4);
+
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+        recordDispatch(cmd, *runtimePipeline, settings, deltaTime, input, output);
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 2);
+        recordDispatch(cmd, *specializedPipeline, settings, deltaTime, input, output);
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 3);
+        _context.endSingleTimeCommands(cmd, queue);
+
+        uint64_t timestamps[4] = {};
+        vkGetQueryPoolResults(device, queryPool, 0, 4, sizeof(timestamps), timestamps, sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+        result.runtimeMs += (timestamps[1] - timestamps[0]) * nsPerTick / 1e6;
+        result.specializedMs += (timestamps[3] - timestamps[2]) * nsPerTick / 1e6;
+    }
+    vkDestroyQueryPool(device, queryPool, nullptr);
+    _current = 1 - _current;
+
+    if (iterations > 0) {
+        result.runtimeMs /= iterations;
+        result.specializedMs /= iterations;
+    }
+    std::cout << "[INFO] particle benchmark " << _particleCount << " particles, group " << settings.workgroupSize
+              << ", " << settings.substeps << " substeps: uniform branches " << result.runtimeMs
+              << " ms, specialized " << result.specializedMs << " ms" << std::endl;
+    return result;
+}
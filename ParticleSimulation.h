@@ -0,0 +1,94 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanPipeline.h"
+#include "VulkanBuffer.h"
+#include <memory>
+#include <span>
+#include <string>
+
+class ImmediateSubmitter;
+class PipelineRegistry;
+
+/*
+ * @class ParticleSimulation
+ * @brief 在 GPU 上更新粒子（res/particle.comp），两个存储缓冲区交替作为输入与输出。
+ *
+ * 工作组大小、积分子步数和功能开关通过特化常量传入，每种 Settings 组合从 PipelineRegistry
+ * 取得一个缓存的管线变体，切换设置不会重新编译。着色器也保留了从推送常量读取这些参数的运行时分支版本，
+ * benchmark() 用时间戳查询比较两者。
+ *
+ * 缓冲区通过推送描述符绑定，要求 VK_KHR_push_descriptor；不支持时 isAvailable() 为 false。
+ */
+class ParticleSimulation {
+public:
+    // 与 res/compute.hlsl、res/particle.comp 中的 Particle 一致
+    struct Particle {
+        glm::vec3 position; float pad1;
+        glm::vec3 velocity; float pad2;
+        glm::vec4 color;
+    };
+
+    // 与 res/particle.comp 中的 Params 一致
+    struct PushConstants {
+        float deltaTime;
+        uint32_t particleCount;
+        uint32_t substeps;
+        uint32_t flags;
+    };
+
+    struct Settings {
+        uint32_t workgroupSize = 64;
+        uint32_t substeps = 1;
+        bool colorBySpeed = true;
+        bool applyDrag = false;
+    };
+
+    struct BenchmarkResult {
+        double runtimeMs = 0.0;       // 参数来自推送常量，着色器中保留分支与循环
+        double specializedMs = 0.0;   // 参数为特化常量
+    };
+
+    ParticleSimulation(VulkanContext& context, ImmediateSubmitter& submitter, PipelineRegistry& registry,
+        std::span<const Particle> particles, const std::string& shaderPath = "res/particle.spv");
+
+    // 禁止拷贝
+    ParticleSimulation(const ParticleSimulation&) = delete;
+    ParticleSimulation& operator=(const ParticleSimulation&) = delete;
+
+    bool isAvailable() const { return _setLayout != VK_NULL_HANDLE; }
+    uint32_t getParticleCount() const { return _particleCount; }
+
+    // 选择（必要时创建）对应的特化变体；workgroupSize 超出设备限制时抛出异常
+    void setSettings(const Settings& settings);
+    const Settings& getSettings() const { return _settings; }
+
+    // 记录一次更新并交换输入/输出；结束时写入对顶点读取可见
+    void recordUpdate(VkCommandBuffer cmd, float deltaTime);
+
+    // 最近一次更新的结果
+    VulkanBuffer& getOutputBuffer() { return *_buffers[_current]; }
+
+    /*
+     * @brief 用时间戳查询比较同一组 settings 下运行时分支版本与特化版本的 GPU 耗时（毫秒，多次取平均）。
+     * @param queue 支持计算的队列
+     */
+    BenchmarkResult benchmark(VkQueue queue, const Settings& settings, uint32_t iterations = 10);
+
+private:
+    std::shared_ptr<VulkanPipeline> getPipeline(const Settings& settings, bool runtimeParams);
+    void recordDispatch(VkCommandBuffer cmd, VulkanPipeline& pipeline, const Settings& settings, float deltaTime,
+        VulkanBuffer& input, VulkanBuffer& output);
+
+    VulkanContext& _context;
+    PipelineRegistry& _registry;
+    std::string _shaderPath;
+    uint32_t _particleCount = 0;
+
+    std::unique_ptr<VulkanBuffer> _buffers[2];
+    uint32_t _current = 0;                          // 最近一次写入的缓冲区
+
+    Settings _settings;
+    VkDescriptorSetLayout _setLayout = VK_NULL_HANDLE;  // 由 registry 持有
+    std::shared_ptr<VulkanPipeline> _pipeline;
+    PFN_vkCmdPushDescriptorSetKHR _vkCmdPushDescriptorSetKHR = nullptr;
+};
@@ -0,0 +1,223 @@
+#include "PipelineCache.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    const char kMagic[8] = { 'P', 'I', 'P', 'E', 'C', 'A', 'C', 'H' };
+
+    struct PipelineCacheFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+        uint64_t dataHash;
+    };
+
+    // FNV-1a，只用于发现截断或损坏的文件
+    uint64_t hashBytes(const uint8_t* data, size_t size) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= data[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+}
+
+PipelineCache::PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path)
+    : _device(device), _path(path) {
+    vkGetPhysicalDeviceProperties(physicalDevice, &_properties);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uint8_t> initialData;
+    if (load(initialData)) {
+        _loaded = true;
+        _loadedSize = initialData.size();
+        _loadedHash = hashBytes(initialData.data(), initialData.size());
+    } else {
+        initialData.clear();
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = initialData.size();
+    createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+    VkResult result = vkCreatePipelineCache(_device, &createInfo, nullptr, &_cache);
+    if (result != VK_SUCCESS && !initialData.empty()) {
+        // 驱动拒绝了数据（理论上已被上面的检查排除），退回空缓存
+        std::cerr << "[WARNING] driver rejected pipeline cache " << _path << ", starting empty" << std::endl;
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        _loaded = false;
+        _loadedSize = 0;
+        result = vkCreatePipelineCache(_device, &createInfo, nullptr, &_cache);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    if (_loaded) {
+        std::cout << "[SUCCESS] Pipeline cache loaded: " << _loadedSize << " bytes in "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    }
+}
+
+PipelineCache::~PipelineCache() {
+    save();
+    for (VkPipelineCache cache : _threadCaches) {
+        vkDestroyPipelineCache(_device, cache, nullptr);
+    }
+    vkDestroyPipelineCache(_device, _cache, nullptr);
+}
+
+bool PipelineCache::load(std::vector<uint8_t>& data) const {
+    std::error_code ec;
+    if (!std::filesystem::exists(_path, ec)) {
+        std::cout << "[INFO] no pipeline cache at " << _path << ", pipelines will be compiled from SPIR-V" << std::endl;
+        return false;
+    }
+
+    std::ifstream in(_path, std::ios::binary);
+    PipelineCacheFileHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        std::cerr << "[WARNING] pipeline cache " << _path << " is truncated, ignoring it" << std::endl;
+        return false;
+    }
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        std::cerr << "[WARNING] pipeline cache " << _path << " has an unknown format, ignoring it" << std::endl;
+        return false;
+    }
+    if (header.vendorID != _properties.vendorID || header.deviceID != _properties.deviceID
+        || header.driverVersion != _properties.driverVersion
+        || memcmp(header.pipelineCacheUUID, _properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        std::cout << "[INFO] pipeline cache " << _path << " was written by another device or driver, ignoring it" << std::endl;
+        return false;
+    }
+
+    uint64_t fileSize = std::filesystem::file_size(_path, ec);
+    if (ec || header.dataSize != fileSize - sizeof(header)) {
+        std::cerr << "[WARNING] pipeline cache " << _path << " is truncated, ignoring it" << std::endl;
+        return false;
+    }
+    data.resize(static_cast<size_t>(header.dataSize));
+    if (!in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))
+        || hashBytes(data.data(), data.size()) != header.dataHash) {
+        std::cerr << "[WARNING] pipeline cache " << _path << " is corrupted, ignoring it" << std::endl;
+        return false;
+    }
+    if (!isCompatible(data.data(), data.size())) {
+        std::cout << "[INFO] pipeline cache " << _path << " is not compatible with this device, ignoring it" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool PipelineCache::isCompatible(const uint8_t* data, size_t size) const {
+    // 驱动数据以 VkPipelineCacheHeaderVersionOne 开头，headerSize 可能大于结构体本身
+    VkPipelineCacheHeaderVersionOne header{};
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    return header.headerSize >= sizeof(header) && header.headerSize <= size
+        && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && header.vendorID == _properties.vendorID
+        && header.deviceID == _properties.deviceID
+        && memcmp(header.pipelineCacheUUID, _properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+std::vector<uint8_t> PipelineCache::getData() const {
+    // 两次调用之间缓存可能被其它线程写入而变大，VK_INCOMPLETE 时重新查询大小
+    std::vector<uint8_t> data;
+    VkResult result;
+    do {
+        size_t size = 0;
+        if (vkGetPipelineCacheData(_device, _cache, &size, nullptr) != VK_SUCCESS) {
+            throw std::runtime_error("failed to query pipeline cache size!");
+        }
+        data.resize(size);
+        result = vkGetPipelineCacheData(_device, _cache, &size, data.data());
+        data.resize(size);
+    } while (result == VK_INCOMPLETE);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to read pipeline cache data!");
+    }
+    return data;
+}
+
+VkPipelineCache PipelineCache::createThreadCache() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // 以主缓存当前内容为初始数据，工作线程也能命中磁盘缓存
+    std::vector<uint8_t> data = getData();
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    VkPipelineCache cache;
+    if (vkCreatePipelineCache(_device, &createInfo, nullptr, &cache) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create thread pipeline cache!");
+    }
+    _threadCaches.push_back(cache);
+    return cache;
+}
+
+void PipelineCache::mergeThreadCaches() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_threadCaches.empty()) return;
+    if (vkMergePipelineCaches(_device, _cache, static_cast<uint32_t>(_threadCaches.size()), _threadCaches.data()) != VK_SUCCESS) {
+        std::cerr << "[WARNING] failed to merge " << _threadCaches.size() << " thread pipeline caches" << std::endl;
+    }
+    for (VkPipelineCache cache : _threadCaches) {
+        vkDestroyPipelineCache(_device, cache, nullptr);
+    }
+    _threadCaches.clear();
+}
+
+void PipelineCache::save() {
+    try {
+        mergeThreadCaches();
+        std::vector<uint8_t> data = getData();
+        if (data.empty() || !isCompatible(data.data(), data.size())) return;
+
+        uint64_t hash = hashBytes(data.data(), data.size());
+        if (data.size() == _loadedSize && hash == _loadedHash) return;
+
+        PipelineCacheFileHeader header{};
+        memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.vendorID = _properties.vendorID;
+        header.deviceID = _properties.deviceID;
+        header.driverVersion = _properties.driverVersion;
+        memcpy(header.pipelineCacheUUID, _properties.pipelineCacheUUID, VK_UUID_SIZE);
+        header.dataSize = data.size();
+        header.dataHash = hash;
+
+        // 先写临时文件，完整写完再替换，避免下次启动读到截断的缓存
+        std::string tempPath = _path + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("failed to create " + tempPath);
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!out) {
+                throw std::runtime_error("failed to write " + tempPath);
+            }
+        }
+        std::filesystem::rename(tempPath, _path);
+
+        _loadedSize = data.size();
+        _loadedHash = hash;
+        std::cout << "[SUCCESS] Pipeline cache saved: " << data.size() << " bytes to " << _path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[WARNING] failed to save pipeline cache " << _path << ": " << e.what() << std::endl;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * @class PipelineCache
+ * @brief 持久化到磁盘的 VkPipelineCache，由 VulkanContext 持有，所有管线创建共用。
+ *
+ * 文件布局：PipelineCacheFileHeader | 驱动返回的缓存数据。
+ * 加载时检查：
+ * - 文件头的魔数、版本、数据长度与内容哈希（防止截断或损坏的文件交给驱动）；
+ * - 文件头记录的 vendorID / deviceID / driverVersion 与当前设备一致（换显卡或升级驱动后旧缓存直接丢弃）；
+ * - 驱动数据自身的 VkPipelineCacheHeaderVersionOne 与当前设备的 vendorID / deviceID / pipelineCacheUUID 一致。
+ * 任何一项不通过都从空缓存开始，不会报错。
+ *
+ * 工作线程可以用 createThreadCache() 取得独立的缓存（以主缓存当前内容为初始数据），
+ * 避免多个线程在同一个缓存上争用驱动内部的锁；save() 时先用 vkMergePipelineCaches 并回主缓存。
+ * 析构时自动 save()：先写临时文件再改名，中途失败不会留下半个文件；内容与加载时相同则跳过写入。
+ */
+class PipelineCache {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path = "pipeline.cache");
+    ~PipelineCache();
+
+    // 禁止拷贝
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    // 传给 vkCreate*Pipelines 的主缓存；驱动保证对它的并发访问是安全的
+    VkPipelineCache get() const { return _cache; }
+    // 加载到的磁盘缓存是否有效
+    bool wasLoaded() const { return _loaded; }
+
+    // 为一个工作线程创建缓存，生命周期由 PipelineCache 管理，save() 合并后销毁，调用方此后不能再使用
+    VkPipelineCache createThreadCache();
+    // 把所有线程缓存并入主缓存并销毁它们。主缓存作为合并目标需要外部同步：不能与使用主缓存的管线创建并发执行
+    void mergeThreadCaches();
+
+    // 合并线程缓存后写回磁盘。失败只打印警告，不抛出异常
+    void save();
+
+private:
+    bool load(std::vector<uint8_t>& data) const;
+    bool isCompatible(const uint8_t* data, size_t size) const;
+    std::vector<uint8_t> getData() const;
+
+    VkDevice _device;
+    VkPhysicalDeviceProperties _properties{};
+    std::string _path;
+    VkPipelineCache _cache = VK_NULL_HANDLE;
+
+    std::mutex _mutex;                          // 保护线程缓存列表与合并操作
+    std::vector<VkPipelineCache> _threadCaches;
+    bool _loaded = false;
+    size_t _loadedSize = 0;     // 上次加载/写入的数据，内容未变化时 save() 跳过写入
+    uint64_t _loadedHash = 0;
+};
@@ -0,0 +1,164 @@
+#include "PipelineRegistry.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+PipelineRegistry::PipelineRegistry(VulkanContext& context) : _context(context) {}
+
+PipelineRegistry::~PipelineRegistry() {
+    // 管线先于它们共享的布局销毁
+    for (const auto& [key, pipeline] : _pipelines) {
+        if (pipeline.use_count() > 1) {
+            std::cerr << "[WARNING] pipeline registry destroyed while a pipeline is still referenced" << std::endl;
+            break;
+        }
+    }
+    _pipelines.clear();
+    for (const auto& [key, layout] : _layouts) {
+        vkDestroyPipelineLayout(_context.getDevice(), layout, nullptr);
+    }
+    for (const auto& [key, setLayout] : _setLayouts) {
+        vkDestroyDescriptorSetLayout(_context.getDevice(), setLayout, nullptr);
+    }
+}
+
+std::shared_ptr<VulkanPipeline> PipelineRegistry::getGraphicsPipeline(PipelineBuilder& builder) {
+    std::string key = builder.getStateKey();
+    auto it = _pipelines.find(key);
+    if (it != _pipelines.end()) {
+        _hits++;
+        return it->second;
+    }
+
+    _misses++;
+    // 调用方已指定外部布局时沿用它，否则使用共享布局
+    if (builder.getPipelineLayout() == VK_NULL_HANDLE) {
+        builder.setPipelineLayout(getPipelineLayout(builder.getDescriptorSetLayouts(), builder.getPushConstantRanges()));
+    }
+    std::shared_ptr<VulkanPipeline> pipeline = builder.buildGraphicsPipeline();
+    _pipelines.emplace(std::move(key), pipeline);
+    return pipeline;
+}
+
+std::shared_ptr<VulkanPipeline> PipelineRegistry::getComputePipeline(const std::string& shaderPath, VkDescriptorSetLayout setLayout,
+    std::span<const VkPushConstantRange> pushConstantRanges, const SpecializationConstants& specialization, const char* entryPoint) {
+    // 按路径区分着色器：运行期间不会替换磁盘上的 SPIR-V，命中时也就不必读文件
+    std::string key = "compute|" + shaderPath + "|" + entryPoint + "|";
+    key.append(reinterpret_cast<const char*>(&setLayout), sizeof(setLayout));
+    key.append(reinterpret_cast<const char*>(pushConstantRanges.data()), pushConstantRanges.size_bytes());
+    key.push_back('|');
+    specialization.appendKey(key);
+
+    auto it = _pipelines.find(key);
+    if (it != _pipelines.end()) {
+        _hits++;
+        return it->second;
+    }
+
+    _misses++;
+    PipelineBuilder builder(_context);
+    for (const VkPushConstantRange& range : pushConstantRanges) {
+        builder.addPushConstantRange(range);
+    }
+    builder.setPipelineLayout(getPipelineLayout(std::span<const VkDescriptorSetLayout>(&setLayout, 1), pushConstantRanges));
+    std::shared_ptr<VulkanPipeline> pipeline = builder.buildComputePipeline(shaderPath, setLayout, entryPoint, specialization);
+    _pipelines.emplace(std::move(key), pipeline);
+    return pipeline;
+}
+
+VkPipelineLayout PipelineRegistry::getPipelineLayout(std::span<const VkDescriptorSetLayout> setLayouts,
+    std::span<const VkPushConstantRange> pushConstantRanges) {
+    std::string key;
+    key.append(reinterpret_cast<const char*>(setLayouts.data()), setLayouts.size_bytes());
+    key.push_back('|');
+    key.append(reinterpret_cast<const char*>(pushConstantRanges.data()), pushConstantRanges.size_bytes());
+
+    auto it = _layouts.find(key);
+    if (it != _layouts.end()) {
+        _layoutHits++;
+        return it->second;
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+    VkPipelineLayout layout;
+    if (vkCreatePipelineLayout(_context.getDevice(), &pipelineLayoutInfo, nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline layout!");
+    }
+    _layoutMisses++;
+    _layouts.emplace(std::move(key), layout);
+    return layout;
+}
+
+VkDescriptorSetLayout PipelineRegistry::getDescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings,
+    VkDescriptorSetLayoutCreateFlags flags) {
+    // 按 binding 排序后逐字段生成键（结构体中的指针与填充不参与比较）
+    std::vector<VkDescriptorSetLayoutBinding> sorted(bindings.begin(), bindings.end());
+    std::sort(sorted.begin(), sorted.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+        return a.binding < b.binding;
+    });
+    std::string key(reinterpret_cast<const char*>(&flags), sizeof(flags));
+    for (const VkDescriptorSetLayoutBinding& binding : sorted) {
+        if (binding.pImmutableSamplers != nullptr) {
+            throw std::runtime_error("shared descriptor set layouts do not support immutable samplers!");
+        }
+        const uint32_t fields[] = { binding.binding, static_cast<uint32_t>(binding.descriptorType),
+            binding.descriptorCount, binding.stageFlags };
+        key.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+    }
+
+    auto it = _setLayouts.find(key);
+    if (it != _setLayouts.end()) {
+        return it->second;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.flags = flags;
+    layoutInfo.bindingCount = static_cast<uint32_t>(sorted.size());
+    layoutInfo.pBindings = sorted.data();
+
+    VkDescriptorSetLayout setLayout;
+    if (vkCreateDescriptorSetLayout(_context.getDevice(), &layoutInfo, nullptr, &setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create descriptor set layout!");
+    }
+    _setLayouts.emplace(std::move(key), setLayout);
+    return setLayout;
+}
+
+uint32_t PipelineRegistry::releaseUnused() {
+    uint32_t released = 0;
+    for (auto it = _pipelines.begin(); it != _pipelines.end();) {
+        if (it->second.use_count() == 1) {
+            it = _pipelines.erase(it);
+            released++;
+        } else {
+            ++it;
+        }
+    }
+    return released;
+}
+
+PipelineRegistry::Stats PipelineRegistry::getStats() const {
+    Stats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.layoutHits = _layoutHits;
+    stats.layoutMisses = _layoutMisses;
+    stats.livePipelines = static_cast<uint32_t>(_pipelines.size());
+    stats.liveLayouts = static_cast<uint32_t>(_layouts.size());
+    stats.liveSetLayouts = static_cast<uint32_t>(_setLayouts.size());
+    return stats;
+}
+
+void PipelineRegistry::printStats() const {
+    std::cout << "[INFO] pipeline registry: " << _hits << " hits, " << _misses << " misses, "
+              << _pipelines.size() << " live pipelines, " << _layouts.size() << " layouts ("
+              << _layoutHits << " layout hits), " << _setLayouts.size() << " descriptor set layouts" << std::endl;
+}
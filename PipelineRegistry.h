@@ -0,0 +1,74 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanPipeline.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+/*
+ * @class PipelineRegistry
+ * @brief 按完整状态去重的图形管线表。
+ *
+ * 以 PipelineBuilder::getStateKey() 为键（着色器 SPIR-V 哈希、顶点输入、光栅化、混合、深度、渲染格式、
+ * 描述符集布局与推送常量），状态相同的请求返回同一个 std::shared_ptr<VulkanPipeline>，不会重复创建。
+ * 管线布局按（描述符集布局, 推送常量）同样去重，由注册表持有，所有使用它的管线共享。
+ * 计算管线按着色器路径、入口与特化常量去重，每种常量组合是一个单独缓存的变体。
+ * 描述符集布局按绑定内容去重（PipelineBuilder::reflectLayout 从着色器反射出的布局都从这里取得），
+ * 绑定相同的 set 在所有管线中是同一个句柄，切换管线后已绑定的描述符集仍然兼容，不需要重新绑定。
+ *
+ * 注册表对管线持有强引用；releaseUnused() 释放只剩注册表引用的管线，调用方须确保 GPU 已不再使用它们。
+ * 非线程安全，应在同一个线程中调用。
+ */
+class PipelineRegistry {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t layoutHits = 0;
+        uint64_t layoutMisses = 0;
+        uint32_t livePipelines = 0;
+        uint32_t liveLayouts = 0;
+        uint32_t liveSetLayouts = 0;
+    };
+
+    explicit PipelineRegistry(VulkanContext& context);
+    ~PipelineRegistry();
+
+    // 禁止拷贝
+    PipelineRegistry(const PipelineRegistry&) = delete;
+    PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+    // 命中时 builder 不会被使用；未命中时使用共享布局构建。builder 之后不应再用于构建
+    std::shared_ptr<VulkanPipeline> getGraphicsPipeline(PipelineBuilder& builder);
+
+    // 计算管线按（着色器路径、入口、特化常量、描述符集布局、推送常量）去重，每种特化常量组合是一个缓存的变体
+    std::shared_ptr<VulkanPipeline> getComputePipeline(const std::string& shaderPath, VkDescriptorSetLayout setLayout,
+        std::span<const VkPushConstantRange> pushConstantRanges = {}, const SpecializationConstants& specialization = {},
+        const char* entryPoint = "main");
+
+    // 返回共享的管线布局，生命周期与注册表相同
+    VkPipelineLayout getPipelineLayout(std::span<const VkDescriptorSetLayout> setLayouts,
+        std::span<const VkPushConstantRange> pushConstantRanges = {});
+
+    // 返回共享的描述符集布局（绑定顺序无关，不支持不可变采样器），生命周期与注册表相同
+    VkDescriptorSetLayout getDescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings,
+        VkDescriptorSetLayoutCreateFlags flags = 0);
+
+    // 释放没有外部引用的管线，返回释放的数量（布局保留，直到注册表销毁）
+    uint32_t releaseUnused();
+
+    Stats getStats() const;
+    void printStats() const;
+
+private:
+    VulkanContext& _context;
+    std::unordered_map<std::string, std::shared_ptr<VulkanPipeline>> _pipelines;
+    std::unordered_map<std::string, VkPipelineLayout> _layouts;
+    std::unordered_map<std::string, VkDescriptorSetLayout> _setLayouts;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _layoutHits = 0;
+    uint64_t _layoutMisses = 0;
+};
@@ -1,6 +1,7 @@
 #include "Renderer.h"
 #include "VulkanContext.h"
 #include <stdexcept>
+#include <algorithm>
 
 Renderer::Renderer(VulkanContext& context, uint32_t maxFramesInFlight)
     : _context(context), _maxFramesInFlight(maxFramesInFlight) {
@@ -78,11 +79,24 @@ void Renderer::endFrame(VulkanSwapchain& swapchain,VkQueue graphicsQueue,VkQueue
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     
-    VkSemaphore waitSemaphores[] = {_imageAvailableSemaphores[_currentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    // 二值信号量 imageAvailable 之后追加时间线等待，二值信号量对应的值会被忽略
+    std::vector<VkSemaphore> waitSemaphores = {_imageAvailableSemaphores[_currentFrame]};
+    std::vector<VkPipelineStageFlags> waitStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    std::vector<uint64_t> waitValues = {0};
+    waitSemaphores.insert(waitSemaphores.end(), _extraWaitSemaphores.begin(), _extraWaitSemaphores.end());
+    waitStages.insert(waitStages.end(), _extraWaitStages.begin(), _extraWaitStages.end());
+    waitValues.insert(waitValues.end(), _extraWaitValues.begin(), _extraWaitValues.end());
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    if (!_extraWaitSemaphores.empty()) {
+        timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        submitInfo.pNext = &timelineInfo;
+    }
     
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
@@ -94,6 +108,9 @@ void Renderer::endFrame(VulkanSwapchain& swapchain,VkQueue graphicsQueue,VkQueue
     if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, _inFlightFences[_currentFrame]) != VK_SUCCESS) {
         throw std::runtime_error("failed to submit draw command buffer!");
     }
+    _extraWaitSemaphores.clear();
+    _extraWaitValues.clear();
+    _extraWaitStages.clear();
 
     VkResult result = swapchain.present(presentQueue, _renderFinishedSemaphores[_currentFrame], _imageIndex);
     
@@ -104,4 +121,18 @@ void Renderer::endFrame(VulkanSwapchain& swapchain,VkQueue graphicsQueue,VkQueue
     }
     
     _currentFrame = (_currentFrame + 1) % _maxFramesInFlight;
-}
\ No newline at end of file
+}
+
+void Renderer::addWaitSemaphore(VkSemaphore timelineSemaphore, uint64_t value, VkPipelineStageFlags stage) {
+    // 同一个信号量只保留一项，取最大的值、合并等待阶段
+    for (size_t i = 0; i < _extraWaitSemaphores.size(); ++i) {
+        if (_extraWaitSemaphores[i] == timelineSemaphore) {
+            _extraWaitValues[i] = std::max(_extraWaitValues[i], value);
+            _extraWaitStages[i] |= stage;
+            return;
+        }
+    }
+    _extraWaitSemaphores.push_back(timelineSemaphore);
+    _extraWaitValues.push_back(value);
+    _extraWaitStages.push_back(stage);
+}
@@ -19,6 +19,10 @@ public:
     // 结束一帧的渲染并提交
     void endFrame(VulkanSwapchain& swapchain,VkQueue graphicsQueue,VkQueue presentQueue);
 
+    // 让本帧的提交在 GPU 上等待一个时间线信号量到达 value（例如 AsyncUploader 的上传），
+    // 只对下一次 endFrame 生效
+    void addWaitSemaphore(VkSemaphore timelineSemaphore, uint64_t value, VkPipelineStageFlags stage);
+
 private:
     VulkanContext& _context;
     uint32_t _maxFramesInFlight;
@@ -30,4 +34,8 @@ private:
     std::vector<VkSemaphore> _imageAvailableSemaphores;
     std::vector<VkSemaphore> _renderFinishedSemaphores;
     std::vector<VkFence> _inFlightFences;
+
+    std::vector<VkSemaphore> _extraWaitSemaphores;
+    std::vector<uint64_t> _extraWaitValues;
+    std::vector<VkPipelineStageFlags> _extraWaitStages;
 };
\ No newline at end of file
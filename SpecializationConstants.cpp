@@ -0,0 +1,59 @@
+#include "SpecializationConstants.h"
+#include <algorithm>
+#include <cstring>
+
+SpecializationConstants& SpecializationConstants::set(uint32_t constantId, bool value) {
+    setRaw(constantId, value ? VK_TRUE : VK_FALSE);
+    return *this;
+}
+
+SpecializationConstants& SpecializationConstants::set(uint32_t constantId, int32_t value) {
+    setRaw(constantId, static_cast<uint32_t>(value));
+    return *this;
+}
+
+SpecializationConstants& SpecializationConstants::set(uint32_t constantId, uint32_t value) {
+    setRaw(constantId, value);
+    return *this;
+}
+
+SpecializationConstants& SpecializationConstants::set(uint32_t constantId, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    setRaw(constantId, bits);
+    return *this;
+}
+
+void SpecializationConstants::setRaw(uint32_t constantId, uint32_t bits) {
+    auto it = std::lower_bound(_entries.begin(), _entries.end(), constantId,
+        [](const VkSpecializationMapEntry& entry, uint32_t id) { return entry.constantID < id; });
+    if (it != _entries.end() && it->constantID == constantId) {
+        _data[it->offset / sizeof(uint32_t)] = bits;
+        return;
+    }
+    // 新值追加在 _data 末尾，条目本身保持有序
+    VkSpecializationMapEntry entry{};
+    entry.constantID = constantId;
+    entry.offset = static_cast<uint32_t>(_data.size() * sizeof(uint32_t));
+    entry.size = sizeof(uint32_t);
+    _entries.insert(it, entry);
+    _data.push_back(bits);
+}
+
+VkSpecializationInfo SpecializationConstants::getInfo() const {
+    VkSpecializationInfo info{};
+    info.mapEntryCount = static_cast<uint32_t>(_entries.size());
+    info.pMapEntries = _entries.data();
+    info.dataSize = _data.size() * sizeof(uint32_t);
+    info.pData = _data.data();
+    return info;
+}
+
+void SpecializationConstants::appendKey(std::string& key) const {
+    const uint32_t count = static_cast<uint32_t>(_entries.size());
+    key.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const VkSpecializationMapEntry& entry : _entries) {
+        const uint32_t pair[2] = { entry.constantID, _data[entry.offset / sizeof(uint32_t)] };
+        key.append(reinterpret_cast<const char*>(pair), sizeof(pair));
+    }
+}
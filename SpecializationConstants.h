@@ -0,0 +1,37 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * @class SpecializationConstants
+ * @brief 一个着色器阶段的特化常量表（constant_id -> 值），在创建管线时写入，驱动据此把常量折叠进机器码。
+ *
+ * 只支持 32 位类型：bool（按 VkBool32 写入）、int32_t、uint32_t、float，须与着色器中声明的类型一致。
+ * 条目按 constant_id 排序保存，同一 id 重复设置时覆盖旧值，因此设置顺序不影响 appendKey() 的结果，
+ * 相同的常量组合在 PipelineRegistry 中总是命中同一个管线变体。
+ *
+ * 典型用途：工作组大小（GLSL 的 local_size_x_id）、循环次数与功能开关，代替运行时的 uniform 分支。
+ */
+class SpecializationConstants {
+public:
+    SpecializationConstants& set(uint32_t constantId, bool value);
+    SpecializationConstants& set(uint32_t constantId, int32_t value);
+    SpecializationConstants& set(uint32_t constantId, uint32_t value);
+    SpecializationConstants& set(uint32_t constantId, float value);
+
+    bool empty() const { return _entries.empty(); }
+
+    // 返回的结构指向本对象内部的数组，本对象修改或销毁后失效
+    VkSpecializationInfo getInfo() const;
+
+    // 把 (constant_id, 值) 序列追加到管线状态键中
+    void appendKey(std::string& key) const;
+
+private:
+    void setRaw(uint32_t constantId, uint32_t bits);
+
+    std::vector<VkSpecializationMapEntry> _entries;     // 按 constantID 排序，offset 指向 _data
+    std::vector<uint32_t> _data;
+};
@@ -0,0 +1,490 @@
+#include "SpirvReflection.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    // 只列出用到的 SPIR-V 常量（见 SPIR-V 规范第 3 章）
+    constexpr uint32_t kSpirvMagic = 0x07230203;
+
+    constexpr uint32_t OpName = 5;
+    constexpr uint32_t OpEntryPoint = 15;
+    constexpr uint32_t OpTypeBool = 20;
+    constexpr uint32_t OpTypeInt = 21;
+    constexpr uint32_t OpTypeFloat = 22;
+    constexpr uint32_t OpTypeVector = 23;
+    constexpr uint32_t OpTypeMatrix = 24;
+    constexpr uint32_t OpTypeImage = 25;
+    constexpr uint32_t OpTypeSampler = 26;
+    constexpr uint32_t OpTypeSampledImage = 27;
+    constexpr uint32_t OpTypeArray = 28;
+    constexpr uint32_t OpTypeRuntimeArray = 29;
+    constexpr uint32_t OpTypeStruct = 30;
+    constexpr uint32_t OpTypePointer = 32;
+    constexpr uint32_t OpConstant = 43;
+    constexpr uint32_t OpVariable = 59;
+    constexpr uint32_t OpDecorate = 71;
+    constexpr uint32_t OpMemberDecorate = 72;
+
+    constexpr uint32_t DecorationBlock = 2;
+    constexpr uint32_t DecorationBufferBlock = 3;
+    constexpr uint32_t DecorationArrayStride = 6;
+    constexpr uint32_t DecorationMatrixStride = 7;
+    constexpr uint32_t DecorationBuiltIn = 11;
+    constexpr uint32_t DecorationLocation = 30;
+    constexpr uint32_t DecorationBinding = 33;
+    constexpr uint32_t DecorationDescriptorSet = 34;
+    constexpr uint32_t DecorationOffset = 35;
+
+    constexpr uint32_t StorageClassUniformConstant = 0;
+    constexpr uint32_t StorageClassInput = 1;
+    constexpr uint32_t StorageClassUniform = 2;
+    constexpr uint32_t StorageClassPushConstant = 9;
+    constexpr uint32_t StorageClassStorageBuffer = 12;
+
+    constexpr uint32_t ExecutionModelVertex = 0;
+    constexpr uint32_t ExecutionModelTessellationControl = 1;
+    constexpr uint32_t ExecutionModelTessellationEvaluation = 2;
+    constexpr uint32_t ExecutionModelGeometry = 3;
+    constexpr uint32_t ExecutionModelFragment = 4;
+    constexpr uint32_t ExecutionModelGLCompute = 5;
+    constexpr uint32_t ExecutionModelTaskEXT = 5364;
+    constexpr uint32_t ExecutionModelMeshEXT = 5365;
+
+    constexpr uint32_t DimBuffer = 5;
+    constexpr uint32_t DimSubpassData = 6;
+
+    constexpr uint32_t kUnset = ~0u;
+
+    struct Decorations {
+        uint32_t set = kUnset;
+        uint32_t binding = kUnset;
+        uint32_t location = kUnset;
+        uint32_t arrayStride = 0;
+        bool builtIn = false;
+        bool block = false;
+        bool bufferBlock = false;
+    };
+
+    struct MemberDecorations {
+        uint32_t offset = 0;
+        uint32_t matrixStride = 0;
+    };
+
+    struct Variable {
+        uint32_t id;
+        uint32_t pointerType;
+        uint32_t storageClass;
+    };
+
+    // 第一遍收集所有声明，装饰可能出现在类型之前，所以解析放在第二步
+    class Module {
+    public:
+        explicit Module(const std::vector<char>& code) {
+            if (code.size() < 5 * sizeof(uint32_t) || code.size() % sizeof(uint32_t) != 0) {
+                throw std::runtime_error("invalid SPIR-V: size is not a multiple of 4!");
+            }
+            _words.resize(code.size() / sizeof(uint32_t));
+            memcpy(_words.data(), code.data(), code.size());
+            if (_words[0] != kSpirvMagic) {
+                throw std::runtime_error("invalid SPIR-V: bad magic number!");
+            }
+
+            size_t i = 5;
+            while (i < _words.size()) {
+                const uint32_t opcode = _words[i] & 0xFFFF;
+                const uint32_t wordCount = _words[i] >> 16;
+                if (wordCount == 0 || i + wordCount > _words.size()) {
+                    throw std::runtime_error("invalid SPIR-V: truncated instruction!");
+                }
+                const uint32_t* ins = &_words[i];
+                switch (opcode) {
+                case OpName:
+                    _names[ins[1]] = readString(ins + 2, wordCount - 2);
+                    break;
+                case OpDecorate:
+                    decorate(_decorations[ins[1]], ins[2], wordCount > 3 ? ins[3] : 0);
+                    break;
+                case OpMemberDecorate: {
+                    auto& members = _memberDecorations[ins[1]];
+                    if (members.size() <= ins[2]) members.resize(ins[2] + 1);
+                    if (ins[3] == DecorationOffset) members[ins[2]].offset = ins[4];
+                    if (ins[3] == DecorationMatrixStride) members[ins[2]].matrixStride = ins[4];
+                    break;
+                }
+                case OpTypeBool: case OpTypeInt: case OpTypeFloat: case OpTypeVector: case OpTypeMatrix:
+                case OpTypeImage: case OpTypeSampler: case OpTypeSampledImage: case OpTypeArray:
+                case OpTypeRuntimeArray: case OpTypeStruct: case OpTypePointer:
+                    _types[ins[1]] = ins;
+                    break;
+                case OpConstant:
+                    _constants[ins[2]] = ins[3];
+                    break;
+                case OpVariable:
+                    _variables.push_back({ins[2], ins[1], ins[3]});
+                    break;
+                default:
+                    break;
+                }
+                i += wordCount;
+            }
+        }
+
+        const std::vector<Variable>& getVariables() const { return _variables; }
+
+        const uint32_t* getType(uint32_t id) const {
+            auto it = _types.find(id);
+            if (it == _types.end()) {
+                throw std::runtime_error("invalid SPIR-V: undefined type id " + std::to_string(id) + "!");
+            }
+            return it->second;
+        }
+
+        Decorations getDecorations(uint32_t id) const {
+            auto it = _decorations.find(id);
+            return it != _decorations.end() ? it->second : Decorations{};
+        }
+
+        std::string getName(uint32_t id) const {
+            auto it = _names.find(id);
+            return it != _names.end() ? it->second : "%" + std::to_string(id);
+        }
+
+        uint32_t getArrayLength(const uint32_t* arrayType) const {
+            auto it = _constants.find(arrayType[3]);
+            if (it == _constants.end()) {
+                throw std::runtime_error("array length is not a constant (specialization constants are not supported by reflection)!");
+            }
+            return it->second;
+        }
+
+        // 类型在缓冲区中占用的字节数（std140/std430 的偏移与步长来自装饰）
+        uint32_t getSize(uint32_t typeId, uint32_t matrixStride = 0) const {
+            const uint32_t* type = getType(typeId);
+            switch (type[0] & 0xFFFF) {
+            case OpTypeBool:
+                return 4;
+            case OpTypeInt:
+            case OpTypeFloat:
+                return type[2] / 8;
+            case OpTypeVector:
+                return type[3] * getSize(type[2]);
+            case OpTypeMatrix:
+                return type[3] * (matrixStride ? matrixStride : getSize(type[2]));
+            case OpTypeArray: {
+                uint32_t stride = getDecorations(typeId).arrayStride;
+                return getArrayLength(type) * (stride ? stride : getSize(type[2]));
+            }
+            case OpTypeStruct: {
+                const uint32_t memberCount = (type[0] >> 16) - 2;
+                auto it = _memberDecorations.find(typeId);
+                uint32_t size = 0;
+                for (uint32_t m = 0; m < memberCount; ++m) {
+                    MemberDecorations member{};
+                    if (it != _memberDecorations.end() && m < it->second.size()) member = it->second[m];
+                    size = std::max(size, member.offset + getSize(type[2 + m], member.matrixStride));
+                }
+                return size;
+            }
+            default:
+                // 不定长数组只能是存储缓冲区的最后一个成员，推送常量中不会出现
+                throw std::runtime_error("unsupported type in push constant block!");
+            }
+        }
+
+    private:
+        static void decorate(Decorations& d, uint32_t decoration, uint32_t value) {
+            switch (decoration) {
+            case DecorationBlock: d.block = true; break;
+            case DecorationBufferBlock: d.bufferBlock = true; break;
+            case DecorationArrayStride: d.arrayStride = value; break;
+            case DecorationBuiltIn: d.builtIn = true; break;
+            case DecorationLocation: d.location = value; break;
+            case DecorationBinding: d.binding = value; break;
+            case DecorationDescriptorSet: d.set = value; break;
+            default: break;
+            }
+        }
+
+        static std::string readString(const uint32_t* words, uint32_t wordCount) {
+            const char* chars = reinterpret_cast<const char*>(words);
+            return std::string(chars, strnlen(chars, wordCount * sizeof(uint32_t)));
+        }
+
+        std::vector<uint32_t> _words;
+        std::unordered_map<uint32_t, const uint32_t*> _types;   // 指向 _words 中的指令
+        std::unordered_map<uint32_t, Decorations> _decorations;
+        std::unordered_map<uint32_t, std::vector<MemberDecorations>> _memberDecorations;
+        std::unordered_map<uint32_t, uint32_t> _constants;
+        std::unordered_map<uint32_t, std::string> _names;
+        std::vector<Variable> _variables;
+    };
+
+    VkDescriptorType getDescriptorType(const Module& module, uint32_t storageClass, uint32_t typeId) {
+        const uint32_t* type = module.getType(typeId);
+        const uint32_t opcode = type[0] & 0xFFFF;
+        if (storageClass == StorageClassStorageBuffer) {
+            return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        }
+        if (storageClass == StorageClassUniform) {
+            // 旧版 SPIR-V（1.3 之前）用 Uniform + BufferBlock 表示存储缓冲区
+            return module.getDecorations(typeId).bufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        }
+        switch (opcode) {
+        case OpTypeSampler:
+            return VK_DESCRIPTOR_TYPE_SAMPLER;
+        case OpTypeSampledImage:
+            return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        case OpTypeImage: {
+            // OpTypeImage: result, sampled type, Dim, Depth, Arrayed, MS, Sampled, Format
+            const uint32_t dim = type[3];
+            const bool storage = type[7] == 2;
+            if (dim == DimSubpassData) return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            if (dim == DimBuffer) return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+            return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        }
+        default:
+            throw std::runtime_error("unsupported descriptor type (opcode " + std::to_string(opcode) + ")!");
+        }
+    }
+
+    VkShaderStageFlagBits getStage(uint32_t executionModel) {
+        switch (executionModel) {
+        case ExecutionModelVertex: return VK_SHADER_STAGE_VERTEX_BIT;
+        case ExecutionModelTessellationControl: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        case ExecutionModelTessellationEvaluation: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        case ExecutionModelGeometry: return VK_SHADER_STAGE_GEOMETRY_BIT;
+        case ExecutionModelFragment: return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case ExecutionModelGLCompute: return VK_SHADER_STAGE_COMPUTE_BIT;
+        case ExecutionModelTaskEXT: return VK_SHADER_STAGE_TASK_BIT_EXT;
+        case ExecutionModelMeshEXT: return VK_SHADER_STAGE_MESH_BIT_EXT;
+        default: return static_cast<VkShaderStageFlagBits>(0);
+        }
+    }
+
+    // 32 位与 16 位标量/向量的顶点格式，按 [分量类型][分量数 - 1] 排列
+    constexpr VkFormat kFormats32[3][4] = {
+        { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT },
+        { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT },
+        { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT },
+    };
+    constexpr VkFormat kFormats16[3][4] = {
+        { VK_FORMAT_R16_UINT, VK_FORMAT_R16G16_UINT, VK_FORMAT_R16G16B16_UINT, VK_FORMAT_R16G16B16A16_UINT },
+        { VK_FORMAT_R16_SINT, VK_FORMAT_R16G16_SINT, VK_FORMAT_R16G16B16_SINT, VK_FORMAT_R16G16B16A16_SINT },
+        { VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT },
+    };
+
+    // 标量或向量 -> 顶点格式与字节数
+    void getVertexFormat(const Module& module, uint32_t typeId, VkFormat& format, uint32_t& size) {
+        const uint32_t* type = module.getType(typeId);
+        uint32_t components = 1;
+        if ((type[0] & 0xFFFF) == OpTypeVector) {
+            components = type[3];
+            type = module.getType(type[2]);
+        }
+        const uint32_t opcode = type[0] & 0xFFFF;
+        if ((opcode != OpTypeInt && opcode != OpTypeFloat) || components < 1 || components > 4) {
+            throw std::runtime_error("unsupported vertex input type!");
+        }
+        const uint32_t width = type[2];
+        const uint32_t kind = opcode == OpTypeFloat ? 2 : (type[3] ? 1 : 0);
+        if (width == 32) {
+            format = kFormats32[kind][components - 1];
+        } else if (width == 16) {
+            format = kFormats16[kind][components - 1];
+        } else {
+            throw std::runtime_error("unsupported vertex input width " + std::to_string(width) + "!");
+        }
+        size = components * width / 8;
+    }
+}
+
+std::vector<SpirvReflection::EntryPoint> SpirvReflection::getEntryPoints(const std::vector<char>& code) {
+    if (code.size() < 5 * sizeof(uint32_t) || code.size() % sizeof(uint32_t) != 0) {
+        throw std::runtime_error("invalid SPIR-V: size is not a multiple of 4!");
+    }
+    std::vector<uint32_t> words(code.size() / sizeof(uint32_t));
+    memcpy(words.data(), code.data(), code.size());
+    if (words[0] != kSpirvMagic) {
+        throw std::runtime_error("invalid SPIR-V: bad magic number!");
+    }
+
+    std::vector<EntryPoint> entryPoints;
+    size_t i = 5;
+    while (i < words.size()) {
+        const uint32_t opcode = words[i] & 0xFFFF;
+        const uint32_t wordCount = words[i] >> 16;
+        if (wordCount == 0 || i + wordCount > words.size()) {
+            throw std::runtime_error("invalid SPIR-V: truncated instruction!");
+        }
+        if (opcode == OpEntryPoint && wordCount >= 4) {
+            // OpEntryPoint: 执行模型, 函数 id, 名字, 接口变量...
+            const char* chars = reinterpret_cast<const char*>(&words[i + 3]);
+            entryPoints.push_back({ std::string(chars, strnlen(chars, (wordCount - 3) * sizeof(uint32_t))), getStage(words[i + 1]) });
+        } else if (opcode == OpName || opcode == OpDecorate) {
+            // 入口声明在调试信息与装饰之前，到这里就不会再有了
+            break;
+        }
+        i += wordCount;
+    }
+    return entryPoints;
+}
+
+void SpirvReflection::requireEntryPoint(const std::vector<char>& code, VkShaderStageFlagBits stage, const std::string& name) {
+    const std::vector<EntryPoint> entryPoints = getEntryPoints(code);
+    for (const EntryPoint& entryPoint : entryPoints) {
+        if (entryPoint.name == name && entryPoint.stage == stage) return;
+    }
+    std::string available;
+    for (const EntryPoint& entryPoint : entryPoints) {
+        available += (available.empty() ? "" : ", ") + entryPoint.name + " (stage " + std::to_string(entryPoint.stage) + ")";
+    }
+    throw std::runtime_error("shader has no entry point " + name + " for stage " + std::to_string(stage)
+        + "; available: " + (available.empty() ? "none" : available));
+}
+
+SpirvReflection::SpirvReflection(const std::vector<char>& code, VkShaderStageFlagBits stage) {
+    Module module(code);
+
+    for (const Variable& variable : module.getVariables()) {
+        const uint32_t* pointer = module.getType(variable.pointerType);
+        const uint32_t pointee = pointer[3];
+        const Decorations decorations = module.getDecorations(variable.id);
+
+        switch (variable.storageClass) {
+        case StorageClassUniformConstant:
+        case StorageClassUniform:
+        case StorageClassStorageBuffer: {
+            if (decorations.binding == kUnset) break;
+            // 描述符数组：展开多维数组得到总数
+            uint32_t typeId = pointee;
+            uint32_t count = 1;
+            while (true) {
+                const uint32_t* type = module.getType(typeId);
+                const uint32_t opcode = type[0] & 0xFFFF;
+                if (opcode == OpTypeRuntimeArray) {
+                    throw std::runtime_error("unsized descriptor array " + module.getName(variable.id) + " is not supported by reflection!");
+                }
+                if (opcode != OpTypeArray) break;
+                count *= module.getArrayLength(type);
+                typeId = type[2];
+            }
+
+            DescriptorBinding binding;
+            binding.set = decorations.set == kUnset ? 0 : decorations.set;
+            binding.binding = decorations.binding;
+            binding.type = getDescriptorType(module, variable.storageClass, typeId);
+            binding.count = count;
+            binding.stageFlags = stage;
+            binding.name = module.getName(variable.id);
+            _bindings.push_back(std::move(binding));
+            break;
+        }
+        case StorageClassPushConstant:
+            _pushConstantSize = std::max(_pushConstantSize, module.getSize(pointee));
+            _pushConstantStages = stage;
+            break;
+        case StorageClassInput: {
+            if (stage != VK_SHADER_STAGE_VERTEX_BIT || decorations.builtIn || decorations.location == kUnset) break;
+            // 矩阵与数组每列/每个元素占一个 location
+            uint32_t typeId = pointee;
+            uint32_t slots = 1;
+            const uint32_t* type = module.getType(typeId);
+            if ((type[0] & 0xFFFF) == OpTypeArray) {
+                slots = module.getArrayLength(type);
+                typeId = type[2];
+                type = module.getType(typeId);
+            }
+            if ((type[0] & 0xFFFF) == OpTypeMatrix) {
+                slots *= type[3];
+                typeId = type[2];
+            }
+
+            VertexInput input;
+            getVertexFormat(module, typeId, input.format, input.size);
+            input.name = module.getName(variable.id);
+            for (uint32_t slot = 0; slot < slots; ++slot) {
+                input.location = decorations.location + slot;
+                _vertexInputs.push_back(input);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    std::sort(_bindings.begin(), _bindings.end(), [](const DescriptorBinding& a, const DescriptorBinding& b) {
+        return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+    });
+    std::sort(_vertexInputs.begin(), _vertexInputs.end(), [](const VertexInput& a, const VertexInput& b) {
+        return a.location < b.location;
+    });
+}
+
+void SpirvReflection::merge(const SpirvReflection& other) {
+    for (const DescriptorBinding& binding : other._bindings) {
+        auto it = std::find_if(_bindings.begin(), _bindings.end(), [&](const DescriptorBinding& b) {
+            return b.set == binding.set && b.binding == binding.binding;
+        });
+        if (it == _bindings.end()) {
+            _bindings.push_back(binding);
+            continue;
+        }
+        if (it->type != binding.type) {
+            throw std::runtime_error("descriptor (set " + std::to_string(binding.set) + ", binding " + std::to_string(binding.binding)
+                + ") has different types in different stages: " + it->name + " / " + binding.name);
+        }
+        it->count = std::max(it->count, binding.count);
+        it->stageFlags |= binding.stageFlags;
+    }
+    std::sort(_bindings.begin(), _bindings.end(), [](const DescriptorBinding& a, const DescriptorBinding& b) {
+        return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+    });
+
+    _pushConstantSize = std::max(_pushConstantSize, other._pushConstantSize);
+    _pushConstantStages |= other._pushConstantStages;
+
+    if (!other._vertexInputs.empty()) {
+        _vertexInputs = other._vertexInputs;
+    }
+}
+
+uint32_t SpirvReflection::getSetCount() const {
+    return _bindings.empty() ? 0 : _bindings.back().set + 1;
+}
+
+std::vector<VkDescriptorSetLayoutBinding> SpirvReflection::getSetLayoutBindings(uint32_t set) const {
+    std::vector<VkDescriptorSetLayoutBinding> result;
+    for (const DescriptorBinding& binding : _bindings) {
+        if (binding.set != set) continue;
+        VkDescriptorSetLayoutBinding layoutBinding{};
+        layoutBinding.binding = binding.binding;
+        layoutBinding.descriptorType = binding.type;
+        layoutBinding.descriptorCount = binding.count;
+        layoutBinding.stageFlags = binding.stageFlags;
+        result.push_back(layoutBinding);
+    }
+    return result;
+}
+
+std::vector<VkPushConstantRange> SpirvReflection::getPushConstantRanges() const {
+    if (_pushConstantSize == 0) return {};
+    // vkCmdPushConstants 的大小须为 4 的倍数
+    return { { _pushConstantStages, 0, (_pushConstantSize + 3) & ~3u } };
+}
+
+void SpirvReflection::getVertexInputDescription(std::vector<VkVertexInputBindingDescription>& bindings,
+    std::vector<VkVertexInputAttributeDescription>& attributes) const {
+    bindings.clear();
+    attributes.clear();
+    if (_vertexInputs.empty()) return;
+
+    uint32_t offset = 0;
+    for (const VertexInput& input : _vertexInputs) {
+        attributes.push_back({ input.location, 0, input.format, offset });
+        offset += input.size;
+    }
+    bindings.push_back({ 0, offset, VK_VERTEX_INPUT_RATE_VERTEX });
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * @class SpirvReflection
+ * @brief 从 SPIR-V 中读取描述符绑定、推送常量与顶点输入，代替手写的布局与顶点输入描述。
+ *
+ * 只解析生成布局所需的指令（OpDecorate/OpMemberDecorate、类型声明、OpConstant、OpVariable），不依赖外部库。
+ * 描述符类型按变量类型推断：
+ *   Uniform + Block 结构体          -> UNIFORM_BUFFER
+ *   Uniform + BufferBlock / StorageBuffer -> STORAGE_BUFFER
+ *   OpTypeSampler / OpTypeSampledImage -> SAMPLER / COMBINED_IMAGE_SAMPLER
+ *   OpTypeImage                     -> SAMPLED_IMAGE / STORAGE_IMAGE / *_TEXEL_BUFFER / INPUT_ATTACHMENT
+ * 动态偏移的缓冲区（*_DYNAMIC）无法从着色器中看出，需要的话仍应手写布局。
+ *
+ * 多个阶段用 merge() 合并：相同 (set, binding) 的 stageFlags 取并集，类型不一致时抛出异常；
+ * 推送常量合并为一个从偏移 0 开始、覆盖所有阶段的范围，使相同着色器组合得到完全相同的布局参数。
+ * 顶点输入只从顶点着色器读取，跳过内建变量。
+ *
+ * getEntryPoints()/requireEntryPoint() 只扫描 OpEntryPoint，不解析其余声明，
+ * PipelineBuilder 在添加着色器时用它检查入口名与执行模型，错误的入口不会传给驱动。
+ */
+class SpirvReflection {
+public:
+    struct DescriptorBinding {
+        uint32_t set;
+        uint32_t binding;
+        VkDescriptorType type;
+        uint32_t count;                 // 描述符数组的长度，非数组为 1
+        VkShaderStageFlags stageFlags;
+        std::string name;
+    };
+
+    struct VertexInput {
+        uint32_t location;
+        VkFormat format;
+        uint32_t size;                  // 字节数，用于紧密排列
+        std::string name;
+    };
+
+    struct EntryPoint {
+        std::string name;
+        VkShaderStageFlagBits stage;    // 由执行模型换算；Vulkan 不支持的执行模型为 0
+    };
+
+    // 模块中声明的所有入口
+    static std::vector<EntryPoint> getEntryPoints(const std::vector<char>& code);
+    // 模块中没有名为 name、执行模型对应 stage 的入口时抛出异常，异常信息列出现有的入口
+    static void requireEntryPoint(const std::vector<char>& code, VkShaderStageFlagBits stage, const std::string& name);
+
+    SpirvReflection() = default;
+    // code 为 addShaderStage 读入的 SPIR-V；格式错误或包含不支持的声明（如不定长描述符数组）时抛出异常
+    SpirvReflection(const std::vector<char>& code, VkShaderStageFlagBits stage);
+
+    // 合并另一个阶段的反射结果
+    void merge(const SpirvReflection& other);
+
+    // 按 (set, binding) 排序
+    const std::vector<DescriptorBinding>& getBindings() const { return _bindings; }
+    // 最大的 set 编号 + 1；中间未使用的 set 需要一个空布局占位
+    uint32_t getSetCount() const;
+    // 指定 set 的绑定，可直接用于 VkDescriptorSetLayoutCreateInfo
+    std::vector<VkDescriptorSetLayoutBinding> getSetLayoutBindings(uint32_t set) const;
+
+    // 没有推送常量时为空，否则只有一个范围
+    std::vector<VkPushConstantRange> getPushConstantRanges() const;
+
+    // 按 location 排序
+    const std::vector<VertexInput>& getVertexInputs() const { return _vertexInputs; }
+    // 所有输入按 location 顺序紧密排列在绑定 0，适用于没有现成顶点格式的着色器
+    void getVertexInputDescription(std::vector<VkVertexInputBindingDescription>& bindings,
+        std::vector<VkVertexInputAttributeDescription>& attributes) const;
+
+private:
+    std::vector<DescriptorBinding> _bindings;
+    uint32_t _pushConstantSize = 0;
+    VkShaderStageFlags _pushConstantStages = 0;
+    std::vector<VertexInput> _vertexInputs;
+};
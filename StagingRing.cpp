@@ -0,0 +1,64 @@
+#include "StagingRing.h"
+#include <stdexcept>
+#include <algorithm>
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+StagingRing::StagingRing(VulkanContext& context, VkDeviceSize capacity)
+    : _capacity(capacity) {
+    _buffer = std::make_unique<VulkanBuffer>(
+        context,
+        capacity,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+    _mapped = static_cast<uint8_t*>(_buffer->GetMappedMemory());
+    if (!_mapped) {
+        throw std::runtime_error("failed to map staging ring!");
+    }
+}
+
+bool StagingRing::tryAllocate(VkDeviceSize size, VkDeviceSize alignment, Allocation& allocation) {
+    size = std::max<VkDeviceSize>(size, 1);
+    if (size > _capacity) return false;
+
+    if (isEmpty()) {
+        _head = 0;
+        _tail = 0;
+    }
+
+    VkDeviceSize offset = alignUp(_head, alignment);
+    if (isEmpty() || _head > _tail) {
+        // 数据位于 [tail, head)，优先使用尾部剩余空间，不够时绕回开头
+        if (offset + size > _capacity) {
+            offset = 0;
+            if (!isEmpty() && size > _tail) return false;
+        }
+    } else {
+        // 已经绕回：数据位于 [tail, capacity) 和 [0, head)；head == tail 表示已满
+        if (_head == _tail || offset + size > _tail) return false;
+    }
+
+    _head = offset + size;
+    _hasUncommitted = true;
+
+    allocation.buffer = _buffer->GetBuffer();
+    allocation.offset = offset;
+    allocation.data = _mapped + offset;
+    return true;
+}
+
+void StagingRing::commit(uint64_t submissionId) {
+    if (!_hasUncommitted) return;
+    _inFlight.push_back({submissionId, _head});
+    _hasUncommitted = false;
+}
+
+void StagingRing::release(uint64_t completedId) {
+    while (!_inFlight.empty() && _inFlight.front().submissionId <= completedId) {
+        _tail = _inFlight.front().end;
+        _inFlight.pop_front();
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanBuffer.h"
+#include <deque>
+#include <memory>
+
+/*
+ * @class StagingRing
+ * @brief 一个持久映射的环形暂存缓冲区。
+ *
+ * 上传时从环中切出一段写入数据，而不是每次新建一个 host-visible buffer。
+ * 每段空间在 commit() 时与一次提交的编号绑定，只有当调用方确认该提交
+ * 已在 GPU 上完成（release）之后，这段空间才会被回收复用。
+ */
+class StagingRing {
+public:
+    struct Allocation {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        void* data = nullptr;
+    };
+
+    StagingRing(VulkanContext& context, VkDeviceSize capacity);
+
+    // 禁止拷贝
+    StagingRing(const StagingRing&) = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+
+    // 切出 size 字节，空间不足时返回 false，调用方应等待在途提交完成并 release 后重试
+    bool tryAllocate(VkDeviceSize size, VkDeviceSize alignment, Allocation& allocation);
+
+    // 把上一次 commit 之后切出的所有区段归属到编号为 submissionId 的提交
+    void commit(uint64_t submissionId);
+
+    // 回收编号不大于 completedId 的提交所占用的区段
+    void release(uint64_t completedId);
+
+    bool hasInFlight() const { return !_inFlight.empty(); }
+    uint64_t oldestInFlight() const { return _inFlight.front().submissionId; }
+    VkDeviceSize getCapacity() const { return _capacity; }
+
+private:
+    struct Region {
+        uint64_t submissionId;
+        VkDeviceSize end;           // 该提交写入结束时的 head 位置
+    };
+
+    bool isEmpty() const { return _inFlight.empty() && !_hasUncommitted; }
+
+    std::unique_ptr<VulkanBuffer> _buffer;
+    uint8_t* _mapped = nullptr;
+    VkDeviceSize _capacity;
+    VkDeviceSize _head = 0;         // 下一次写入的位置
+    VkDeviceSize _tail = 0;         // 最早一段仍在使用的数据的起点
+    bool _hasUncommitted = false;
+    std::deque<Region> _inFlight;
+};
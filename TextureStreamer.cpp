@@ -0,0 +1,205 @@
+#include "TextureStreamer.h"
+#include "ImageDecoder.h"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+TextureStreamer::TextureStreamer(VulkanContext& context, ImmediateSubmitter& uploader,
+    uint32_t workerCount, VkDeviceSize memoryBudget, uint32_t maxUploadsPerUpdate)
+    : _context(context), _uploader(uploader), _memoryBudget(memoryBudget),
+      _maxUploadsPerUpdate(std::max(maxUploadsPerUpdate, 1u)), _staging(context, memoryBudget) {
+
+    // 1. 占位纹理：1x1 白色，同步上传
+    const uint8_t white[4] = { 255, 255, 255, 255 };
+    _placeholder = VulkanImage::createTextureFromPixels(_context, _uploader, white, 1, 1);
+
+    // 2. 启动工作线程，留一个核心给主线程
+    if (workerCount == 0) {
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        _workers.emplace_back(&TextureStreamer::workerLoop, this);
+    }
+}
+
+TextureStreamer::~TextureStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _jobAvailable.notify_all();
+    _budgetAvailable.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+
+    // 图像与暂存区析构前必须确认 GPU 已不再写入它们
+    for (auto& batch : _uploading) {
+        _uploader.wait(batch.ticket);
+    }
+}
+
+TextureStreamer::Handle TextureStreamer::load(const std::string& path) {
+    Handle handle = static_cast<Handle>(_slots.size());
+    Slot slot;
+    slot.path = path;
+    _slots.push_back(std::move(slot));
+    _pendingCount++;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back({handle, path});
+    }
+    _jobAvailable.notify_one();
+    return handle;
+}
+
+void TextureStreamer::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobAvailable.wait(lock, [this] { return _stop || !_jobs.empty(); });
+            if (_stop) return;
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        Decoded decoded;
+        decoded.handle = job.handle;
+
+        // 1. 只读文件头拿到尺寸，先申请暂存空间再解码
+        ImageDecoder::Info info;
+        if (ImageDecoder::readInfo(job.path, info)) {
+            decoded.bytes = info.decodeSize();
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (decoded.bytes <= _memoryBudget) {
+                _budgetAvailable.wait(lock, [&] {
+                    return _stop || _staging.tryAllocate(decoded.bytes, 16, decoded.staging);
+                });
+                if (_stop) return;
+                decoded.stagingSeq = ++_stagingSeq;
+                _staging.commit(decoded.stagingSeq);
+            } else {
+                _budgetAvailable.wait(lock, [&] { return _stop || _inFlightBytes == 0; });
+                if (_stop) return;
+            }
+            _inFlightBytes += decoded.bytes;
+        }
+
+        // 2. 直接解码进暂存内存（不持锁）
+        if (decoded.bytes > 0) {
+            if (decoded.stagingSeq == 0) {
+                decoded.oversizeStaging = std::make_unique<VulkanBuffer>(
+                    _context,
+                    decoded.bytes,
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+                );
+                decoded.staging.buffer = decoded.oversizeStaging->GetBuffer();
+                decoded.staging.offset = 0;
+                decoded.staging.data = decoded.oversizeStaging->GetMappedMemory();
+            }
+            decoded.succeeded = ImageDecoder::decodeRGBA8Into(job.path, decoded.staging.data, decoded.bytes, info);
+            decoded.width = info.width;
+            decoded.height = info.height;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _decoded.push_back(std::move(decoded));
+    }
+}
+
+void TextureStreamer::releaseStaging(const std::vector<uint64_t>& stagingSeqs, VkDeviceSize bytes) {
+    if (stagingSeqs.empty() && bytes == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (uint64_t seq : stagingSeqs) {
+            _completedSeqs.insert(seq);
+        }
+        // 暂存环只能按分配顺序回收：推进到第一个尚未完成的区段之前
+        while (!_completedSeqs.empty() && *_completedSeqs.begin() == _releasedSeq + 1) {
+            _completedSeqs.erase(_completedSeqs.begin());
+            _releasedSeq++;
+        }
+        _staging.release(_releasedSeq);
+        _inFlightBytes -= bytes;
+    }
+    _budgetAvailable.notify_all();
+}
+
+uint32_t TextureStreamer::update() {
+    uint32_t becameReady = 0;
+
+    // 1. 回收已经在 GPU 上完成的批次
+    while (!_uploading.empty() && _uploader.isComplete(_uploading.front().ticket)) {
+        UploadBatch& batch = _uploading.front();
+        for (Handle handle : batch.handles) {
+            _slots[handle].state = State::Ready;
+            _pendingCount--;
+            becameReady++;
+        }
+        releaseStaging(batch.stagingSeqs, batch.bytes);
+        _uploading.pop_front();
+    }
+
+    // 2. 取出一部分已解码的图片
+    std::vector<Decoded> decoded;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t count = std::min<size_t>(_decoded.size(), _maxUploadsPerUpdate);
+        std::move(_decoded.begin(), _decoded.begin() + count, std::back_inserter(decoded));
+        _decoded.erase(_decoded.begin(), _decoded.begin() + count);
+    }
+    if (decoded.empty()) return becameReady;
+
+    // 3. 全部记录进同一个批次，直接从暂存区拷贝，提交后不等待
+    UploadBatch batch{};
+    std::vector<uint64_t> failedSeqs;
+    VkDeviceSize failedBytes = 0;
+    _uploader.beginBatch();
+    for (auto& image : decoded) {
+        Slot& slot = _slots[image.handle];
+        if (!image.succeeded) {
+            std::cerr << "[WARNING] failed to load texture: " << slot.path << std::endl;
+            slot.state = State::Failed;
+            _pendingCount--;
+            if (image.stagingSeq != 0) failedSeqs.push_back(image.stagingSeq);
+            failedBytes += image.bytes;
+            continue;
+        }
+        slot.image = VulkanImage::createTextureFromStaging(_context, _uploader, image.staging, image.width, image.height);
+        slot.state = State::Uploading;
+        batch.handles.push_back(image.handle);
+        if (image.stagingSeq != 0) batch.stagingSeqs.push_back(image.stagingSeq);
+        if (image.oversizeStaging) batch.oversizeStaging.push_back(std::move(image.oversizeStaging));
+        batch.bytes += image.bytes;
+    }
+    batch.ticket = _uploader.flush();
+    releaseStaging(failedSeqs, failedBytes);
+
+    if (!batch.handles.empty()) {
+        _uploading.push_back(std::move(batch));
+    }
+    return becameReady;
+}
+
+void TextureStreamer::waitAll() {
+    while (_pendingCount > 0) {
+        update();
+        if (!_uploading.empty()) {
+            _uploader.wait(_uploading.front().ticket);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+VulkanImage& TextureStreamer::get(Handle handle) {
+    Slot& slot = _slots[handle];
+    return slot.state == State::Ready ? *slot.image : *_placeholder;
+}
+
+VkDeviceSize TextureStreamer::getInFlightBytes() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _inFlightBytes;
+}
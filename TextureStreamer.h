@@ -0,0 +1,128 @@
+#pragma once
+#include "VulkanContext.h"
+#include "VulkanImage.h"
+#include "ImmediateSubmitter.h"
+#include "StagingRing.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * @class TextureStreamer
+ * @brief 后台多线程纹理加载器。
+ *
+ * load() 立即返回一个句柄，工作线程池在后台解码图片；主线程每帧调用 update()，
+ * 把已解码的图片批量记录进 ImmediateSubmitter 的一个批次并 flush，不等待 GPU。
+ * 批次完成之前 get() 返回一张 1x1 的占位纹理。
+ *
+ * 工作线程先读文件头拿到尺寸，从加载器自己的持久映射暂存环中切出 RGBA8 大小的空间，
+ * 再由 ImageDecoder 直接解码进去，没有中间的堆拷贝。
+ * 内存预算即暂存环的容量：空间要等到对应批次在 GPU 上完成才会归还，
+ * 环满时工作线程阻塞。单张超出预算的图片使用临时暂存 buffer，
+ * 且只在没有其它在途数据时才允许开始解码。
+ *
+ * 除工作线程外，所有接口都应在同一个线程（通常是主线程）中调用。
+ * update() 会使用并提交 uploader 当前的批次。
+ */
+class TextureStreamer {
+public:
+    using Handle = uint32_t;
+
+    enum class State {
+        Loading,    // 排队或解码中
+        Uploading,  // 命令已提交，等待 GPU 完成
+        Ready,
+        Failed
+    };
+
+    TextureStreamer(VulkanContext& context, ImmediateSubmitter& uploader,
+        uint32_t workerCount = 0,                          // 0 表示 hardware_concurrency - 1
+        VkDeviceSize memoryBudget = 256ull * 1024 * 1024,
+        uint32_t maxUploadsPerUpdate = 32);
+    ~TextureStreamer();
+
+    // 禁止拷贝
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    Handle load(const std::string& path);
+
+    // 推进上传：回收已完成的批次，并把新解码的图片提交为一个批次。返回本次变为 Ready 的数量
+    uint32_t update();
+
+    // 阻塞直到所有已请求的纹理都 Ready 或 Failed（适合加载界面）
+    void waitAll();
+
+    // 未就绪（或加载失败）时返回占位纹理
+    VulkanImage& get(Handle handle);
+    State getState(Handle handle) const { return _slots[handle].state; }
+    bool isReady(Handle handle) const { return _slots[handle].state == State::Ready; }
+    VulkanImage& getPlaceholder() { return *_placeholder; }
+
+    VkDeviceSize getInFlightBytes();
+
+private:
+    struct Job {
+        Handle handle;
+        std::string path;
+    };
+
+    struct Decoded {
+        Handle handle;
+        bool succeeded = false;
+        StagingRing::Allocation staging;
+        uint64_t stagingSeq = 0;                    // 暂存环中的区段编号，0 表示使用临时 buffer
+        std::unique_ptr<VulkanBuffer> oversizeStaging;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        VkDeviceSize bytes = 0;                     // 计入预算的字节数
+    };
+
+    struct UploadBatch {
+        UploadTicket ticket;
+        std::vector<Handle> handles;
+        std::vector<uint64_t> stagingSeqs;
+        std::vector<std::unique_ptr<VulkanBuffer>> oversizeStaging;
+        VkDeviceSize bytes = 0;
+    };
+
+    struct Slot {
+        State state = State::Loading;
+        std::unique_ptr<VulkanImage> image;
+        std::string path;
+    };
+
+    void workerLoop();
+    // 归还暂存区段：区段按分配顺序回收，乱序完成的编号先记下来
+    void releaseStaging(const std::vector<uint64_t>& stagingSeqs, VkDeviceSize bytes);
+
+    VulkanContext& _context;
+    ImmediateSubmitter& _uploader;
+    VkDeviceSize _memoryBudget;
+    uint32_t _maxUploadsPerUpdate;
+
+    std::unique_ptr<VulkanImage> _placeholder;
+    std::vector<Slot> _slots;                   // 只由调用线程访问
+    std::deque<UploadBatch> _uploading;
+    uint32_t _pendingCount = 0;                 // Loading + Uploading 的数量
+
+    // --- 与工作线程共享，受 _mutex 保护 ---
+    std::mutex _mutex;
+    std::condition_variable _jobAvailable;
+    std::condition_variable _budgetAvailable;
+    std::deque<Job> _jobs;
+    std::vector<Decoded> _decoded;
+    StagingRing _staging;
+    uint64_t _stagingSeq = 0;               // 最近一次分配的区段编号
+    uint64_t _releasedSeq = 0;              // 该编号及之前的区段都已归还给暂存环
+    std::set<uint64_t> _completedSeqs;      // 已完成但前面还有未完成区段的编号
+    VkDeviceSize _inFlightBytes = 0;
+    bool _stop = false;
+
+    std::vector<std::thread> _workers;
+};
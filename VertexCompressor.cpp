@@ -0,0 +1,264 @@
+#include "VertexCompressor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    float signNotZero(float v) {
+        return v >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    uint16_t quantizeUnorm16(float value, float minValue, float extent) {
+        if (extent <= 0.0f) return 0;
+        float t = std::clamp((value - minValue) / extent, 0.0f, 1.0f);
+        return static_cast<uint16_t>(std::lround(t * 65535.0f));
+    }
+
+    /*
+     * 八面体编码后量化到 SNORM；直接四舍五入不一定是误差最小的格点，
+     * 因此比较 floor/ceil 组合出的四个候选，取解码后与原法线夹角最小的一个
+     */
+    template <typename T>
+    void encodeNormalSnorm(const glm::vec3& normal, float maxValue, T out[2]) {
+        glm::vec2 e = VertexCompressor::encodeOctahedral(normal);
+        float fx = std::floor(e.x * maxValue), fy = std::floor(e.y * maxValue);
+        float bestDot = -2.0f;
+        for (int i = 0; i < 4; ++i) {
+            float qx = std::clamp(fx + float(i & 1), -maxValue, maxValue);
+            float qy = std::clamp(fy + float(i >> 1), -maxValue, maxValue);
+            glm::vec3 decoded = VertexCompressor::decodeOctahedral(glm::vec2(qx / maxValue, qy / maxValue));
+            float d = glm::dot(decoded, normal);
+            if (d > bestDot) {
+                bestDot = d;
+                out[0] = static_cast<T>(qx);
+                out[1] = static_cast<T>(qy);
+            }
+        }
+    }
+
+    void writeIndices(std::span<const uint32_t> indices, VkIndexType type, std::vector<uint8_t>& out) {
+        if (type == VK_INDEX_TYPE_UINT16) {
+            out.resize(indices.size() * sizeof(uint16_t));
+            uint16_t* dst = reinterpret_cast<uint16_t*>(out.data());
+            for (size_t i = 0; i < indices.size(); ++i) dst[i] = static_cast<uint16_t>(indices[i]);
+        } else {
+            out.resize(indices.size_bytes());
+            memcpy(out.data(), indices.data(), indices.size_bytes());
+        }
+    }
+}
+
+PackedMesh VertexCompressor::pack(std::span<const Vertex> vertices, std::span<const uint32_t> indices, const MeshBounds& bounds,
+    VertexFormat format, VertexLayout layout) {
+    const bool split = layout == VertexLayout::Split;
+    PackedMesh mesh{};
+    mesh.format = format;
+    mesh.layout = layout;
+    mesh.vertexStride = split ? getAttributeStride(format) : getStride(format);
+    mesh.positionStride = split ? getPositionStride(format) : 0;
+    mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+    mesh.indexCount = static_cast<uint32_t>(indices.size());
+    mesh.indexType = selectIndexType(vertices.size());
+    writeIndices(indices, mesh.indexType, mesh.indexData);
+
+    mesh.vertexData.resize(static_cast<size_t>(mesh.vertexStride) * vertices.size());
+    mesh.positionData.resize(static_cast<size_t>(mesh.positionStride) * vertices.size());
+    if (format == VertexFormat::Float32) {
+        mesh.dequantization = { glm::vec3(1.0f), glm::vec3(0.0f) };
+        if (!split) {
+            memcpy(mesh.vertexData.data(), vertices.data(), vertices.size_bytes());
+            return mesh;
+        }
+        // normal 与 texCoord 在 Vertex 中相邻，一次拷贝 20 字节
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            memcpy(mesh.positionData.data() + i * mesh.positionStride, &vertices[i].position, sizeof(glm::vec3));
+            memcpy(mesh.vertexData.data() + i * mesh.vertexStride, &vertices[i].normal, sizeof(glm::vec3) + sizeof(glm::vec2));
+        }
+        return mesh;
+    }
+
+    const glm::vec3 extent = vertices.empty() ? glm::vec3(0.0f) : bounds.max - bounds.min;
+    mesh.dequantization = { extent, bounds.min };
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& vertex = vertices[i];
+        uint8_t* dst = mesh.vertexData.data() + i * mesh.vertexStride;
+
+        uint16_t position[4] = {
+            quantizeUnorm16(vertex.position.x, bounds.min.x, extent.x),
+            quantizeUnorm16(vertex.position.y, bounds.min.y, extent.y),
+            quantizeUnorm16(vertex.position.z, bounds.min.z, extent.z),
+            0,
+        };
+        uint16_t uv[2] = { floatToHalf(vertex.texCoord.x), floatToHalf(vertex.texCoord.y) };
+
+        // 零长度法线（OBJ 中缺失法线）编码为 +Z
+        glm::vec3 normal = glm::length(vertex.normal) > 0.0f ? glm::normalize(vertex.normal) : glm::vec3(0.0f, 0.0f, 1.0f);
+        if (split) {
+            memcpy(mesh.positionData.data() + i * mesh.positionStride, position, 8);
+            if (format == VertexFormat::Compact16) {
+                int16_t oct[2];
+                encodeNormalSnorm(normal, 32767.0f, oct);
+                memcpy(dst + 0, oct, 4);
+            } else {
+                int8_t oct[2];
+                encodeNormalSnorm(normal, 127.0f, oct);
+                memcpy(dst + 0, oct, 2);
+            }
+            memcpy(dst + 4, uv, 4);
+        } else if (format == VertexFormat::Compact16) {
+            int16_t oct[2];
+            encodeNormalSnorm(normal, 32767.0f, oct);
+            memcpy(dst + 0, position, 8);
+            memcpy(dst + 8, oct, 4);
+            memcpy(dst + 12, uv, 4);
+        } else {
+            int8_t oct[2];
+            encodeNormalSnorm(normal, 127.0f, oct);
+            memcpy(dst + 0, position, 6);
+            memcpy(dst + 6, oct, 2);
+            memcpy(dst + 8, uv, 4);
+        }
+    }
+    return mesh;
+}
+
+uint32_t VertexCompressor::getStride(VertexFormat format) {
+    switch (format) {
+    case VertexFormat::Float32: return sizeof(Vertex);
+    case VertexFormat::Compact16: return 16;
+    case VertexFormat::Compact8: return 12;
+    }
+    throw std::runtime_error("unknown vertex format");
+}
+
+uint32_t VertexCompressor::getPositionStride(VertexFormat format) {
+    return format == VertexFormat::Float32 ? sizeof(glm::vec3) : 8;
+}
+
+uint32_t VertexCompressor::getAttributeStride(VertexFormat format) {
+    // 紧凑格式的属性流保持 4 字节对齐：Compact8 的法线后留 2 字节空位
+    return format == VertexFormat::Float32 ? sizeof(glm::vec3) + sizeof(glm::vec2) : 8;
+}
+
+std::vector<VkVertexInputBindingDescription> VertexCompressor::getBindingDescription(VertexFormat format, VertexLayout layout, bool positionOnly) {
+    if (layout == VertexLayout::Interleaved) {
+        return {
+            {
+                .binding = 0,
+                .stride = getStride(format),
+                .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+            },
+        };
+    }
+    std::vector<VkVertexInputBindingDescription> bindings = {
+        { .binding = 0, .stride = getPositionStride(format), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX },
+        { .binding = 1, .stride = getAttributeStride(format), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX },
+    };
+    if (positionOnly) bindings.pop_back();
+    return bindings;
+}
+
+std::vector<VkVertexInputAttributeDescription> VertexCompressor::getAttributeDescription(VertexFormat format, VertexLayout layout, bool positionOnly) {
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    if (layout == VertexLayout::Interleaved) {
+        switch (format) {
+        case VertexFormat::Float32:
+            attributes = {
+                { .location = 0, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = offsetof(Vertex, position) },
+                { .location = 1, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = offsetof(Vertex, normal) },
+                { .location = 2, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT, .offset = offsetof(Vertex, texCoord) },
+            };
+            break;
+        case VertexFormat::Compact16:
+            attributes = {
+                { .location = 0, .binding = 0, .format = VK_FORMAT_R16G16B16A16_UNORM, .offset = 0 },
+                { .location = 1, .binding = 0, .format = VK_FORMAT_R16G16_SNORM, .offset = 8 },
+                { .location = 2, .binding = 0, .format = VK_FORMAT_R16G16_SFLOAT, .offset = 12 },
+            };
+            break;
+        case VertexFormat::Compact8:
+            attributes = {
+                { .location = 0, .binding = 0, .format = VK_FORMAT_R16G16B16A16_UNORM, .offset = 0 },
+                { .location = 1, .binding = 0, .format = VK_FORMAT_R8G8_SNORM, .offset = 6 },
+                { .location = 2, .binding = 0, .format = VK_FORMAT_R16G16_SFLOAT, .offset = 8 },
+            };
+            break;
+        default:
+            throw std::runtime_error("unknown vertex format");
+        }
+    } else {
+        switch (format) {
+        case VertexFormat::Float32:
+            attributes = {
+                { .location = 0, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = 0 },
+                { .location = 1, .binding = 1, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = 0 },
+                { .location = 2, .binding = 1, .format = VK_FORMAT_R32G32_SFLOAT, .offset = sizeof(glm::vec3) },
+            };
+            break;
+        case VertexFormat::Compact16:
+        case VertexFormat::Compact8:
+            attributes = {
+                { .location = 0, .binding = 0, .format = VK_FORMAT_R16G16B16A16_UNORM, .offset = 0 },
+                { .location = 1, .binding = 1, .format = format == VertexFormat::Compact16 ? VK_FORMAT_R16G16_SNORM : VK_FORMAT_R8G8_SNORM, .offset = 0 },
+                { .location = 2, .binding = 1, .format = VK_FORMAT_R16G16_SFLOAT, .offset = 4 },
+            };
+            break;
+        default:
+            throw std::runtime_error("unknown vertex format");
+        }
+    }
+    if (positionOnly) attributes.resize(1);
+    return attributes;
+}
+
+VkIndexType VertexCompressor::selectIndexType(size_t vertexCount) {
+    return vertexCount <= 65536 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+}
+
+glm::vec2 VertexCompressor::encodeOctahedral(const glm::vec3& normal) {
+    float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    glm::vec2 p(normal.x / l1, normal.y / l1);
+    if (normal.z < 0.0f) {
+        // 下半球沿对角线折叠到外侧的四个三角形
+        p = glm::vec2((1.0f - std::fabs(p.y)) * signNotZero(p.x), (1.0f - std::fabs(p.x)) * signNotZero(p.y));
+    }
+    return p;
+}
+
+glm::vec3 VertexCompressor::decodeOctahedral(const glm::vec2& encoded) {
+    glm::vec3 n(encoded.x, encoded.y, 1.0f - std::fabs(encoded.x) - std::fabs(encoded.y));
+    if (n.z < 0.0f) {
+        float x = (1.0f - std::fabs(n.y)) * signNotZero(n.x);
+        float y = (1.0f - std::fabs(n.x)) * signNotZero(n.y);
+        n.x = x;
+        n.y = y;
+    }
+    return glm::normalize(n);
+}
+
+uint16_t VertexCompressor::floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t abs = bits & 0x7FFFFFFFu;
+
+    if (abs >= 0x7F800000u) {
+        return static_cast<uint16_t>(sign | (abs > 0x7F800000u ? 0x7E00u : 0x7C00u));   // NaN / Inf
+    }
+    if (abs >= 0x477FF000u) {
+        return static_cast<uint16_t>(sign | 0x7C00u);   // 舍入后超过 65504
+    }
+    if (abs < 0x38800000u) {
+        // 半精度的非规格化数：单位为 2^-24，乘上 2^24 后就近取整
+        float magnitude;
+        memcpy(&magnitude, &abs, 4);
+        return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(magnitude * 16777216.0f)));
+    }
+    // 规格化数：指数偏移从 127 改为 15，尾数截到 10 位并就近舍入到偶数（进位可正确溢出到指数）
+    uint32_t half = (abs >> 13) - (112u << 10);
+    const uint32_t rest = abs & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++;
+    return static_cast<uint16_t>(sign | half);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Model.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ * @class VertexCompressor
+ * @brief 把 Vertex 打包成紧凑的 GPU 顶点布局，并生成对应的顶点输入描述。
+ *
+ * Compact16（16 字节）：
+ *   location 0  R16G16B16A16_UNORM  位置，相对包围盒量化，w 未使用
+ *   location 1  R16G16_SNORM        八面体编码的法线
+ *   location 2  R16G16_SFLOAT       UV
+ * Compact8（12 字节）：
+ *   location 0  R16G16B16A16_UNORM  位置（偏移 0，着色器只取 xyz）
+ *   location 1  R8G8_SNORM          八面体编码的法线，与位置的 w 分量重叠（偏移 6）
+ *   location 2  R16G16_SFLOAT       UV
+ *
+ * Split 布局把位置拆成单独的流（绑定 0，Float32 为 12 字节，紧凑格式为 8 字节），
+ * 法线与 UV 放在绑定 1（Float32 为 20 字节，紧凑格式为 8 字节：法线在偏移 0，UV 在偏移 4）。
+ * 各 location 与 Interleaved 相同，着色器无需修改；只需位置的管线只绑定位置流，不再读取法线与 UV。
+ *
+ * 顶点着色器需用 PackedMesh::dequantization 还原位置，用 res/vertex_decode.hlsli 中的函数解码法线。
+ * 八面体编码在量化后的四个相邻格点中选误差最小的一个。
+ */
+class VertexCompressor {
+public:
+    static PackedMesh pack(std::span<const Vertex> vertices, std::span<const uint32_t> indices, const MeshBounds& bounds,
+        VertexFormat format, VertexLayout layout = VertexLayout::Interleaved);
+
+    // Interleaved 布局的顶点大小，以及 Split 布局两个流各自的大小
+    static uint32_t getStride(VertexFormat format);
+    static uint32_t getPositionStride(VertexFormat format);
+    static uint32_t getAttributeStride(VertexFormat format);
+
+    // positionOnly 时只返回绑定 0 与 location 0
+    static std::vector<VkVertexInputBindingDescription> getBindingDescription(VertexFormat format,
+        VertexLayout layout = VertexLayout::Interleaved, bool positionOnly = false);
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescription(VertexFormat format,
+        VertexLayout layout = VertexLayout::Interleaved, bool positionOnly = false);
+
+    // 顶点数不超过 65536 时所有索引都能放进 16 位
+    static VkIndexType selectIndexType(size_t vertexCount);
+
+    // 单位向量 -> [-1, 1]^2 与其逆变换
+    static glm::vec2 encodeOctahedral(const glm::vec3& normal);
+    static glm::vec3 decodeOctahedral(const glm::vec2& encoded);
+
+    // float -> IEEE 半精度（就近舍入到偶数）
+    static uint16_t floatToHalf(float value);
+};
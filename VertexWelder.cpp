@@ -0,0 +1,273 @@
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WELDER_USE_SSE2 1
+#endif
+
+namespace {
+    static_assert(sizeof(Vertex) == 32, "VertexWelder 假定 Vertex 是紧凑排列的 8 个 float");
+
+    // 参与比较与哈希的 32 字节：精确模式为规范化后的位模式，epsilon 模式为量化后的整数
+    struct alignas(16) Key {
+        uint32_t w[8];
+    };
+
+    constexpr uint32_t kMul0 = 0x9E3779B1u;
+    constexpr uint32_t kMul1 = 0x85EBCA77u;
+    constexpr uint32_t kMul2 = 0xC2B2AE3Du;
+    constexpr uint32_t kMul3 = 0x27D4EB2Fu;
+
+    inline uint64_t finalize(uint64_t lane0, uint64_t lane1) {
+        uint64_t h = lane0 ^ ((lane1 << 31) | (lane1 >> 33));
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+#ifdef WELDER_USE_SSE2
+    inline void makeKey(const Vertex& vertex, float invEpsilon, Key& key) {
+        const float* f = &vertex.position.x;
+        __m128 lo = _mm_loadu_ps(f);
+        __m128 hi = _mm_loadu_ps(f + 4);
+        __m128i a, b;
+        if (invEpsilon > 0.0f) {
+            __m128 scale = _mm_set1_ps(invEpsilon);
+            a = _mm_cvtps_epi32(_mm_mul_ps(lo, scale));
+            b = _mm_cvtps_epi32(_mm_mul_ps(hi, scale));
+        } else {
+            // -0 与 +0 在 operator== 下相等，哈希前统一成 +0
+            const __m128i abs = _mm_set1_epi32(0x7FFFFFFF);
+            const __m128i zero = _mm_setzero_si128();
+            a = _mm_castps_si128(lo);
+            b = _mm_castps_si128(hi);
+            a = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(a, abs), zero), a);
+            b = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(b, abs), zero), b);
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(key.w), a);
+        _mm_store_si128(reinterpret_cast<__m128i*>(key.w + 4), b);
+    }
+
+    // 多线性哈希：8 个 32 位字各乘一个常数后按 64 位累加，两条 64 位通道最后混合
+    inline uint64_t hashKey(const Key& key) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(key.w));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(key.w + 4));
+        __m128i sum = _mm_add_epi64(
+            _mm_add_epi64(_mm_mul_epu32(a, _mm_set1_epi32(static_cast<int>(kMul0))),
+                          _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_set1_epi32(static_cast<int>(kMul1)))),
+            _mm_add_epi64(_mm_mul_epu32(b, _mm_set1_epi32(static_cast<int>(kMul2))),
+                          _mm_mul_epu32(_mm_srli_epi64(b, 32), _mm_set1_epi32(static_cast<int>(kMul3)))));
+        alignas(16) uint64_t lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sum);
+        return finalize(lanes[0], lanes[1]);
+    }
+
+    inline bool keyEqual(const Key& x, const Key& y) {
+        __m128i a = _mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(x.w)), _mm_load_si128(reinterpret_cast<const __m128i*>(y.w)));
+        __m128i b = _mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(x.w + 4)), _mm_load_si128(reinterpret_cast<const __m128i*>(y.w + 4)));
+        return _mm_movemask_epi8(_mm_and_si128(a, b)) == 0xFFFF;
+    }
+#else
+    inline void makeKey(const Vertex& vertex, float invEpsilon, Key& key) {
+        const float* f = &vertex.position.x;
+        for (int i = 0; i < 8; ++i) {
+            if (invEpsilon > 0.0f) {
+                float q = std::nearbyint(f[i] * invEpsilon);
+                key.w[i] = (q >= -2147483648.0f && q < 2147483648.0f) ? static_cast<uint32_t>(static_cast<int32_t>(q)) : 0x80000000u;
+            } else {
+                uint32_t bits;
+                memcpy(&bits, f + i, 4);
+                key.w[i] = (bits & 0x7FFFFFFFu) == 0 ? 0u : bits;
+            }
+        }
+    }
+
+    inline uint64_t hashKey(const Key& key) {
+        const uint64_t mul[4] = { kMul0, kMul1, kMul2, kMul3 };
+        uint64_t lane0 = key.w[0] * mul[0] + key.w[1] * mul[1] + key.w[4] * mul[2] + key.w[5] * mul[3];
+        uint64_t lane1 = key.w[2] * mul[0] + key.w[3] * mul[1] + key.w[6] * mul[2] + key.w[7] * mul[3];
+        return finalize(lane0, lane1);
+    }
+
+    inline bool keyEqual(const Key& x, const Key& y) {
+        return memcmp(x.w, y.w, sizeof(x.w)) == 0;
+    }
+#endif
+
+    // 开放寻址 + 线性探测；槽位存哈希高 32 位作为标签，标签相同时才比较完整的 Key
+    class FlatTable {
+    public:
+        explicit FlatTable(size_t expected) {
+            size_t capacity = 16;
+            while (capacity * 3 < expected * 4) capacity <<= 1;   // 负载因子不超过 0.75，插入期间不扩容
+            _mask = capacity - 1;
+            _slots.assign(capacity, Slot{ 0, kEmpty });
+        }
+
+        // 找到相等的元素时返回其值，否则插入 value 并返回 value；keyOf(value, key) 取出已有元素的 Key
+        template <typename KeyOf>
+        uint32_t findOrInsert(uint64_t hash, const Key& key, uint32_t value, KeyOf&& keyOf) {
+            const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+            size_t slot = static_cast<size_t>(hash) & _mask;
+            while (true) {
+                Slot& entry = _slots[slot];
+                if (entry.value == kEmpty) {
+                    entry = { tag, value };
+                    return value;
+                }
+                if (entry.tag == tag) {
+                    Key other;
+                    keyOf(entry.value, other);
+                    if (keyEqual(key, other)) return entry.value;
+                }
+                slot = (slot + 1) & _mask;
+            }
+        }
+
+    private:
+        struct Slot {
+            uint32_t tag;
+            uint32_t value;
+        };
+        static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+        std::vector<Slot> _slots;
+        size_t _mask = 0;
+    };
+
+    template <typename Task>
+    void runParallel(uint32_t threadCount, Task&& task) {
+        std::vector<std::thread> workers;
+        for (uint32_t t = 1; t < threadCount; ++t) {
+            workers.emplace_back(task, t);
+        }
+        task(0u);
+        for (auto& worker : workers) worker.join();
+    }
+
+    void weldSerial(std::span<const Vertex> corners, float invEpsilon, std::vector<Vertex>& outVertices, std::vector<uint32_t>& outIndices) {
+        FlatTable table(corners.size());
+        outIndices.resize(corners.size());
+        auto keyOf = [&](uint32_t index, Key& key) { makeKey(outVertices[index], invEpsilon, key); };
+        for (size_t c = 0; c < corners.size(); ++c) {
+            Key key;
+            makeKey(corners[c], invEpsilon, key);
+            uint32_t next = static_cast<uint32_t>(outVertices.size());
+            uint32_t index = table.findOrInsert(hashKey(key), key, next, keyOf);
+            if (index == next) {
+                outVertices.push_back(corners[c]);
+            }
+            outIndices[c] = index;
+        }
+    }
+
+    /*
+     * 并行版本：
+     * 1. 按角点区间并行计算哈希，并按哈希高位把角点下标分到各分片（每个区间内保持原有顺序）
+     * 2. 各分片独立去重，记录每个角点对应的首个相同角点
+     * 3. 按首次出现的角点顺序编号，其余角点引用首个角点的编号，结果与串行版本一致
+     */
+    void weldParallel(std::span<const Vertex> corners, float invEpsilon, uint32_t threadCount,
+        std::vector<Vertex>& outVertices, std::vector<uint32_t>& outIndices) {
+        const size_t count = corners.size();
+        uint32_t shardBits = 0;
+        while ((1u << shardBits) < threadCount) shardBits++;
+        const uint32_t shardCount = 1u << shardBits;
+        auto rangeBegin = [&](uint32_t t) { return count * t / threadCount; };
+
+        // 1. 哈希与分片
+        std::vector<uint64_t> hashes(count);
+        std::vector<std::vector<std::vector<uint32_t>>> bins(threadCount, std::vector<std::vector<uint32_t>>(shardCount));
+        runParallel(threadCount, [&](uint32_t t) {
+            size_t end = rangeBegin(t + 1);
+            for (auto& bin : bins[t]) bin.reserve((end - rangeBegin(t)) / shardCount + 16);
+            for (size_t c = rangeBegin(t); c < end; ++c) {
+                Key key;
+                makeKey(corners[c], invEpsilon, key);
+                uint64_t h = hashKey(key);
+                hashes[c] = h;
+                bins[t][shardBits ? static_cast<uint32_t>(h >> (64 - shardBits)) : 0].push_back(static_cast<uint32_t>(c));
+            }
+        });
+
+        // 2. 分片内去重：firstCorner[c] 为与 c 相同的第一个角点
+        std::vector<uint32_t> firstCorner(count);
+        auto keyOf = [&](uint32_t corner, Key& key) { makeKey(corners[corner], invEpsilon, key); };
+        runParallel(threadCount, [&](uint32_t t) {
+            for (uint32_t shard = t; shard < shardCount; shard += threadCount) {
+                size_t shardSize = 0;
+                for (uint32_t r = 0; r < threadCount; ++r) shardSize += bins[r][shard].size();
+                FlatTable table(shardSize);
+                for (uint32_t r = 0; r < threadCount; ++r) {
+                    for (uint32_t c : bins[r][shard]) {
+                        Key key;
+                        makeKey(corners[c], invEpsilon, key);
+                        firstCorner[c] = table.findOrInsert(hashes[c], key, c, keyOf);
+                    }
+                    std::vector<uint32_t>().swap(bins[r][shard]);
+                }
+            }
+        });
+        std::vector<uint64_t>().swap(hashes);
+
+        // 3. 编号：先数出每个区间的新顶点数，前缀和后各区间独立写出
+        std::vector<size_t> uniqueBase(threadCount + 1, 0);
+        runParallel(threadCount, [&](uint32_t t) {
+            size_t unique = 0;
+            for (size_t c = rangeBegin(t); c < rangeBegin(t + 1); ++c) {
+                unique += firstCorner[c] == c;
+            }
+            uniqueBase[t + 1] = unique;
+        });
+        for (uint32_t t = 0; t < threadCount; ++t) uniqueBase[t + 1] += uniqueBase[t];
+
+        outVertices.resize(uniqueBase[threadCount]);
+        outIndices.resize(count);
+        runParallel(threadCount, [&](uint32_t t) {
+            size_t next = uniqueBase[t];
+            for (size_t c = rangeBegin(t); c < rangeBegin(t + 1); ++c) {
+                if (firstCorner[c] == c) {
+                    outVertices[next] = corners[c];
+                    outIndices[c] = static_cast<uint32_t>(next++);
+                }
+            }
+        });
+        // 首个角点的编号已全部写好，其余角点只读取它们
+        runParallel(threadCount, [&](uint32_t t) {
+            for (size_t c = rangeBegin(t); c < rangeBegin(t + 1); ++c) {
+                if (firstCorner[c] != c) {
+                    outIndices[c] = outIndices[firstCorner[c]];
+                }
+            }
+        });
+    }
+}
+
+void VertexWelder::weld(std::span<const Vertex> corners, std::vector<Vertex>& outVertices, std::vector<uint32_t>& outIndices,
+    const Options& options) {
+    outVertices.clear();
+    outIndices.clear();
+    const float invEpsilon = options.epsilon > 0.0f ? 1.0f / options.epsilon : 0.0f;
+
+    // 每个线程至少分到 64K 个角点，否则线程开销大于收益
+    uint32_t threadCount = static_cast<uint32_t>(std::clamp<size_t>(corners.size() >> 16, 1, std::max(options.threadCount, 1u)));
+    if (threadCount == 1) {
+        weldSerial(corners, invEpsilon, outVertices, outIndices);
+    } else {
+        weldParallel(corners, invEpsilon, threadCount, outVertices, outIndices);
+    }
+}
+
+uint64_t VertexWelder::hash(const Vertex& vertex) {
+    Key key;
+    makeKey(vertex, 0.0f, key);
+    return hashKey(key);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "Model.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ * @class VertexWelder
+ * @brief 顶点去重（焊接）。
+ *
+ * 用开放寻址的平坦哈希表（线性探测，槽位只存 32 位标签与下标）代替 std::unordered_map<Vertex>：
+ * 每个角点只对 32 字节的 Vertex 做一次 SIMD 哈希，表按角点数预先分配，插入过程中不会扩容。
+ *
+ * 精确模式下相等判定与 Vertex::operator== 相同（+0 与 -0 视为相等），输出顶点按首次出现的顺序排列，
+ * 与逐个插入 unordered_map 的旧实现结果逐字节一致。
+ * threadCount > 1 时按哈希高位分片，每个分片一张表并行去重，最后再按首次出现的角点重新编号，
+ * 结果与单线程完全相同。
+ * epsilon > 0 时先把 8 个分量量化到 epsilon 网格再比较，落在同一格内的顶点被合并为首次出现的那个；
+ * 这是网格吸附而不是严格的距离判定，恰好跨过格子边界的两个近似顶点不会合并。
+ */
+class VertexWelder {
+public:
+    struct Options {
+        uint32_t threadCount = 1;
+        float epsilon = 0.0f;
+    };
+
+    // 对按顺序排列的角点去重，结果写入 outVertices / outIndices（原有内容被清空）
+    static void weld(std::span<const Vertex> corners, std::vector<Vertex>& outVertices, std::vector<uint32_t>& outIndices,
+        const Options& options);
+    static void weld(std::span<const Vertex> corners, std::vector<Vertex>& outVertices, std::vector<uint32_t>& outIndices) {
+        weld(corners, outVertices, outIndices, Options{});
+    }
+
+    // 对 Vertex 的 32 字节做一次哈希（精确模式下 -0 先规范化为 +0）
+    static uint64_t hash(const Vertex& vertex);
+};
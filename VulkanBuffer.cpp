@@ -1,5 +1,6 @@
 #include "VulkanBuffer.h"
 #include <stdexcept>
+#include <cstring>
 VulkanBuffer::VulkanBuffer(VulkanContext& context, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties){
     this->_size = size;
     this->_usage = usage;
@@ -14,24 +15,13 @@ VulkanBuffer::VulkanBuffer(VulkanContext& context, VkDeviceSize size, VkBufferUs
     if (vkCreateBuffer(_context->getDevice(), &bufferInfo, nullptr, &_buffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to create buffer!");
     }
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(_context->getDevice(), _buffer, &memRequirements);
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = _context->findMemoryType(memRequirements.memoryTypeBits, _properties);
-    if (vkAllocateMemory(_context->getDevice(), &allocInfo, nullptr, &_memory) != VK_SUCCESS) {
-        throw std::runtime_error("failed to allocate buffer memory!");
-    }
-    vkBindBufferMemory(_context->getDevice(), _buffer, _memory, 0);
-    if(usage & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) vkMapMemory(_context->getDevice(), _memory, 0, size, 0, &_mappedMemory);
+    _allocation = _context->getAllocator().allocateBufferMemory(_buffer, _properties);
+    // HOST_VISIBLE 的内存由分配器持久映射，这里直接拿到映射地址
+    if (_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) _mappedMemory = _allocation.mappedData;
 }
 VulkanBuffer::~VulkanBuffer(){
-    if (_mappedMemory) {
-        vkUnmapMemory(_context->getDevice(), _memory);
-    }
     vkDestroyBuffer(_context->getDevice(), _buffer, nullptr);   
-    vkFreeMemory(_context->getDevice(), _memory, nullptr);
+    _context->getAllocator().free(_allocation);
 }
 void VulkanBuffer::SetData(void* pointer,size_t size){
     memcpy(_mappedMemory,pointer,size);
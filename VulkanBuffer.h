@@ -5,7 +5,7 @@
 class VulkanBuffer{
 private:
     VkBuffer _buffer;
-    VkDeviceMemory _memory;
+    VulkanAllocation _allocation;
     VkDeviceSize _size;
     VkBufferUsageFlags _usage;
     VkMemoryPropertyFlags _properties;
@@ -19,7 +19,8 @@ public:
     void SetData(void* pointer,size_t size);
     void* GetMappedMemory() { return _mappedMemory; }
     VkBuffer GetBuffer() const { return _buffer; }
-    VkDeviceMemory GetMemory() { return _memory; }
+    VkDeviceMemory GetMemory() { return _allocation.memory; }
+    VkDeviceSize GetMemoryOffset() { return _allocation.offset; } // 子分配后 buffer 不一定从 memory 的 0 偏移开始
     VkDeviceSize GetSize() { return _size; }
     VkBufferUsageFlags GetUsage() { return _usage; }
     VkMemoryPropertyFlags GetProperties() { return _properties; }
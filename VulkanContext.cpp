@@ -15,6 +15,9 @@
 
 const std::vector<const char*> validationLayers = { "VK_LAYER_KHRONOS_validation" };
 const std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+// 可选扩展：设备支持时才启用，通过 isDeviceExtensionEnabled 查询
+const std::vector<const char*> optionalDeviceExtensions = { VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, VK_EXT_MESH_SHADER_EXTENSION_NAME,
+    VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME };
 
 #ifdef NDEBUG
 const bool enableValidationLayers = false;
@@ -82,6 +85,12 @@ VulkanContext::~VulkanContext() {
         }
     }
 
+    _commandBufferPool.reset();
+    _pipelineCache.reset();
+    if (_allocator) {
+        _allocator->printStats();
+        _allocator.reset();
+    }
     vkDestroyDevice(_device, nullptr);
     vkDestroySurfaceKHR(_instance, _surface, nullptr);
     vkDestroyInstance(_instance, nullptr);
@@ -111,6 +120,9 @@ void VulkanContext::initVulkan() {
     createSurface();
     pickPhysicalDevice();
     createLogicalDevice();
+    _allocator = std::make_unique<VulkanMemoryAllocator>(_physicalDevice, _device);
+    _commandBufferPool = std::make_unique<CommandBufferPool>(_device, _queueFamilyIndices.graphicsFamily.value());
+    _pipelineCache = std::make_unique<PipelineCache>(_device, _physicalDevice);
 }
 
 void VulkanContext::createInstance() {
@@ -235,9 +247,20 @@ void VulkanContext::createLogicalDevice() {
     
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // 多重间接绘制：GeometryPool 用一次 vkCmdDrawIndexedIndirect 绘制整个场景，不支持时退化为逐条间接绘制
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(_physicalDevice, &supportedFeatures);
+    deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+    deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+    _enabledFeatures = deviceFeatures;
+
+    // 时间线信号量用于异步上传（AsyncUploader）与渲染之间的 GPU 侧同步
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+    timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
 
     VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES};
     dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+    dynamicRenderingFeatures.pNext = &timelineSemaphoreFeatures;
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -245,8 +268,95 @@ void VulkanContext::createLogicalDevice() {
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+
+    // 必需扩展 + 设备支持的可选扩展
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(_physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(_physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+    std::vector<const char*> enabledExtensions = deviceExtensions;
+    for (const char* name : optionalDeviceExtensions) {
+        for (const auto& extension : availableExtensions) {
+            if (strcmp(extension.extensionName, name) == 0) {
+                enabledExtensions.push_back(name);
+                _enabledOptionalExtensions.insert(name);
+                break;
+            }
+        }
+    }
+
+    // 扩展存在但所需特性不支持时，从扩展列表中移除
+    auto disableExtension = [&](const char* extensionName) {
+        enabledExtensions.erase(std::find_if(enabledExtensions.begin(), enabledExtensions.end(),
+            [extensionName](const char* name) { return strcmp(name, extensionName) == 0; }));
+        _enabledOptionalExtensions.erase(extensionName);
+    };
+    auto queryFeatures = [this](void* features) {
+        VkPhysicalDeviceFeatures2 features2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = features;
+        vkGetPhysicalDeviceFeatures2(_physicalDevice, &features2);
+    };
+    // 启用的特性结构依次挂在时间线信号量特性之后
+    void** featureChainTail = &timelineSemaphoreFeatures.pNext;
+
+    // 网格着色器：扩展存在且同时支持任务/网格着色器时才启用
+    VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT};
+    if (isDeviceExtensionEnabled(VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+        queryFeatures(&meshShaderFeatures);
+        if (meshShaderFeatures.taskShader && meshShaderFeatures.meshShader) {
+            meshShaderFeatures = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT};
+            meshShaderFeatures.taskShader = VK_TRUE;
+            meshShaderFeatures.meshShader = VK_TRUE;
+            *featureChainTail = &meshShaderFeatures;
+            featureChainTail = &meshShaderFeatures.pNext;
+        } else {
+            disableExtension(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+        }
+    }
+
+    // 扩展动态状态（1.3 核心）：剔除、深度、图元拓扑等改为命令缓冲区状态，由 PipelineBuilder::useExtendedDynamicState 选用
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT};
+    if (isDeviceExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+        queryFeatures(&extendedDynamicStateFeatures);
+        if (extendedDynamicStateFeatures.extendedDynamicState) {
+            extendedDynamicStateFeatures = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT};
+            extendedDynamicStateFeatures.extendedDynamicState = VK_TRUE;
+            *featureChainTail = &extendedDynamicStateFeatures;
+            featureChainTail = &extendedDynamicStateFeatures.pNext;
+        } else {
+            disableExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+        }
+    }
+    VkPhysicalDeviceExtendedDynamicState2FeaturesEXT extendedDynamicState2Features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT};
+    if (isDeviceExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+        queryFeatures(&extendedDynamicState2Features);
+        if (extendedDynamicState2Features.extendedDynamicState2) {
+            extendedDynamicState2Features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT};
+            extendedDynamicState2Features.extendedDynamicState2 = VK_TRUE;
+            *featureChainTail = &extendedDynamicState2Features;
+            featureChainTail = &extendedDynamicState2Features.pNext;
+        } else {
+            disableExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+        }
+    }
+    // 第 3 版的每个状态是单独的特性，只启用多边形模式、颜色混合开关与颜色写掩码
+    if (isDeviceExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
+        VkPhysicalDeviceExtendedDynamicState3FeaturesEXT supported{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT};
+        queryFeatures(&supported);
+        _extendedDynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+        _extendedDynamicState3Features.extendedDynamicState3PolygonMode = supported.extendedDynamicState3PolygonMode;
+        _extendedDynamicState3Features.extendedDynamicState3ColorBlendEnable = supported.extendedDynamicState3ColorBlendEnable;
+        _extendedDynamicState3Features.extendedDynamicState3ColorWriteMask = supported.extendedDynamicState3ColorWriteMask;
+        if (supported.extendedDynamicState3PolygonMode || supported.extendedDynamicState3ColorBlendEnable
+            || supported.extendedDynamicState3ColorWriteMask) {
+            *featureChainTail = &_extendedDynamicState3Features;
+            featureChainTail = &_extendedDynamicState3Features.pNext;
+        } else {
+            disableExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+        }
+    }
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
     if (enableValidationLayers) {
         createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
@@ -271,7 +381,12 @@ bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device) {
     }
     VkPhysicalDeviceFeatures supportedFeatures;
     vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
-    return indices.isComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy;
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+    VkPhysicalDeviceFeatures2 features2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    features2.pNext = &timelineSemaphoreFeatures;
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+    return indices.isComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy
+        && timelineSemaphoreFeatures.timelineSemaphore;
 }
 
 QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice device) {
@@ -391,7 +506,7 @@ VkShaderModule VulkanContext::createShaderModule(const std::vector<char>& code)
     return shaderModule;
 }
 
-void VulkanContext::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory) const {
+void VulkanContext::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VulkanAllocation& allocation) const {
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     bufferInfo.size = size;
@@ -400,25 +515,17 @@ void VulkanContext::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, Vk
     if (vkCreateBuffer(_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to create buffer!");
     }
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(_device, buffer, &memRequirements);
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-    if (vkAllocateMemory(_device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-        throw std::runtime_error("failed to allocate buffer memory!");
-    }
-    vkBindBufferMemory(_device, buffer, bufferMemory, 0);
+    allocation = _allocator->allocateBufferMemory(buffer, properties);
 }
 
-void VulkanContext::createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory) const {
+void VulkanContext::createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VulkanAllocation& allocation, uint32_t arrayLayers, VkImageCreateFlags flags) const {
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.flags = flags;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
     imageInfo.extent = { width, height, 1 };
     imageInfo.mipLevels = mipLevels;
-    imageInfo.arrayLayers = 1;
+    imageInfo.arrayLayers = arrayLayers;
     imageInfo.format = format;
     imageInfo.tiling = tiling;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -428,29 +535,24 @@ void VulkanContext::createImage(uint32_t width, uint32_t height, uint32_t mipLev
     if (vkCreateImage(_device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
         throw std::runtime_error("failed to create image!");
     }
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(_device, image, &memRequirements);
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-    if (vkAllocateMemory(_device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-        throw std::runtime_error("failed to allocate image memory!");
-    }
-    vkBindImageMemory(_device, image, imageMemory, 0);
+    allocation = _allocator->allocateImageMemory(image, properties, tiling);
 }
 
-VkImageView VulkanContext::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels) const {
+VkImageView VulkanContext::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels, VkImageViewType viewType, uint32_t layerCount, uint32_t baseMipLevel, VkImageUsageFlags viewUsage) const {
+    VkImageViewUsageCreateInfo usageInfo{VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO};
+    usageInfo.usage = viewUsage;
+
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.pNext = viewUsage != 0 ? &usageInfo : nullptr;
     viewInfo.image = image;
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.viewType = viewType;
     viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = aspectFlags;
-    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.baseMipLevel = baseMipLevel;
     viewInfo.subresourceRange.levelCount = mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount = 1;
+    viewInfo.subresourceRange.layerCount = layerCount;
     VkImageView imageView;
     if (vkCreateImageView(_device, &viewInfo, nullptr, &imageView) != VK_SUCCESS) {
         throw std::runtime_error("failed to create texture image view!");
@@ -459,42 +561,27 @@ VkImageView VulkanContext::createImageView(VkImage image, VkFormat format, VkIma
 }
 
 
-VkCommandBuffer VulkanContext::beginSingleTimeCommands(VkCommandPool commandPool) const {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = commandPool;
-    allocInfo.commandBufferCount = 1;
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(_device, &allocInfo, &commandBuffer);
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-    return commandBuffer;
+VkCommandBuffer VulkanContext::beginSingleTimeCommands() const {
+    // 从当前线程的子池中复用一个命令缓冲区，已处于记录状态
+    return _commandBufferPool->begin();
 }
 
-void VulkanContext::endSingleTimeCommands(VkCommandBuffer commandBuffer, VkQueue queue, VkCommandPool commandPool) const {
-    vkEndCommandBuffer(commandBuffer);
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-    vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(queue);
-    vkFreeCommandBuffers(_device, commandPool, 1, &commandBuffer);
+void VulkanContext::endSingleTimeCommands(VkCommandBuffer commandBuffer, VkQueue queue) const {
+    // 只等待这一次提交的 fence，而不是用 vkQueueWaitIdle 排空整个队列；命令缓冲区由池回收
+    CommandBufferPool::Ticket ticket = _commandBufferPool->submit(commandBuffer, queue);
+    _commandBufferPool->wait(ticket);
 }
 
-void VulkanContext::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkQueue queue, VkCommandPool commandPool) const {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
+void VulkanContext::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkQueue queue) const {
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
     VkBufferCopy copyRegion{};
     copyRegion.size = size;
     vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-    endSingleTimeCommands(commandBuffer, queue, commandPool);
+    endSingleTimeCommands(commandBuffer, queue);
 }
 
-void VulkanContext::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkQueue queue, VkCommandPool commandPool) const {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
+void VulkanContext::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkQueue queue) const {
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
     VkBufferImageCopy region{};
     region.bufferOffset = 0;
     region.bufferRowLength = 0;
@@ -506,7 +593,7 @@ void VulkanContext::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t w
     region.imageOffset = {0, 0, 0};
     region.imageExtent = {width, height, 1};
     vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-    endSingleTimeCommands(commandBuffer, queue, commandPool);
+    endSingleTimeCommands(commandBuffer, queue);
 }
 
 // ... 实现 generateMipmaps 和 transitionImageLayout ...
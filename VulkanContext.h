@@ -3,9 +3,13 @@
 #include <string>
 #include <optional>
 #include <memory>
+#include <set>
 #define GLFW_INCLUDE_VULKAN
 #include "GLFW/glfw3.h"
 #include <vulkan/vulkan.h>
+#include "VulkanMemoryAllocator.h"
+#include "CommandBufferPool.h"
+#include "PipelineCache.h"
 
 struct SwapChainSupportDetails {
     VkSurfaceCapabilitiesKHR capabilities;
@@ -53,6 +57,11 @@ public:
     GLFWwindow* getWindow() const { return _window; }
     const QueueFamilyIndices& getQueueFamilyIndices() const { return _queueFamilyIndices; }
     VkSampleCountFlagBits getMsaaSamples() const { return _msaaSamples; }
+    VulkanMemoryAllocator& getAllocator() const { return *_allocator; }
+    // 图形队列族的命令缓冲区回收池，一次性命令都从这里取
+    CommandBufferPool& getCommandBufferPool() const { return *_commandBufferPool; }
+    // 所有管线创建共用的持久化管线缓存，启动时从磁盘加载，析构时写回
+    PipelineCache& getPipelineCache() const { return *_pipelineCache; }
 
     // --- 底层辅助函数 ---
     std::vector<char> readFile(const std::string& filename) const;
@@ -60,25 +69,34 @@ public:
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
     
     // 用于资源创建的辅助函数
-    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory) const;
-    void createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory) const;
-    VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels = 1) const;
+    // 内存通过 VulkanMemoryAllocator 子分配，释放时调用 getAllocator().free(allocation)
+    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VulkanAllocation& allocation) const;
+    void createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VulkanAllocation& allocation, uint32_t arrayLayers = 1, VkImageCreateFlags flags = 0) const;
+    // viewUsage 非 0 时通过 VkImageViewUsageCreateInfo 收窄视图的用途（图像带 EXTENDED_USAGE 且视图格式不支持全部用途时需要）
+    VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels = 1, VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D,
+        uint32_t layerCount = 1, uint32_t baseMipLevel = 0, VkImageUsageFlags viewUsage = 0) const;
 
-    // 用于一次性命令的辅助函数 (注意：需要调用者提供 Command Pool 和 Queue)
-    VkCommandBuffer beginSingleTimeCommands(VkCommandPool commandPool) const;
-    void endSingleTimeCommands(VkCommandBuffer commandBuffer, VkQueue queue, VkCommandPool commandPool) const;
+    // 用于一次性命令的辅助函数 (命令缓冲区来自 getCommandBufferPool()，Queue 必须属于图形队列族)
+    VkCommandBuffer beginSingleTimeCommands() const;
+    void endSingleTimeCommands(VkCommandBuffer commandBuffer, VkQueue queue) const;
 
     // --- 资源操作辅助函数 ---
-    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkQueue queue, VkCommandPool commandPool) const;
-    void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkQueue queue, VkCommandPool commandPool) const;
-    void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, VkQueue queue, VkCommandPool commandPool) const;
-    void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels, VkQueue queue, VkCommandPool commandPool) const;
+    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkQueue queue) const;
+    void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkQueue queue) const;
+    void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, VkQueue queue) const;
+    void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels, VkQueue queue) const;
     
     // --- 查询函数 ---
     SwapChainSupportDetails querySwapChainSupport() const;
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) const;
     VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
     VkFormat findDepthFormat() const;
+    // 可选设备扩展（如 VK_KHR_push_descriptor）是否已启用
+    bool isDeviceExtensionEnabled(const std::string& name) const { return _enabledOptionalExtensions.count(name) > 0; }
+    // 创建逻辑设备时实际启用的核心特性（multiDrawIndirect 等按设备支持情况开启）
+    const VkPhysicalDeviceFeatures& getEnabledFeatures() const { return _enabledFeatures; }
+    // VK_EXT_extended_dynamic_state3 中实际启用的状态（未启用该扩展时全为 VK_FALSE）
+    const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& getExtendedDynamicState3Features() const { return _extendedDynamicState3Features; }
 
 
 public:
@@ -121,4 +139,11 @@ private:
 
     QueueFamilyIndices _queueFamilyIndices;
     VkSampleCountFlagBits _msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    std::unique_ptr<VulkanMemoryAllocator> _allocator;
+    std::unique_ptr<CommandBufferPool> _commandBufferPool;
+    std::unique_ptr<PipelineCache> _pipelineCache;
+    std::set<std::string> _enabledOptionalExtensions;
+    VkPhysicalDeviceFeatures _enabledFeatures{};
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT _extendedDynamicState3Features{};
 };
@@ -3,82 +3,223 @@
 #include <stdexcept>
 #include <cmath>
 #include <algorithm>
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include <cstring>
+#include "ImageDecoder.h"
+#include "Ktx2File.h"
+#include "BCDecoder.h"
+#include "MipmapGenerator.h"
+#include <vector>
 
 // 构造函数和析构函数保持不变
-VulkanImage::VulkanImage(VulkanContext& context, VkFormat format, VkExtent3D extent, uint32_t mipLevels, VkImageUsageFlags usage, VkMemoryPropertyFlags properties)
-    : _context(context), _format(format), _extent(extent), _layout(VK_IMAGE_LAYOUT_UNDEFINED), _mipLevels(mipLevels) {
+VulkanImage::VulkanImage(VulkanContext& context, VkFormat format, VkExtent3D extent, uint32_t mipLevels, VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+    uint32_t arrayLayers, VkImageCreateFlags createFlags)
+    : _context(context), _format(format), _extent(extent), _layout(VK_IMAGE_LAYOUT_UNDEFINED), _mipLevels(mipLevels),
+      _arrayLayers(arrayLayers), _createFlags(createFlags) {
     
-    context.createImage(_extent.width, _extent.height, _mipLevels, VK_SAMPLE_COUNT_1_BIT, _format, VK_IMAGE_TILING_OPTIMAL, usage, properties, _image, _memory);
+    context.createImage(_extent.width, _extent.height, _mipLevels, VK_SAMPLE_COUNT_1_BIT, _format, VK_IMAGE_TILING_OPTIMAL, usage, properties, _image, _allocation,
+        _arrayLayers, _createFlags);
 }
 
 VulkanImage::~VulkanImage() {
     VkDevice device = _context.getDevice();
     if (_sampler != VK_NULL_HANDLE) vkDestroySampler(device, _sampler, nullptr);
     if (_view != VK_NULL_HANDLE) vkDestroyImageView(device, _view, nullptr);
+    for (VkImageView view : _mipViews) vkDestroyImageView(device, view, nullptr);
     if (_image != VK_NULL_HANDLE) vkDestroyImage(device, _image, nullptr);
-    if (_memory != VK_NULL_HANDLE) vkFreeMemory(device, _memory, nullptr);
+    _context.getAllocator().free(_allocation);
 }
 
 
 // --- 静态工厂函数 (已重构) ---
 
 std::unique_ptr<VulkanImage> VulkanImage::createTextureFromFile(VulkanContext& context, ImmediateSubmitter& uploader, const std::string& path) {
-    int texWidth, texHeight, texChannels;
-    stbi_uc* pixels = stbi_load(path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-    if (!pixels) {
+    // 1. 先读文件头拿到尺寸，从 uploader 的暂存环中申请空间
+    ImageDecoder::Info info;
+    if (!ImageDecoder::readInfo(path, info)) {
         throw std::runtime_error("failed to load texture image from path: " + path);
     }
-    VkDeviceSize imageSize = texWidth * texHeight * 4;
-
-    // 1. 创建暂存缓冲区
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    context.createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-
-    // 2. 映射并拷贝像素数据
-    void* data;
-    vkMapMemory(context.getDevice(), stagingBufferMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, static_cast<size_t>(imageSize));
-    vkUnmapMemory(context.getDevice(), stagingBufferMemory);
-    stbi_image_free(pixels);
-
-    // 3. 创建最终的Image对象
-    VkExtent3D extent = { (uint32_t)texWidth, (uint32_t)texHeight, 1 };
-    uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
-    
-    auto vulkanImage = std::unique_ptr<VulkanImage>(new VulkanImage(context, VK_FORMAT_R8G8B8A8_SRGB, extent, mipLevels,
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+    StagingRing::Allocation staging = uploader.allocateStaging(info.decodeSize());
+
+    // 2. 直接解码进持久映射的暂存内存，不经过中间的堆缓冲区
+    if (!ImageDecoder::decodeRGBA8Into(path, staging.data, info.decodeSize(), info)) {
+        throw std::runtime_error("failed to load texture image from path: " + path);
+    }
+
+    return createTextureFromStaging(context, uploader, staging, info.width, info.height);
+}
+
+std::unique_ptr<VulkanImage> VulkanImage::createTextureFromPixels(VulkanContext& context, ImmediateSubmitter& uploader, const void* pixels, uint32_t width, uint32_t height) {
+    VkDeviceSize imageSize = static_cast<VkDeviceSize>(width) * height * 4;
+    StagingRing::Allocation staging = uploader.allocateStaging(imageSize);
+    memcpy(staging.data, pixels, static_cast<size_t>(imageSize));
+    return createTextureFromStaging(context, uploader, staging, width, height);
+}
+
+std::unique_ptr<VulkanImage> VulkanImage::createTextureFromStaging(VulkanContext& context, ImmediateSubmitter& uploader, const StagingRing::Allocation& staging, uint32_t width, uint32_t height,
+    VkFormat format, uint32_t layerCount, bool cubemap) {
+    // 1. 按格式选择 mip 生成路径，计算路径需要额外的 usage / flags
+    MipmapGenerator* mipmaps = uploader.getMipmapGenerator();
+    MipmapGenerator::Path path = MipmapGenerator::selectPath(context, mipmaps, format, width, height, layerCount);
+
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    VkImageCreateFlags createFlags = cubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+    if (path == MipmapGenerator::Path::Compute) {
+        usage |= MipmapGenerator::getComputeImageUsage();
+        createFlags |= MipmapGenerator::getComputeImageFlags(format);
+    }
+
+    // 创建最终的Image对象
+    VkExtent3D extent = { width, height, 1 };
+    uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
     
-    // 4. 使用 Uploader 来执行所有GPU操作
+    auto vulkanImage = std::unique_ptr<VulkanImage>(new VulkanImage(context, format, extent, mipLevels, usage,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, layerCount, createFlags));
+
+    // 2. mip0 直接来自调用方的暂存区
+    std::vector<VkBufferImageCopy> regions(1);
+    regions[0].bufferOffset = staging.offset;
+    regions[0].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    regions[0].imageSubresource.layerCount = layerCount;
+    regions[0].imageExtent = extent;
+
+    // 3. CPU 路径：在上传前生成其余各级，放进另一段暂存区，与 mip0 一起拷贝
+    StagingRing::Allocation chainStaging{};
+    if (path == MipmapGenerator::Path::Cpu && mipLevels > 1) {
+        VkDeviceSize chainSize = MipmapGenerator::getCpuChainSize(format, width, height, mipLevels, layerCount);
+        std::vector<uint8_t> chain(static_cast<size_t>(chainSize));
+        std::vector<VkDeviceSize> levelOffsets;
+        MipmapGenerator::generateOnCpu(format, staging.data, width, height, mipLevels, layerCount, chain.data(), levelOffsets);
+
+        chainStaging = uploader.allocateStaging(chainSize);
+        memcpy(chainStaging.data, chain.data(), chain.size());
+        for (uint32_t level = 1; level < mipLevels; ++level) {
+            VkBufferImageCopy region = regions[0];
+            region.bufferOffset = chainStaging.offset + levelOffsets[level - 1];
+            region.imageSubresource.mipLevel = level;
+            region.imageExtent = { std::max(1u, width >> level), std::max(1u, height >> level), 1 };
+            regions.push_back(region);
+        }
+    }
+
+    // 使用 Uploader 来执行所有GPU操作
     uploader.submit([&](VkCommandBuffer cmd) {
         // 转换布局以准备接收数据
         vulkanImage->recordTransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-        // 拷贝数据
-        VkBufferImageCopy region{};
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.layerCount = 1;
-        region.imageExtent = extent;
-        vkCmdCopyBufferToImage(cmd, stagingBuffer, vulkanImage->_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+        // 拷贝数据：CPU 路径下所有级别来自同一个 buffer
+        if (regions.size() == 1 || chainStaging.buffer == staging.buffer) {
+            vkCmdCopyBufferToImage(cmd, staging.buffer, vulkanImage->_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<uint32_t>(regions.size()), regions.data());
+        } else {
+            vkCmdCopyBufferToImage(cmd, staging.buffer, vulkanImage->_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, regions.data());
+            vkCmdCopyBufferToImage(cmd, chainStaging.buffer, vulkanImage->_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<uint32_t>(regions.size() - 1), regions.data() + 1);
+        }
 
         // 生成 Mipmaps (这会将最终布局设置为 SHADER_READ_ONLY_OPTIMAL)
-        vulkanImage->recordGenerateMipmaps(cmd);
+        switch (path) {
+            case MipmapGenerator::Path::Compute:
+                mipmaps->recordCompute(cmd, *vulkanImage);
+                break;
+            case MipmapGenerator::Path::Blit:
+                vulkanImage->recordGenerateMipmaps(cmd);
+                break;
+            case MipmapGenerator::Path::Cpu:
+                vulkanImage->recordTransitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                break;
+        }
     });
 
-    // 5. 清理暂存缓冲区
-    vkDestroyBuffer(context.getDevice(), stagingBuffer, nullptr);
-    vkFreeMemory(context.getDevice(), stagingBufferMemory, nullptr);
-
-    // 6. 创建 ImageView 和 Sampler (这些是纯CPU操作)
+    // 创建 ImageView 和 Sampler (这些是纯CPU操作)
     vulkanImage->createImageView(VK_IMAGE_ASPECT_COLOR_BIT);
     vulkanImage->createSampler();
 
     return vulkanImage;
 }
 
+std::unique_ptr<VulkanImage> VulkanImage::createCubemapFromPixels(VulkanContext& context, ImmediateSubmitter& uploader, const void* const faces[6], uint32_t size, VkFormat format) {
+    VkDeviceSize faceSize = static_cast<VkDeviceSize>(size) * size * MipmapGenerator::getTexelSize(format);
+    if (faceSize == 0) {
+        throw std::runtime_error("unsupported cubemap format!");
+    }
+    StagingRing::Allocation staging = uploader.allocateStaging(faceSize * 6);
+    for (uint32_t face = 0; face < 6; ++face) {
+        memcpy(static_cast<uint8_t*>(staging.data) + face * faceSize, faces[face], static_cast<size_t>(faceSize));
+    }
+    return createTextureFromStaging(context, uploader, staging, size, size, format, 6, true);
+}
+
+std::unique_ptr<VulkanImage> VulkanImage::createTextureFromKTX2(VulkanContext& context, ImmediateSubmitter& uploader, const std::string& path) {
+    Ktx2File file(path);
+    VkFormat fileFormat = file.getFormat();
+    Ktx2File::FormatInfo formatInfo;
+    if (!Ktx2File::getFormatInfo(fileFormat, formatInfo)) {
+        throw std::runtime_error("unsupported KTX2 format in: " + path);
+    }
+
+    // 1. 设备能直接采样（并线性过滤）该格式时原样上传；否则尝试 CPU 解压为 RGBA8
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(context.getPhysicalDevice(), fileFormat, &formatProperties);
+    const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    bool nativeSupport = (formatProperties.optimalTilingFeatures & required) == required;
+    if (!nativeSupport && !BCDecoder::canDecode(fileFormat)) {
+        throw std::runtime_error("texture format is not supported by the device and has no CPU fallback: " + path);
+    }
+    VkFormat imageFormat = nativeSupport ? fileFormat : BCDecoder::getDecodedFormat(fileFormat, formatInfo.isSrgb);
+
+    // 2. 计算每一级在暂存区中的偏移（对齐到 16，满足块大小与 4 字节对齐的要求）
+    uint32_t levelCount = file.getLevelCount();
+    std::vector<VkDeviceSize> offsets(levelCount);
+    VkDeviceSize stagingSize = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        offsets[level] = stagingSize;
+        VkDeviceSize levelSize = nativeSupport
+            ? file.getLevel(level).byteLength
+            : static_cast<VkDeviceSize>(file.getLevelWidth(level)) * file.getLevelHeight(level) * 4;
+        stagingSize += (levelSize + 15) & ~VkDeviceSize(15);
+    }
+    StagingRing::Allocation staging = uploader.allocateStaging(stagingSize);
+    uint8_t* stagingData = static_cast<uint8_t*>(staging.data);
+
+    // 3. 原生格式直接从文件读进暂存区；回退路径先读到临时内存再解压
+    std::vector<uint8_t> compressed;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        if (nativeSupport) {
+            file.readLevel(level, stagingData + offsets[level]);
+        } else {
+            compressed.resize(file.getLevel(level).byteLength);
+            file.readLevel(level, compressed.data());
+            BCDecoder::decodeToRGBA8(fileFormat, compressed.data(), file.getLevelWidth(level), file.getLevelHeight(level), stagingData + offsets[level]);
+        }
+    }
+
+    VkExtent3D extent = { file.getWidth(), file.getHeight(), 1 };
+    auto vulkanImage = std::unique_ptr<VulkanImage>(new VulkanImage(context, imageFormat, extent, levelCount,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+
+    // 4. 一次拷贝所有 mip 级
+    std::vector<VkBufferImageCopy> regions(levelCount);
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        VkBufferImageCopy& region = regions[level];
+        region.bufferOffset = staging.offset + offsets[level];
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { file.getLevelWidth(level), file.getLevelHeight(level), 1 };
+    }
+    uploader.submit([&](VkCommandBuffer cmd) {
+        vulkanImage->recordTransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        vkCmdCopyBufferToImage(cmd, staging.buffer, vulkanImage->_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(regions.size()), regions.data());
+        vulkanImage->recordTransitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    });
+
+    vulkanImage->createImageView(VK_IMAGE_ASPECT_COLOR_BIT);
+    vulkanImage->createSampler();
+    return vulkanImage;
+}
+
 std::unique_ptr<VulkanImage> VulkanImage::create2DImage(VulkanContext& context, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImageAspectFlags aspectFlags) {
     VkExtent3D extent3D = { extent.width, extent.height, 1 };
     auto vulkanImage = std::unique_ptr<VulkanImage>(new VulkanImage(context, format, extent3D, 1, usage, properties));
@@ -124,7 +265,7 @@ void VulkanImage::recordTransitionLayout(VkCommandBuffer cmd, VkImageLayout newL
     barrier.subresourceRange.baseMipLevel = 0;
     barrier.subresourceRange.levelCount = _mipLevels;
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = _arrayLayers;
     barrier.srcAccessMask = sourceAccessMask;
     barrier.dstAccessMask = destinationAccessMask;
 
@@ -136,7 +277,12 @@ void VulkanImage::recordTransitionLayout(VkCommandBuffer cmd, VkImageLayout newL
 // --- 内部辅助函数 ---
 
 void VulkanImage::createImageView(VkImageAspectFlags aspectFlags) {
-    _view = _context.createImageView(_image, _format, aspectFlags, _mipLevels);
+    VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D;
+    if (isCubemap() && _arrayLayers == 6) viewType = VK_IMAGE_VIEW_TYPE_CUBE;
+    else if (_arrayLayers > 1) viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    // 计算路径的图像带 STORAGE 用途，SRGB 视图本身不支持存储，需要收窄为只读采样
+    VkImageUsageFlags viewUsage = (_createFlags & VK_IMAGE_CREATE_EXTENDED_USAGE_BIT) ? VK_IMAGE_USAGE_SAMPLED_BIT : 0;
+    _view = _context.createImageView(_image, _format, aspectFlags, _mipLevels, viewType, _arrayLayers, 0, viewUsage);
 }
 
 void VulkanImage::createSampler() {
@@ -181,7 +327,7 @@ void VulkanImage::recordGenerateMipmaps(VkCommandBuffer cmd) {
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = _arrayLayers;
     barrier.subresourceRange.levelCount = 1;
 
     int32_t mipWidth = _extent.width;
@@ -202,13 +348,13 @@ void VulkanImage::recordGenerateMipmaps(VkCommandBuffer cmd) {
         blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         blit.srcSubresource.mipLevel = i - 1;
         blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
+        blit.srcSubresource.layerCount = _arrayLayers;
         blit.dstOffsets[0] = { 0, 0, 0 };
         blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
         blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         blit.dstSubresource.mipLevel = i;
         blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
+        blit.dstSubresource.layerCount = _arrayLayers;
 
         vkCmdBlitImage(cmd, _image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
 
@@ -1,7 +1,9 @@
 #pragma once
 #include "VulkanContext.h"
+#include "StagingRing.h"
 #include <string>
 #include <memory>
+#include <vector>
 
 // 前向声明，以避免在头文件中包含 ImmediateSubmitter.h
 class ImmediateSubmitter;
@@ -17,6 +19,47 @@ public:
         const std::string& path
     );
 
+    // 从已解码的 RGBA8 像素创建纹理（生成完整 mip 链）。
+    // uploader 处于批处理模式时只记录命令，图像在该批次完成之前不可采样
+    static std::unique_ptr<VulkanImage> createTextureFromPixels(
+        VulkanContext& context,
+        ImmediateSubmitter& uploader,
+        const void* pixels,
+        uint32_t width,
+        uint32_t height
+    );
+
+    // 从已经写好 mip0 像素的暂存区创建纹理，调用方负责保证该暂存区在上传完成前有效。
+    // layerCount > 1 时各层紧密相连；cubemap 为 true 时需要 6 层，按 +X,-X,+Y,-Y,+Z,-Z 排列。
+    // mip 链按格式由 MipmapGenerator 选择计算着色器、blit 或 CPU 路径生成
+    static std::unique_ptr<VulkanImage> createTextureFromStaging(
+        VulkanContext& context,
+        ImmediateSubmitter& uploader,
+        const StagingRing::Allocation& staging,
+        uint32_t width,
+        uint32_t height,
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB,
+        uint32_t layerCount = 1,
+        bool cubemap = false
+    );
+
+    // 从 6 个面的像素创建立方体贴图（生成完整 mip 链）
+    static std::unique_ptr<VulkanImage> createCubemapFromPixels(
+        VulkanContext& context,
+        ImmediateSubmitter& uploader,
+        const void* const faces[6],
+        uint32_t size,
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB
+    );
+
+    // 从 KTX2 文件加载纹理，直接上传文件中预先生成的 mip 链（BC/ASTC 块或 RGBA8），不做运行时 blit。
+    // 设备不支持该压缩格式时，BC1-BC5 在 CPU 上解压为 RGBA8，其余格式抛出异常
+    static std::unique_ptr<VulkanImage> createTextureFromKTX2(
+        VulkanContext& context,
+        ImmediateSubmitter& uploader,
+        const std::string& path
+    );
+
     // 创建通用的2D图像（如颜色/深度附件）
     static std::unique_ptr<VulkanImage> create2DImage(
         VulkanContext& context, 
@@ -46,11 +89,19 @@ public:
     VkFormat getFormat() const { return _format; }
     VkExtent2D getExtent2D() const { return {_extent.width, _extent.height}; }
     VkImageLayout getLayout() const { return _layout; }
+    uint32_t getMipLevels() const { return _mipLevels; }
+    uint32_t getArrayLayers() const { return _arrayLayers; }
+    bool isCubemap() const { return (_createFlags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) != 0; }
+    // 布局转换由外部记录时（例如 AsyncUploader），用它同步这里记录的布局
+    void setLayout(VkImageLayout layout) { _layout = layout; }
     VkDescriptorImageInfo GetDescriptorInfo() { return {_sampler, _view, _layout}; }
 
 private:
+    friend class MipmapGenerator;
+
     // 构造函数保持私有，强制使用工厂函数
-    VulkanImage(VulkanContext& context, VkFormat format, VkExtent3D extent, uint32_t mipLevels, VkImageUsageFlags usage, VkMemoryPropertyFlags properties);
+    VulkanImage(VulkanContext& context, VkFormat format, VkExtent3D extent, uint32_t mipLevels, VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+        uint32_t arrayLayers = 1, VkImageCreateFlags createFlags = 0);
     
     // 内部辅助函数
     void createImageView(VkImageAspectFlags aspectFlags);
@@ -59,7 +110,7 @@ private:
 
     VulkanContext& _context;
     VkImage _image = VK_NULL_HANDLE;
-    VkDeviceMemory _memory = VK_NULL_HANDLE;
+    VulkanAllocation _allocation;
     VkImageView _view = VK_NULL_HANDLE;
     VkSampler _sampler = VK_NULL_HANDLE;
 
@@ -67,4 +118,7 @@ private:
     VkExtent3D _extent;
     VkImageLayout _layout;
     uint32_t _mipLevels;
+    uint32_t _arrayLayers;
+    VkImageCreateFlags _createFlags;
+    std::vector<VkImageView> _mipViews; // MipmapGenerator 按级创建的视图，随图像一起销毁
 };
\ No newline at end of file
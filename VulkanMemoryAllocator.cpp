@@ -0,0 +1,356 @@
+#include "VulkanMemoryAllocator.h"
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+
+// ======================================================================
+// ---                        MemoryBlock 实现                        ---
+// ======================================================================
+
+MemoryBlock::MemoryBlock(VkDevice device, VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, void* mappedData)
+    : _device(device), _memory(memory), _size(size), _memoryTypeIndex(memoryTypeIndex), _mappedData(mappedData), _freeBytes(size) {
+    _maxOrder = orderForSize(size);
+    _freeLists.resize(_maxOrder + 1);
+    _freeLists[_maxOrder].insert(0);
+}
+
+MemoryBlock::~MemoryBlock() {
+    if (_mappedData) {
+        vkUnmapMemory(_device, _memory);
+    }
+    vkFreeMemory(_device, _memory, nullptr);
+}
+
+uint32_t MemoryBlock::orderForSize(VkDeviceSize size) {
+    uint32_t order = 0;
+    while (nodeSize(order) < size) {
+        order++;
+    }
+    return order;
+}
+
+bool MemoryBlock::allocate(uint32_t order, VkDeviceSize& offset) {
+    if (order > _maxOrder) return false;
+
+    // 找到第一个不小于需求的空闲节点
+    uint32_t current = order;
+    while (current <= _maxOrder && _freeLists[current].empty()) {
+        current++;
+    }
+    if (current > _maxOrder) return false;
+
+    offset = *_freeLists[current].begin();
+    _freeLists[current].erase(_freeLists[current].begin());
+
+    // 逐级对半拆分，右半部分挂回空闲链表
+    while (current > order) {
+        current--;
+        _freeLists[current].insert(offset + nodeSize(current));
+    }
+
+    _freeBytes -= nodeSize(order);
+    return true;
+}
+
+void MemoryBlock::free(VkDeviceSize offset, uint32_t order) {
+    _freeBytes += nodeSize(order);
+
+    // 伙伴也空闲时向上合并
+    while (order < _maxOrder) {
+        VkDeviceSize buddy = offset ^ nodeSize(order);
+        auto it = _freeLists[order].find(buddy);
+        if (it == _freeLists[order].end()) break;
+        _freeLists[order].erase(it);
+        offset = std::min(offset, buddy);
+        order++;
+    }
+    _freeLists[order].insert(offset);
+}
+
+VkDeviceSize MemoryBlock::getLargestFreeNode() const {
+    for (uint32_t order = _maxOrder + 1; order-- > 0;) {
+        if (!_freeLists[order].empty()) return nodeSize(order);
+    }
+    return 0;
+}
+
+
+// ======================================================================
+// ---                   VulkanMemoryAllocator 实现                   ---
+// ======================================================================
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize preferredBlockSize)
+    : _device(device) {
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &_memoryProperties);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    _bufferImageGranularity = properties.limits.bufferImageGranularity;
+    _maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+
+    // 块大小取 2 的幂，伙伴系统要求
+    _preferredBlockSize = MemoryBlock::kMinNodeSize;
+    while (_preferredBlockSize < preferredBlockSize) {
+        _preferredBlockSize <<= 1;
+    }
+
+    _pools.resize(_memoryProperties.memoryTypeCount * 2);
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+    if (_allocationCount > 0) {
+        std::cerr << "[WARNING] VulkanMemoryAllocator destroyed with " << _allocationCount << " live allocations." << std::endl;
+    }
+    _pools.clear();
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties) {
+    VkBufferMemoryRequirementsInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+    info.buffer = buffer;
+
+    VkMemoryDedicatedRequirements dedicatedRequirements{};
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicatedRequirements;
+    vkGetBufferMemoryRequirements2(_device, &info, &requirements);
+
+    bool dedicated = dedicatedRequirements.requiresDedicatedAllocation || dedicatedRequirements.prefersDedicatedAllocation;
+    VulkanAllocation allocation = allocate(requirements.memoryRequirements, properties, true, dedicated, buffer, VK_NULL_HANDLE);
+
+    if (vkBindBufferMemory(_device, buffer, allocation.memory, allocation.offset) != VK_SUCCESS) {
+        free(allocation);
+        throw std::runtime_error("failed to bind buffer memory!");
+    }
+    return allocation;
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocateImageMemory(VkImage image, VkMemoryPropertyFlags properties, VkImageTiling tiling) {
+    VkImageMemoryRequirementsInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+    info.image = image;
+
+    VkMemoryDedicatedRequirements dedicatedRequirements{};
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicatedRequirements;
+    vkGetImageMemoryRequirements2(_device, &info, &requirements);
+
+    bool dedicated = dedicatedRequirements.requiresDedicatedAllocation || dedicatedRequirements.prefersDedicatedAllocation;
+    VulkanAllocation allocation = allocate(requirements.memoryRequirements, properties, tiling == VK_IMAGE_TILING_LINEAR, dedicated, VK_NULL_HANDLE, image);
+
+    if (vkBindImageMemory(_device, image, allocation.memory, allocation.offset) != VK_SUCCESS) {
+        free(allocation);
+        throw std::runtime_error("failed to bind image memory!");
+    }
+    return allocation;
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear, bool dedicated, VkBuffer buffer, VkImage image) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    uint32_t memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, properties);
+    VkDeviceSize blockSize = blockSizeForType(memoryTypeIndex);
+
+    // 大资源（例如高分辨率纹理）单独分配，避免把整块占满或产生大量浪费
+    if (dedicated || requirements.size > blockSize / 2) {
+        return allocateDedicated(requirements, memoryTypeIndex, buffer, image);
+    }
+
+    uint32_t order = MemoryBlock::orderForSize(std::max(requirements.size, requirements.alignment));
+    Pool& pool = _pools[poolIndex(memoryTypeIndex, linear)];
+
+    VulkanAllocation allocation{};
+    if (!allocateFromPool(pool, memoryTypeIndex, order, allocation)) {
+        // 现有块都放不下，申请一个新块；显存紧张时逐级减半重试
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = blockSize;
+        VkDeviceSize minSize = MemoryBlock::nodeSize(order);
+        while (size >= minSize) {
+            memory = allocateDeviceMemory(size, memoryTypeIndex, nullptr);
+            if (memory != VK_NULL_HANDLE) break;
+            size /= 2;
+        }
+        if (memory == VK_NULL_HANDLE) {
+            throw std::runtime_error("failed to allocate device memory block!");
+        }
+
+        void* mapped = nullptr;
+        if (isHostVisible(memoryTypeIndex)) {
+            vkMapMemory(_device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+        }
+        pool.blocks.push_back(std::make_unique<MemoryBlock>(_device, memory, size, memoryTypeIndex, mapped));
+
+        if (!allocateFromPool(pool, memoryTypeIndex, order, allocation)) {
+            throw std::runtime_error("failed to sub-allocate from a fresh memory block!");
+        }
+    }
+
+    allocation.size = requirements.size;
+    _allocationCount++;
+    _usedBytes += requirements.size;
+    _wastedBytes += MemoryBlock::nodeSize(order) - requirements.size;
+    return allocation;
+}
+
+bool VulkanMemoryAllocator::allocateFromPool(Pool& pool, uint32_t memoryTypeIndex, uint32_t order, VulkanAllocation& allocation) {
+    for (auto& block : pool.blocks) {
+        VkDeviceSize offset;
+        if (block->allocate(order, offset)) {
+            allocation.memory = block->getMemory();
+            allocation.offset = offset;
+            allocation.memoryTypeIndex = memoryTypeIndex;
+            allocation.block = block.get();
+            allocation.order = order;
+            allocation.mappedData = block->getMappedData() ? static_cast<char*>(block->getMappedData()) + offset : nullptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocateDedicated(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, VkBuffer buffer, VkImage image) {
+    VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+    dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicatedInfo.buffer = buffer;
+    dedicatedInfo.image = image;
+
+    VkDeviceMemory memory = allocateDeviceMemory(requirements.size, memoryTypeIndex, &dedicatedInfo);
+    if (memory == VK_NULL_HANDLE) {
+        throw std::runtime_error("failed to allocate dedicated device memory!");
+    }
+
+    VulkanAllocation allocation{};
+    allocation.memory = memory;
+    allocation.offset = 0;
+    allocation.size = requirements.size;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    if (isHostVisible(memoryTypeIndex)) {
+        vkMapMemory(_device, memory, 0, VK_WHOLE_SIZE, 0, &allocation.mappedData);
+    }
+
+    _dedicatedCount++;
+    _dedicatedBytes += requirements.size;
+    _allocationCount++;
+    _usedBytes += requirements.size;
+    return allocation;
+}
+
+VkDeviceMemory VulkanMemoryAllocator::allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, const void* pNext) {
+    if (_deviceMemoryCount >= _maxAllocationCount) {
+        throw std::runtime_error("maxMemoryAllocationCount exceeded!");
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.pNext = pNext;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (vkAllocateMemory(_device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    _deviceMemoryCount++;
+    return memory;
+}
+
+void VulkanMemoryAllocator::free(VulkanAllocation& allocation) {
+    if (!allocation.isValid()) return;
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (allocation.block == nullptr) {
+        if (allocation.mappedData) {
+            vkUnmapMemory(_device, allocation.memory);
+        }
+        vkFreeMemory(_device, allocation.memory, nullptr);
+        _deviceMemoryCount--;
+        _dedicatedCount--;
+        _dedicatedBytes -= allocation.size;
+    } else {
+        MemoryBlock* block = allocation.block;
+        block->free(allocation.offset, allocation.order);
+        _wastedBytes -= MemoryBlock::nodeSize(allocation.order) - allocation.size;
+
+        // 每个池最多保留一个空块，其余归还驱动
+        if (block->isEmpty()) {
+            for (auto& pool : _pools) {
+                auto it = std::find_if(pool.blocks.begin(), pool.blocks.end(), [block](const auto& b) { return b.get() == block; });
+                if (it == pool.blocks.end()) continue;
+                size_t emptyCount = std::count_if(pool.blocks.begin(), pool.blocks.end(), [](const auto& b) { return b->isEmpty(); });
+                if (emptyCount > 1) {
+                    pool.blocks.erase(it);
+                    _deviceMemoryCount--;
+                }
+                break;
+            }
+        }
+    }
+
+    _allocationCount--;
+    _usedBytes -= allocation.size;
+    allocation = VulkanAllocation{};
+}
+
+VulkanMemoryAllocator::Stats VulkanMemoryAllocator::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Stats stats{};
+    VkDeviceSize largestFree = 0;
+    for (const auto& pool : _pools) {
+        for (const auto& block : pool.blocks) {
+            stats.blockCount++;
+            stats.reservedBytes += block->getSize();
+            stats.freeBytes += block->getFreeBytes();
+            largestFree = std::max(largestFree, block->getLargestFreeNode());
+        }
+    }
+    stats.dedicatedCount = _dedicatedCount;
+    stats.allocationCount = _allocationCount;
+    stats.reservedBytes += _dedicatedBytes;
+    stats.usedBytes = _usedBytes;
+    stats.wastedBytes = _wastedBytes;
+    stats.fragmentation = stats.freeBytes > 0 ? 1.0f - static_cast<float>(largestFree) / static_cast<float>(stats.freeBytes) : 0.0f;
+    return stats;
+}
+
+void VulkanMemoryAllocator::printStats() const {
+    Stats stats = getStats();
+    std::cout << "[INFO] Device memory: " << stats.blockCount << " blocks, "
+              << stats.dedicatedCount << " dedicated, "
+              << stats.allocationCount << " allocations, "
+              << (stats.usedBytes >> 10) << " KB used / " << (stats.reservedBytes >> 10) << " KB reserved, "
+              << (stats.wastedBytes >> 10) << " KB wasted, "
+              << "fragmentation " << stats.fragmentation * 100.0f << "%" << std::endl;
+}
+
+uint32_t VulkanMemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) && (_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    throw std::runtime_error("failed to find suitable memory type!");
+}
+
+VkDeviceSize VulkanMemoryAllocator::blockSizeForType(uint32_t memoryTypeIndex) const {
+    // 小堆（例如 256MB 的 BAR 区域）上块不宜过大，限制为堆大小的 1/8
+    VkDeviceSize heapSize = _memoryProperties.memoryHeaps[_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+    VkDeviceSize size = _preferredBlockSize;
+    while (size > MemoryBlock::kMinNodeSize && size > heapSize / 8) {
+        size >>= 1;
+    }
+    return size;
+}
+
+uint32_t VulkanMemoryAllocator::poolIndex(uint32_t memoryTypeIndex, bool linear) const {
+    // 节点最小 256 字节且按自身大小对齐；granularity 不超过它时不同节点永远不会共享 page
+    bool separate = _bufferImageGranularity > MemoryBlock::kMinNodeSize;
+    return memoryTypeIndex * 2 + ((separate && !linear) ? 1 : 0);
+}
+
+bool VulkanMemoryAllocator::isHostVisible(uint32_t memoryTypeIndex) const {
+    return (_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
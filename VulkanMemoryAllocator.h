@@ -0,0 +1,138 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <set>
+#include <memory>
+#include <mutex>
+
+class MemoryBlock;
+
+// 一次分配的结果。资源只需要 memory + offset 就能绑定，其余字段供分配器回收时使用
+struct VulkanAllocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;          // 资源实际请求的大小
+    void* mappedData = nullptr;     // HOST_VISIBLE 内存的持久映射地址（已加上 offset）
+    uint32_t memoryTypeIndex = 0;
+
+    // --- 分配器内部簿记 ---
+    MemoryBlock* block = nullptr;   // 为 nullptr 表示独立分配（dedicated）
+    uint32_t order = 0;             // 伙伴系统中节点的阶
+
+    bool isValid() const { return memory != VK_NULL_HANDLE; }
+};
+
+/*
+ * @class MemoryBlock
+ * @brief 一整块 VkDeviceMemory，内部用伙伴系统（buddy）切分。
+ *
+ * 节点大小为 kMinNodeSize << order，节点偏移天然按自身大小对齐，
+ * 因此只要节点不小于资源的 alignment，就不需要额外的对齐填充。
+ */
+class MemoryBlock {
+public:
+    static constexpr VkDeviceSize kMinNodeSize = 256;
+
+    MemoryBlock(VkDevice device, VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, void* mappedData);
+    ~MemoryBlock();
+
+    MemoryBlock(const MemoryBlock&) = delete;
+    MemoryBlock& operator=(const MemoryBlock&) = delete;
+
+    // 分配一个阶为 order 的节点，失败返回 false
+    bool allocate(uint32_t order, VkDeviceSize& offset);
+    void free(VkDeviceSize offset, uint32_t order);
+
+    static VkDeviceSize nodeSize(uint32_t order) { return kMinNodeSize << order; }
+    static uint32_t orderForSize(VkDeviceSize size);
+
+    VkDeviceMemory getMemory() const { return _memory; }
+    VkDeviceSize getSize() const { return _size; }
+    VkDeviceSize getFreeBytes() const { return _freeBytes; }
+    VkDeviceSize getLargestFreeNode() const;
+    uint32_t getMemoryTypeIndex() const { return _memoryTypeIndex; }
+    void* getMappedData() const { return _mappedData; }
+    bool isEmpty() const { return _freeBytes == _size; }
+
+private:
+    VkDevice _device;
+    VkDeviceMemory _memory;
+    VkDeviceSize _size;
+    uint32_t _memoryTypeIndex;
+    uint32_t _maxOrder;
+    void* _mappedData;
+    VkDeviceSize _freeBytes;
+    std::vector<std::set<VkDeviceSize>> _freeLists; // 每个阶一条空闲链表（按偏移排序，便于查找伙伴）
+};
+
+/*
+ * @class VulkanMemoryAllocator
+ * @brief 设备内存子分配器。
+ *
+ * 每种内存类型维护若干大块（默认 64MB），资源从块中以伙伴系统切分，
+ * 避免每个资源一次 vkAllocateMemory 撞上 maxMemoryAllocationCount。
+ * - 线性资源（buffer / 线性 image）与最优排布 image 在 bufferImageGranularity
+ *   大于最小节点时分开放在不同的块里，避免二者落在同一个 "page" 上。
+ * - 驱动建议/要求独立分配，或者超过半个块大小的资源，走 dedicated allocation。
+ * - HOST_VISIBLE 的块在创建时整体持久映射。
+ */
+class VulkanMemoryAllocator {
+public:
+    struct Stats {
+        uint32_t blockCount = 0;          // 子分配大块数量
+        uint32_t dedicatedCount = 0;      // 独立分配数量
+        uint32_t allocationCount = 0;     // 存活的资源分配数量
+        VkDeviceSize reservedBytes = 0;   // 向驱动申请的总字节数
+        VkDeviceSize usedBytes = 0;       // 资源实际请求的字节数
+        VkDeviceSize wastedBytes = 0;     // 节点向上取整造成的内部浪费
+        VkDeviceSize freeBytes = 0;       // 块中尚未使用的字节数
+        float fragmentation = 0.0f;       // 1 - 最大空闲节点 / 总空闲，0 表示没有碎片
+    };
+
+    VulkanMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize preferredBlockSize = 64ull * 1024 * 1024);
+    ~VulkanMemoryAllocator();
+
+    // 禁止拷贝
+    VulkanMemoryAllocator(const VulkanMemoryAllocator&) = delete;
+    VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+
+    // 为资源分配内存并完成绑定
+    VulkanAllocation allocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties);
+    VulkanAllocation allocateImageMemory(VkImage image, VkMemoryPropertyFlags properties, VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL);
+
+    void free(VulkanAllocation& allocation);
+
+    Stats getStats() const;
+    void printStats() const;
+
+private:
+    struct Pool {
+        std::vector<std::unique_ptr<MemoryBlock>> blocks;
+    };
+
+    VulkanAllocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear, bool dedicated, VkBuffer buffer, VkImage image);
+    VulkanAllocation allocateDedicated(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, VkBuffer buffer, VkImage image);
+    bool allocateFromPool(Pool& pool, uint32_t memoryTypeIndex, uint32_t order, VulkanAllocation& allocation);
+    VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, const void* pNext);
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    VkDeviceSize blockSizeForType(uint32_t memoryTypeIndex) const;
+    uint32_t poolIndex(uint32_t memoryTypeIndex, bool linear) const;
+    bool isHostVisible(uint32_t memoryTypeIndex) const;
+
+    VkDevice _device;
+    VkPhysicalDeviceMemoryProperties _memoryProperties{};
+    VkDeviceSize _preferredBlockSize;
+    VkDeviceSize _bufferImageGranularity;
+    uint32_t _maxAllocationCount;
+
+    std::vector<Pool> _pools;                     // 下标见 poolIndex()
+    mutable std::mutex _mutex;
+
+    // 统计
+    uint32_t _deviceMemoryCount = 0;              // 当前存活的 VkDeviceMemory 数量
+    uint32_t _dedicatedCount = 0;
+    uint32_t _allocationCount = 0;
+    VkDeviceSize _dedicatedBytes = 0;
+    VkDeviceSize _usedBytes = 0;
+    VkDeviceSize _wastedBytes = 0;
+};
@@ -1,20 +1,92 @@
 #include "VulkanPipeline.h"
+#include "PipelineRegistry.h"
+#include "VertexCompressor.h"
+#include <algorithm>
+#include <iostream>
 #include <stdexcept>
+#include <string_view>
 #include <vulkan/vulkan.h>
 
+namespace {
+    // 把状态逐字段追加到键中；只用于没有填充字节的 POD 类型
+    template <typename T>
+    void appendKey(std::string& key, const T& value) {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void appendKeyArray(std::string& key, const T* values, uint32_t count) {
+        appendKey(key, count);
+        if (count > 0) {
+            key.append(reinterpret_cast<const char*>(values), sizeof(T) * count);
+        }
+    }
+}
+
 // --- VulkanPipeline implementation (无变化) ---
-VulkanPipeline::VulkanPipeline(VulkanContext& context, VkPipeline pipeline, VkPipelineLayout layout)
-    : _context(context), _pipeline(pipeline), _layout(layout) {}
+VulkanPipeline::VulkanPipeline(VulkanContext& context, VkPipeline pipeline, VkPipelineLayout layout, bool ownsLayout,
+    std::vector<VkPushConstantRange> pushConstantRanges)
+    : _context(context), _pipeline(pipeline), _layout(layout), _ownsLayout(ownsLayout),
+      _pushConstantRanges(std::move(pushConstantRanges)) {}
 
 VulkanPipeline::~VulkanPipeline() {
     vkDestroyPipeline(_context.getDevice(), _pipeline, nullptr);
-    vkDestroyPipelineLayout(_context.getDevice(), _layout, nullptr);
+    if (_ownsLayout) {
+        vkDestroyPipelineLayout(_context.getDevice(), _layout, nullptr);
+    }
 }
 
 void VulkanPipeline::bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint) {
     vkCmdBindPipeline(commandBuffer, bindPoint, _pipeline);
 }
 
+bool VulkanPipeline::isDynamic(VkDynamicState state) const {
+    return std::find(_dynamicStates.begin(), _dynamicStates.end(), state) != _dynamicStates.end();
+}
+
+void VulkanPipeline::pushConstantData(VkCommandBuffer commandBuffer, uint32_t offset, uint32_t size, const void* data) const {
+    if (size == 0 || offset % 4 != 0 || size % 4 != 0) {
+        throw std::runtime_error("push constant offset and size must be non-zero multiples of 4!");
+    }
+    const uint32_t end = offset + size;
+
+    // 按所有范围的边界把 [offset, end) 切成若干段，每段内覆盖它的范围集合不变
+    std::vector<uint32_t> cuts = { offset, end };
+    for (const VkPushConstantRange& range : _pushConstantRanges) {
+        for (uint32_t cut : { range.offset, range.offset + range.size }) {
+            if (cut > offset && cut < end) cuts.push_back(cut);
+        }
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    // 每段的 stageFlags 必须恰好是覆盖它的所有范围的阶段之和；阶段相同的相邻段合并为一次调用
+    auto stagesAt = [this](uint32_t begin) {
+        VkShaderStageFlags stages = 0;
+        for (const VkPushConstantRange& range : _pushConstantRanges) {
+            if (range.offset <= begin && begin < range.offset + range.size) stages |= range.stageFlags;
+        }
+        return stages;
+    };
+    // 先检查全部字节都被覆盖，避免抛出异常前已经录制了一部分
+    std::vector<VkShaderStageFlags> segmentStages(cuts.size() - 1);
+    for (size_t i = 0; i + 1 < cuts.size(); ++i) {
+        segmentStages[i] = stagesAt(cuts[i]);
+        if (segmentStages[i] == 0) {
+            throw std::runtime_error("push constant bytes [" + std::to_string(cuts[i]) + ", " + std::to_string(cuts[i + 1])
+                + ") are not covered by any push constant range!");
+        }
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t first = 0;
+    for (size_t i = 1; i <= segmentStages.size(); ++i) {
+        if (i == segmentStages.size() || segmentStages[i] != segmentStages[first]) {
+            vkCmdPushConstants(commandBuffer, _layout, segmentStages[first], cuts[first], cuts[i] - cuts[first], bytes + (cuts[first] - offset));
+            first = i;
+        }
+    }
+}
+
 // --- PipelineBuilder implementation (已修改) ---
 PipelineBuilder::PipelineBuilder(VulkanContext& context) : _context(context) {
     // --- 设置一套完整的、合理的图形管线默认值 ---
@@ -70,21 +142,56 @@ PipelineBuilder::PipelineBuilder(VulkanContext& context) : _context(context) {
 
 // --- 用户覆盖函数 ---
 PipelineBuilder& PipelineBuilder::addShaderStage(VkShaderStageFlagBits stage, const std::string& shaderPath, const char* entryPoint) {
-    auto shaderCode = _context.readFile(shaderPath);
-    VkShaderModule shaderModule = _context.createShaderModule(shaderCode);
-    _shaderModules.push_back(shaderModule);
+    ShaderSource source;
+    source.stage = stage;
+    source.code = _context.readFile(shaderPath);
+    SpirvReflection::requireEntryPoint(source.code, stage, entryPoint);
+    source.codeHash = std::hash<std::string_view>()(std::string_view(source.code.data(), source.code.size()));
+    source.entryPoint = entryPoint;
+    _shaderSources.push_back(std::move(source));
+    return *this;
+}
 
-    VkPipelineShaderStageCreateInfo shaderStageInfo{};
-    shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    shaderStageInfo.stage = stage;
-    shaderStageInfo.module = shaderModule;
-    shaderStageInfo.pName = entryPoint;
-    _shaderStages.push_back(shaderStageInfo);
+PipelineBuilder& PipelineBuilder::setSpecializationConstants(VkShaderStageFlagBits stage, const SpecializationConstants& constants) {
+    auto it = std::find_if(_shaderSources.begin(), _shaderSources.end(),
+        [stage](const ShaderSource& source) { return source.stage == stage; });
+    if (it == _shaderSources.end()) {
+        throw std::runtime_error("specialization constants set for a shader stage that has not been added!");
+    }
+    it->specialization = constants;
     return *this;
 }
 
+SpecializationConstants& PipelineBuilder::getSpecializationConstants(VkShaderStageFlagBits stage) {
+    auto it = std::find_if(_shaderSources.begin(), _shaderSources.end(),
+        [stage](const ShaderSource& source) { return source.stage == stage; });
+    if (it == _shaderSources.end()) {
+        throw std::runtime_error("specialization constants requested for a shader stage that has not been added!");
+    }
+    return it->specialization;
+}
+
+VkShaderStageFlags PipelineBuilder::getShaderStages() const {
+    VkShaderStageFlags stages = 0;
+    for (const ShaderSource& source : _shaderSources) {
+        stages |= source.stage;
+    }
+    return stages;
+}
+
 PipelineBuilder& PipelineBuilder::setVertexInputState(const VkPipelineVertexInputStateCreateInfo& info) {
     _vertexInputInfo = info;
+    _vertexBindings.assign(info.pVertexBindingDescriptions, info.pVertexBindingDescriptions + info.vertexBindingDescriptionCount);
+    _vertexAttributes.assign(info.pVertexAttributeDescriptions, info.pVertexAttributeDescriptions + info.vertexAttributeDescriptionCount);
+    _useMeshVertexInput = false;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::setVertexInput(VertexFormat format, VertexLayout layout) {
+    // 具体描述在 build 时生成，此时才知道是否为深度专用管线
+    _useMeshVertexInput = true;
+    _vertexFormat = format;
+    _vertexLayout = layout;
     return *this;
 }
 
@@ -118,83 +225,382 @@ PipelineBuilder& PipelineBuilder::addDescriptorSetLayout(VkDescriptorSetLayout l
     return *this;
 }
 
+PipelineBuilder& PipelineBuilder::addPushConstantRange(const VkPushConstantRange& range) {
+    _pushConstantRanges.push_back(range);
+    return *this;
+}
+
 PipelineBuilder& PipelineBuilder::setRenderingFormats(VkFormat colorFormat, VkFormat depthFormat) {
-    // 这里需要特别注意，因为pColorAttachmentFormats需要一个持久的指针
-    // 我们将colorFormat存储在_renderingInfo的一个隐藏成员中
-    static VkFormat staticColorFormat; // 使用静态变量以确保指针有效
-    staticColorFormat = colorFormat;
+    // pColorAttachmentFormats 需要一个持久的指针，格式保存在 builder 自己的成员中
+    // （不能用静态变量：多个 builder 可能在不同线程上同时构建）
+    _colorFormat = colorFormat;
+    _colorBlendInfo.attachmentCount = 1;
+    _colorBlendInfo.pAttachments = &_colorBlendAttachment;
     _renderingInfo.colorAttachmentCount = 1;
-    _renderingInfo.pColorAttachmentFormats = &staticColorFormat;
+    _renderingInfo.pColorAttachmentFormats = &_colorFormat;
+    _renderingInfo.depthAttachmentFormat = depthFormat;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::setDepthOnly(VkFormat depthFormat) {
+    _renderingInfo.colorAttachmentCount = 0;
+    _renderingInfo.pColorAttachmentFormats = nullptr;
     _renderingInfo.depthAttachmentFormat = depthFormat;
+    _colorBlendInfo.attachmentCount = 0;
+    _colorBlendInfo.pAttachments = nullptr;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::useExtendedDynamicState(bool enable) {
+    _useExtendedDynamicState = enable;
     return *this;
 }
 
+std::vector<VkDynamicState> PipelineBuilder::resolveDynamicStates() const {
+    std::vector<VkDynamicState> states = _dynamicStates;
+    if (!_useExtendedDynamicState) {
+        return states;
+    }
+    if (_context.isDeviceExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+        states.insert(states.end(), {
+            VK_DYNAMIC_STATE_CULL_MODE_EXT, VK_DYNAMIC_STATE_FRONT_FACE_EXT, VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT,
+            VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT, VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT, VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT,
+            VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT, VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT });
+    }
+    if (_context.isDeviceExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+        states.insert(states.end(), {
+            VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT, VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT, VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT });
+    }
+    const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& features3 = _context.getExtendedDynamicState3Features();
+    if (features3.extendedDynamicState3PolygonMode) {
+        states.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+    }
+    // 颜色状态只对有颜色附件的管线有意义
+    if (_colorBlendInfo.attachmentCount > 0) {
+        if (features3.extendedDynamicState3ColorBlendEnable) states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+        if (features3.extendedDynamicState3ColorWriteMask) states.push_back(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+    }
+    return states;
+}
+
+PipelineBuilder& PipelineBuilder::setPipelineCache(VkPipelineCache cache) {
+    _pipelineCache = cache;
+    return *this;
+}
+
+PipelineBuilder& PipelineBuilder::setPipelineLayout(VkPipelineLayout layout) {
+    _pipelineLayout = layout;
+    return *this;
+}
+
+SpirvReflection PipelineBuilder::reflect() const {
+    SpirvReflection merged;
+    for (const ShaderSource& source : _shaderSources) {
+        merged.merge(SpirvReflection(source.code, source.stage));
+    }
+    return merged;
+}
+
+PipelineBuilder& PipelineBuilder::reflectLayout(PipelineRegistry& registry) {
+    SpirvReflection reflection = reflect();
+
+    _descriptorSetLayouts.clear();
+    for (uint32_t set = 0; set < reflection.getSetCount(); ++set) {
+        std::vector<VkDescriptorSetLayoutBinding> bindings = reflection.getSetLayoutBindings(set);
+        _descriptorSetLayouts.push_back(registry.getDescriptorSetLayout(bindings));
+    }
+    _pushConstantRanges = reflection.getPushConstantRanges();
+
+    _reflectedInputs = reflection.getVertexInputs();
+    if (!_useMeshVertexInput && _vertexBindings.empty()) {
+        reflection.getVertexInputDescription(_vertexBindings, _vertexAttributes);
+    }
+    return *this;
+}
+
+void PipelineBuilder::resolveVertexInput() {
+    // 顶点输入指向 builder 自己持有的数组；深度专用管线只绑定位置
+    if (_useMeshVertexInput) {
+        bool positionOnly = _renderingInfo.colorAttachmentCount == 0;
+        _vertexBindings = VertexCompressor::getBindingDescription(_vertexFormat, _vertexLayout, positionOnly);
+        _vertexAttributes = VertexCompressor::getAttributeDescription(_vertexFormat, _vertexLayout, positionOnly);
+    }
+    for (const SpirvReflection::VertexInput& input : _reflectedInputs) {
+        bool found = std::any_of(_vertexAttributes.begin(), _vertexAttributes.end(),
+            [&](const VkVertexInputAttributeDescription& attribute) { return attribute.location == input.location; });
+        if (!found) {
+            std::cerr << "[WARNING] vertex shader input " << input.name << " (location " << input.location
+                      << ") has no matching vertex attribute" << std::endl;
+        }
+    }
+    _vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(_vertexBindings.size());
+    _vertexInputInfo.pVertexBindingDescriptions = _vertexBindings.data();
+    _vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(_vertexAttributes.size());
+    _vertexInputInfo.pVertexAttributeDescriptions = _vertexAttributes.data();
+}
+
+std::string PipelineBuilder::getStateKey() const {
+    std::string key;
+
+    // 着色器：阶段、入口、SPIR-V 哈希与特化常量
+    appendKey(key, static_cast<uint32_t>(_shaderSources.size()));
+    for (const ShaderSource& source : _shaderSources) {
+        appendKey(key, source.stage);
+        appendKey(key, source.codeHash);
+        appendKeyArray(key, source.entryPoint.data(), static_cast<uint32_t>(source.entryPoint.size()));
+        source.specialization.appendKey(key);
+    }
+
+    // 顶点输入（与 build 时相同的解析规则）
+    std::vector<VkVertexInputBindingDescription> bindings = _vertexBindings;
+    std::vector<VkVertexInputAttributeDescription> attributes = _vertexAttributes;
+    if (_useMeshVertexInput) {
+        bool positionOnly = _renderingInfo.colorAttachmentCount == 0;
+        bindings = VertexCompressor::getBindingDescription(_vertexFormat, _vertexLayout, positionOnly);
+        attributes = VertexCompressor::getAttributeDescription(_vertexFormat, _vertexLayout, positionOnly);
+    }
+    appendKeyArray(key, bindings.data(), static_cast<uint32_t>(bindings.size()));
+    appendKeyArray(key, attributes.data(), static_cast<uint32_t>(attributes.size()));
+
+    // 动态状态在录制时设置，不参与区分管线：对应字段按默认值写入键中
+    const std::vector<VkDynamicState> dynamicStates = resolveDynamicStates();
+    auto isDynamic = [&](VkDynamicState state) {
+        return std::find(dynamicStates.begin(), dynamicStates.end(), state) != dynamicStates.end();
+    };
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = _inputAssemblyInfo;
+    if (isDynamic(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT)) {
+        // 动态拓扑只能在同一类（点/线/三角形/面片）之内切换
+        switch (inputAssembly.topology) {
+        case VK_PRIMITIVE_TOPOLOGY_POINT_LIST: break;
+        case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+            inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; break;
+        case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST: break;
+        default:
+            inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST; break;
+        }
+    }
+    if (isDynamic(VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT)) inputAssembly.primitiveRestartEnable = VK_FALSE;
+    appendKey(key, inputAssembly.topology);
+    appendKey(key, inputAssembly.primitiveRestartEnable);
+
+    VkPipelineRasterizationStateCreateInfo raster = _rasterizationInfo;
+    if (isDynamic(VK_DYNAMIC_STATE_CULL_MODE_EXT)) raster.cullMode = VK_CULL_MODE_NONE;
+    if (isDynamic(VK_DYNAMIC_STATE_FRONT_FACE_EXT)) raster.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    if (isDynamic(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT)) raster.depthBiasEnable = VK_FALSE;
+    if (isDynamic(VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT)) raster.rasterizerDiscardEnable = VK_FALSE;
+    if (isDynamic(VK_DYNAMIC_STATE_POLYGON_MODE_EXT)) raster.polygonMode = VK_POLYGON_MODE_FILL;
+    appendKey(key, raster.depthClampEnable);
+    appendKey(key, raster.rasterizerDiscardEnable);
+    appendKey(key, raster.polygonMode);
+    appendKey(key, raster.cullMode);
+    appendKey(key, raster.frontFace);
+    appendKey(key, raster.depthBiasEnable);
+    appendKey(key, raster.depthBiasConstantFactor);
+    appendKey(key, raster.depthBiasClamp);
+    appendKey(key, raster.depthBiasSlopeFactor);
+    appendKey(key, raster.lineWidth);
+
+    const VkPipelineMultisampleStateCreateInfo& multisample = _multisampleInfo;
+    appendKey(key, multisample.rasterizationSamples);
+    appendKey(key, multisample.sampleShadingEnable);
+    appendKey(key, multisample.minSampleShading);
+    appendKey(key, multisample.alphaToCoverageEnable);
+    appendKey(key, multisample.alphaToOneEnable);
+    const uint32_t sampleMaskWords = multisample.pSampleMask ? (multisample.rasterizationSamples + 31) / 32 : 0;
+    appendKeyArray(key, multisample.pSampleMask, sampleMaskWords);
+
+    const VkPipelineColorBlendStateCreateInfo& blend = _colorBlendInfo;
+    appendKey(key, blend.logicOpEnable);
+    appendKey(key, blend.logicOp);
+    std::vector<VkPipelineColorBlendAttachmentState> blendAttachments(blend.pAttachments, blend.pAttachments + blend.attachmentCount);
+    for (VkPipelineColorBlendAttachmentState& attachment : blendAttachments) {
+        if (isDynamic(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT)) attachment.blendEnable = VK_FALSE;
+        if (isDynamic(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT)) attachment.colorWriteMask = 0;
+    }
+    appendKeyArray(key, blendAttachments.data(), static_cast<uint32_t>(blendAttachments.size()));
+    appendKeyArray(key, blend.blendConstants, 4);
+
+    VkPipelineDepthStencilStateCreateInfo depth = _depthStencilInfo;
+    if (isDynamic(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT)) depth.depthTestEnable = VK_FALSE;
+    if (isDynamic(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT)) depth.depthWriteEnable = VK_FALSE;
+    if (isDynamic(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT)) depth.depthCompareOp = VK_COMPARE_OP_NEVER;
+    if (isDynamic(VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT)) depth.depthBoundsTestEnable = VK_FALSE;
+    if (isDynamic(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT)) depth.stencilTestEnable = VK_FALSE;
+    appendKey(key, depth.depthTestEnable);
+    appendKey(key, depth.depthWriteEnable);
+    appendKey(key, depth.depthCompareOp);
+    appendKey(key, depth.depthBoundsTestEnable);
+    appendKey(key, depth.stencilTestEnable);
+    appendKey(key, depth.front);
+    appendKey(key, depth.back);
+    appendKey(key, depth.minDepthBounds);
+    appendKey(key, depth.maxDepthBounds);
+
+    appendKeyArray(key, dynamicStates.data(), static_cast<uint32_t>(dynamicStates.size()));
+
+    appendKey(key, _renderingInfo.viewMask);
+    appendKeyArray(key, _renderingInfo.pColorAttachmentFormats, _renderingInfo.colorAttachmentCount);
+    appendKey(key, _renderingInfo.depthAttachmentFormat);
+    appendKey(key, _renderingInfo.stencilAttachmentFormat);
+
+    // 布局：外部布局按句柄区分，否则按创建布局所需的参数区分
+    appendKey(key, _pipelineLayout);
+    if (_pipelineLayout == VK_NULL_HANDLE) {
+        appendKeyArray(key, _descriptorSetLayouts.data(), static_cast<uint32_t>(_descriptorSetLayouts.size()));
+        appendKeyArray(key, _pushConstantRanges.data(), static_cast<uint32_t>(_pushConstantRanges.size()));
+    }
+    return key;
+}
+
 // --- 构建函数 ---
 
-std::unique_ptr<VulkanPipeline> PipelineBuilder::buildGraphicsPipeline() {
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(_descriptorSetLayouts.size());
-    pipelineLayoutInfo.pSetLayouts = _descriptorSetLayouts.data();
+void PipelineBuilder::validatePushConstantRanges() const {
+    // 规范只保证 128 字节，超出设备上限的范围在创建布局时才会被验证层发现
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(_context.getPhysicalDevice(), &properties);
+    for (const VkPushConstantRange& range : _pushConstantRanges) {
+        if (range.size == 0 || range.offset % 4 != 0 || range.size % 4 != 0
+            || range.offset + range.size > properties.limits.maxPushConstantsSize) {
+            throw std::runtime_error("push constant range [" + std::to_string(range.offset) + ", "
+                + std::to_string(range.offset + range.size) + ") exceeds maxPushConstantsSize "
+                + std::to_string(properties.limits.maxPushConstantsSize) + " or is misaligned!");
+        }
+    }
+}
 
-    VkPipelineLayout pipelineLayout;
-    if (vkCreatePipelineLayout(_context.getDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create pipeline layout!");
+std::unique_ptr<VulkanPipeline> PipelineBuilder::buildGraphicsPipeline() {
+    validatePushConstantRanges();
+    const bool ownsLayout = _pipelineLayout == VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = _pipelineLayout;
+    if (ownsLayout) {
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(_descriptorSetLayouts.size());
+        pipelineLayoutInfo.pSetLayouts = _descriptorSetLayouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(_pushConstantRanges.size());
+        pipelineLayoutInfo.pPushConstantRanges = _pushConstantRanges.data();
+
+        if (vkCreatePipelineLayout(_context.getDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout!");
+        }
     }
 
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.scissorCount = 1;
-    
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.pNext = &_renderingInfo; // 链接动态渲染信息
-    pipelineInfo.stageCount = static_cast<uint32_t>(_shaderStages.size());
-    pipelineInfo.pStages = _shaderStages.data();
-    pipelineInfo.pVertexInputState = &_vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &_inputAssemblyInfo;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &_rasterizationInfo;
-    pipelineInfo.pMultisampleState = &_multisampleInfo;
-    pipelineInfo.pColorBlendState = &_colorBlendInfo;
-    pipelineInfo.pDepthStencilState = &_depthStencilInfo;
-    pipelineInfo.pDynamicState = &_dynamicStateInfo;
-    pipelineInfo.layout = pipelineLayout;
-    pipelineInfo.renderPass = VK_NULL_HANDLE; // 动态渲染不需要Render Pass
-    
+    // 着色器模块只在创建管线期间存在；中途抛出异常时与自有的布局一起销毁，不泄漏
+    std::vector<VkShaderModule> shaderModules;
+    auto destroyShaderModules = [&] {
+        for (VkShaderModule module : shaderModules) {
+            vkDestroyShaderModule(_context.getDevice(), module, nullptr);
+        }
+        shaderModules.clear();
+    };
+    auto destroyOwnedLayout = [&] {
+        if (ownsLayout) {
+            vkDestroyPipelineLayout(_context.getDevice(), pipelineLayout, nullptr);
+        }
+    };
+
+    std::vector<VkDynamicState> dynamicStates;
     VkPipeline pipeline;
-    if (vkCreateGraphicsPipelines(_context.getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
-        vkDestroyPipelineLayout(_context.getDevice(), pipelineLayout, nullptr);
-        throw std::runtime_error("failed to create graphics pipeline!");
+    VkResult result;
+    try {
+        resolveVertexInput();
+
+        std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+        std::vector<VkSpecializationInfo> specializationInfos(_shaderSources.size()); // pSpecializationInfo 指向这里，不能扩容
+        for (size_t i = 0; i < _shaderSources.size(); ++i) {
+            const ShaderSource& source = _shaderSources[i];
+            VkShaderModule module = _context.createShaderModule(source.code);
+            shaderModules.push_back(module);
+
+            VkPipelineShaderStageCreateInfo shaderStageInfo{};
+            shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            shaderStageInfo.stage = source.stage;
+            shaderStageInfo.module = module;
+            shaderStageInfo.pName = source.entryPoint.c_str();
+            if (!source.specialization.empty()) {
+                specializationInfos[i] = source.specialization.getInfo();
+                shaderStageInfo.pSpecializationInfo = &specializationInfos[i];
+            }
+            shaderStages.push_back(shaderStageInfo);
+        }
+
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        dynamicStates = resolveDynamicStates();
+        VkPipelineDynamicStateCreateInfo dynamicStateInfo = _dynamicStateInfo;
+        dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicStateInfo.pDynamicStates = dynamicStates.data();
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.pNext = &_renderingInfo; // 链接动态渲染信息
+        pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+        pipelineInfo.pStages = shaderStages.data();
+        pipelineInfo.pVertexInputState = &_vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &_inputAssemblyInfo;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &_rasterizationInfo;
+        pipelineInfo.pMultisampleState = &_multisampleInfo;
+        pipelineInfo.pColorBlendState = &_colorBlendInfo;
+        pipelineInfo.pDepthStencilState = &_depthStencilInfo;
+        pipelineInfo.pDynamicState = &dynamicStateInfo;
+        pipelineInfo.layout = pipelineLayout;
+        pipelineInfo.renderPass = VK_NULL_HANDLE; // 动态渲染不需要Render Pass
+
+        result = vkCreateGraphicsPipelines(_context.getDevice(), _pipelineCache ? *_pipelineCache : _context.getPipelineCache().get(), 1, &pipelineInfo, nullptr, &pipeline);
+    } catch (...) {
+        destroyShaderModules();
+        destroyOwnedLayout();
+        throw;
     }
+    destroyShaderModules();
 
-    // 清理临时创建的shader modules
-    for (auto module : _shaderModules) {
-        vkDestroyShaderModule(_context.getDevice(), module, nullptr);
+    if (result != VK_SUCCESS) {
+        destroyOwnedLayout();
+        throw std::runtime_error("failed to create graphics pipeline!");
     }
 
-    return std::make_unique<VulkanPipeline>(_context, pipeline, pipelineLayout);
+    auto graphicsPipeline = std::make_unique<VulkanPipeline>(_context, pipeline, pipelineLayout, ownsLayout, _pushConstantRanges);
+    graphicsPipeline->setDynamicStates(dynamicStates);
+    return graphicsPipeline;
 }
 
-std::unique_ptr<VulkanPipeline> PipelineBuilder::buildComputePipeline(const std::string& shaderPath, VkDescriptorSetLayout layout, const char* entryPoint) {
+std::unique_ptr<VulkanPipeline> PipelineBuilder::buildComputePipeline(const std::string& shaderPath, VkDescriptorSetLayout layout, const char* entryPoint,
+    const SpecializationConstants& specialization) {
+    validatePushConstantRanges();
     auto computeShaderCode = _context.readFile(shaderPath);
+    SpirvReflection::requireEntryPoint(computeShaderCode, VK_SHADER_STAGE_COMPUTE_BIT, entryPoint);
     VkShaderModule computeShaderModule = _context.createShaderModule(computeShaderCode);
 
+    VkSpecializationInfo specializationInfo = specialization.getInfo();
     VkPipelineShaderStageCreateInfo computeShaderStageInfo{};
     computeShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     computeShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
     computeShaderStageInfo.module = computeShaderModule;
     computeShaderStageInfo.pName = entryPoint;
-    
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &layout;
-
-    VkPipelineLayout pipelineLayout;
-    if (vkCreatePipelineLayout(_context.getDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create compute pipeline layout!");
+    computeShaderStageInfo.pSpecializationInfo = specialization.empty() ? nullptr : &specializationInfo;
+
+    const bool ownsLayout = _pipelineLayout == VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = _pipelineLayout;
+    if (ownsLayout) {
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &layout;
+        pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(_pushConstantRanges.size());
+        pipelineLayoutInfo.pPushConstantRanges = _pushConstantRanges.data();
+
+        if (vkCreatePipelineLayout(_context.getDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+            vkDestroyShaderModule(_context.getDevice(), computeShaderModule, nullptr);
+            throw std::runtime_error("failed to create compute pipeline layout!");
+        }
     }
 
     VkComputePipelineCreateInfo pipelineInfo{};
@@ -203,12 +609,15 @@ std::unique_ptr<VulkanPipeline> PipelineBuilder::buildComputePipeline(const std:
     pipelineInfo.stage = computeShaderStageInfo;
     
     VkPipeline pipeline;
-    if (vkCreateComputePipelines(_context.getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
-        vkDestroyPipelineLayout(_context.getDevice(), pipelineLayout, nullptr);
+    VkResult result = vkCreateComputePipelines(_context.getDevice(), _pipelineCache ? *_pipelineCache : _context.getPipelineCache().get(), 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(_context.getDevice(), computeShaderModule, nullptr);
+
+    if (result != VK_SUCCESS) {
+        if (ownsLayout) {
+            vkDestroyPipelineLayout(_context.getDevice(), pipelineLayout, nullptr);
+        }
         throw std::runtime_error("failed to create compute pipeline!");
     }
 
-    vkDestroyShaderModule(_context.getDevice(), computeShaderModule, nullptr);
-
-    return std::make_unique<VulkanPipeline>(_context, pipeline, pipelineLayout);
+    return std::make_unique<VulkanPipeline>(_context, pipeline, pipelineLayout, ownsLayout, _pushConstantRanges);
 }
\ No newline at end of file
@@ -1,12 +1,22 @@
 #pragma once
 #include "VulkanContext.h"
+#include "Model.h"
+#include "SpecializationConstants.h"
+#include "SpirvReflection.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <optional>
+#include <type_traits>
+
+class PipelineRegistry;
 
 class VulkanPipeline {
 public:
-    VulkanPipeline(VulkanContext& context, VkPipeline pipeline, VkPipelineLayout layout);
+    // ownsLayout 为 false 时布局由别处共享（如 PipelineRegistry），析构时不销毁；
+    // pushConstantRanges 与创建布局时相同，pushConstants() 据此确定 stageFlags
+    VulkanPipeline(VulkanContext& context, VkPipeline pipeline, VkPipelineLayout layout, bool ownsLayout = true,
+        std::vector<VkPushConstantRange> pushConstantRanges = {});
     ~VulkanPipeline();
 
     // 禁止拷贝
@@ -16,11 +26,34 @@ public:
     void bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint);
 
     VkPipelineLayout getLayout() const { return _layout; }
+    const std::vector<VkPushConstantRange>& getPushConstantRanges() const { return _pushConstantRanges; }
+
+    /*
+     * @brief 以 offset 为起点写入推送常量。[offset, offset + size) 按范围边界拆分，每段的 stageFlags
+     * 取覆盖该段的所有范围的阶段，阶段不同的段分别调用 vkCmdPushConstants（如顶点 [0,64) + 片元 [64,80)）。
+     * 每次绘制/dispatch 前调用即可传入逐物体数据（如模型矩阵），不需要更新描述符或写 UBO。
+     * 有任何字节不在某个范围内时抛出异常。
+     */
+    template <typename T>
+    void pushConstants(VkCommandBuffer commandBuffer, const T& data, uint32_t offset = 0) const {
+        static_assert(std::is_trivially_copyable_v<T>, "push constant data must be trivially copyable");
+        static_assert(sizeof(T) % 4 == 0, "push constant size must be a multiple of 4");
+        pushConstantData(commandBuffer, offset, sizeof(T), &data);
+    }
+    void pushConstantData(VkCommandBuffer commandBuffer, uint32_t offset, uint32_t size, const void* data) const;
+
+    // 创建管线时声明的动态状态，DynamicStateTracker 据此决定哪些 vkCmdSet* 有效
+    void setDynamicStates(std::vector<VkDynamicState> dynamicStates) { _dynamicStates = std::move(dynamicStates); }
+    const std::vector<VkDynamicState>& getDynamicStates() const { return _dynamicStates; }
+    bool isDynamic(VkDynamicState state) const;
 
 private:
     VulkanContext& _context;
     VkPipeline _pipeline;
     VkPipelineLayout _layout;
+    bool _ownsLayout;
+    std::vector<VkPushConstantRange> _pushConstantRanges;
+    std::vector<VkDynamicState> _dynamicStates;
 };
 
 // 使用建造者模式来创建管线
@@ -28,28 +61,105 @@ class PipelineBuilder {
 public:
     PipelineBuilder(VulkanContext& context);
 
+    // 禁止拷贝和移动：_colorBlendInfo、_renderingInfo 等结构中的指针指向本对象的成员
+    PipelineBuilder(const PipelineBuilder&) = delete;
+    PipelineBuilder& operator=(const PipelineBuilder&) = delete;
+    PipelineBuilder(PipelineBuilder&&) = delete;
+    PipelineBuilder& operator=(PipelineBuilder&&) = delete;
+
     // 图形管线配置
     PipelineBuilder& addShaderStage(VkShaderStageFlagBits stage, const std::string& shaderPath, const char* entryPoint = "main");
+    // 为已添加的阶段设置特化常量（替换之前的设置）；常量属于管线状态，不同组合是不同的管线变体
+    PipelineBuilder& setSpecializationConstants(VkShaderStageFlagBits stage, const SpecializationConstants& constants);
+    // 已添加阶段的特化常量，可在原有常量上追加；阶段不存在时抛出异常
+    SpecializationConstants& getSpecializationConstants(VkShaderStageFlagBits stage);
+    VkShaderStageFlags getShaderStages() const;
+    // 绑定与属性数组会被拷贝，调用方的数组不需要在 build 之前保持有效
     PipelineBuilder& setVertexInputState(const VkPipelineVertexInputStateCreateInfo& info);
+    // 按 Model 的顶点格式与布局生成顶点输入；深度专用管线（setDepthOnly）只读取位置
+    PipelineBuilder& setVertexInput(VertexFormat format, VertexLayout layout = VertexLayout::Interleaved);
     PipelineBuilder& setInputAssemblyState(const VkPipelineInputAssemblyStateCreateInfo& info);
     PipelineBuilder& setRasterizationState(const VkPipelineRasterizationStateCreateInfo& info);
     PipelineBuilder& setMultisampleState(const VkPipelineMultisampleStateCreateInfo& info);
     PipelineBuilder& setColorBlendState(const VkPipelineColorBlendStateCreateInfo& info);
     PipelineBuilder& setDepthStencilState(const VkPipelineDepthStencilStateCreateInfo& info);
     // 注意：我们不再需要 setDynamicStates，因为默认值中包含了它
+    /*
+     * @brief 选用扩展动态状态（VK_EXT_extended_dynamic_state/2/3）：剔除模式、正面朝向、图元拓扑、深度测试/写入/比较、
+     * 深度边界与模板测试开关、深度偏移/图元重启/光栅化丢弃开关，以及设备支持的多边形模式、颜色混合开关与颜色写掩码
+     * 都改为在命令缓冲区中设置（见 DynamicStateTracker）。这些字段不再计入 getStateKey()，拓扑只按类别（点/线/三角形/面片）区分，
+     * 只在这些状态上不同的材质共用同一个管线。设备不支持的扩展会被跳过，对应状态仍编译进管线。
+     */
+    PipelineBuilder& useExtendedDynamicState(bool enable = true);
     PipelineBuilder& addDescriptorSetLayout(VkDescriptorSetLayout layout);
+    PipelineBuilder& addPushConstantRange(const VkPushConstantRange& range);
+    // 按 T 的大小添加推送常量范围，配合 VulkanPipeline::pushConstants<T> 使用
+    template <typename T>
+    PipelineBuilder& addPushConstants(VkShaderStageFlags stageFlags, uint32_t offset = 0) {
+        static_assert(sizeof(T) % 4 == 0, "push constant size must be a multiple of 4");
+        return addPushConstantRange({ stageFlags, offset, static_cast<uint32_t>(sizeof(T)) });
+    }
     PipelineBuilder& setRenderingFormats(VkFormat colorFormat, VkFormat depthFormat);
+    // 无颜色附件的深度预 pass / 阴影管线；可以不添加片元着色器
+    PipelineBuilder& setDepthOnly(VkFormat depthFormat);
+    // 默认使用 VulkanContext 的共享管线缓存；工作线程可以换成自己的线程缓存，VK_NULL_HANDLE 表示不使用缓存
+    PipelineBuilder& setPipelineCache(VkPipelineCache cache);
+    // 使用外部持有的管线布局（不再按描述符集布局与推送常量创建），生成的 VulkanPipeline 不会销毁它
+    PipelineBuilder& setPipelineLayout(VkPipelineLayout layout);
+    VkPipelineLayout getPipelineLayout() const { return _pipelineLayout; }
+
+    // 合并所有已添加阶段的反射结果
+    SpirvReflection reflect() const;
+    /*
+     * @brief 用着色器反射结果代替手写的 addDescriptorSetLayout / addPushConstantRange：
+     * 描述符集布局从 registry 取得（相同绑定共享同一个句柄），未使用的 set 用空布局占位。
+     * 尚未设置顶点输入时，按 location 顺序紧密排列在绑定 0；已用 setVertexInput 指定网格格式时保留它，
+     * build 时检查着色器读取的每个 location 都有对应的属性。须在 addShaderStage 之后调用。
+     */
+    PipelineBuilder& reflectLayout(PipelineRegistry& registry);
+
+    /*
+     * @brief 序列化影响管线对象的全部状态：着色器（阶段、入口、SPIR-V 哈希）、顶点输入、图元装配、光栅化、
+     * 多重采样、混合、深度模板、动态状态、渲染格式，以及描述符集布局与推送常量（或外部管线布局）。
+     * 两个 builder 的键相同即会生成等价的管线。
+     */
+    std::string getStateKey() const;
+    const std::vector<VkDescriptorSetLayout>& getDescriptorSetLayouts() const { return _descriptorSetLayouts; }
+    const std::vector<VkPushConstantRange>& getPushConstantRanges() const { return _pushConstantRanges; }
 
     std::unique_ptr<VulkanPipeline> buildGraphicsPipeline();
 
     // 计算管线配置
-    std::unique_ptr<VulkanPipeline> buildComputePipeline(const std::string& shaderPath, VkDescriptorSetLayout layout, const char* entryPoint = "main");
+    // 已用 setPipelineLayout 指定布局时忽略 layout；否则以 layout 与 addPushConstantRange 的范围创建布局
+    std::unique_ptr<VulkanPipeline> buildComputePipeline(const std::string& shaderPath, VkDescriptorSetLayout layout, const char* entryPoint = "main",
+        const SpecializationConstants& specialization = {});
 
 private:
+    // SPIR-V 在 addShaderStage 时读入，着色器模块到 build 时才创建（可能在工作线程上），build 结束即销毁
+    struct ShaderSource {
+        VkShaderStageFlagBits stage;
+        std::vector<char> code;
+        size_t codeHash;
+        std::string entryPoint;
+        SpecializationConstants specialization;
+    };
+
+    // 按当前配置生成顶点输入描述（深度专用管线只有位置）
+    void resolveVertexInput();
+    // 推送常量范围须 4 字节对齐且不超过 maxPushConstantsSize
+    void validatePushConstantRanges() const;
+    // 视口、裁剪，加上 useExtendedDynamicState 时设备支持的扩展动态状态
+    std::vector<VkDynamicState> resolveDynamicStates() const;
+
     VulkanContext& _context;
-    std::vector<VkPipelineShaderStageCreateInfo> _shaderStages;
-    std::vector<VkShaderModule> _shaderModules;
+    std::vector<ShaderSource> _shaderSources;
     VkPipelineVertexInputStateCreateInfo _vertexInputInfo{};
+    std::vector<VkVertexInputBindingDescription> _vertexBindings;
+    std::vector<VkVertexInputAttributeDescription> _vertexAttributes;
+    bool _useMeshVertexInput = false;
+    std::vector<SpirvReflection::VertexInput> _reflectedInputs;  // 只用于 build 时的检查
+    VertexFormat _vertexFormat = VertexFormat::Float32;
+    VertexLayout _vertexLayout = VertexLayout::Interleaved;
     VkPipelineInputAssemblyStateCreateInfo _inputAssemblyInfo{};
     VkPipelineRasterizationStateCreateInfo _rasterizationInfo{};
     VkPipelineMultisampleStateCreateInfo _multisampleInfo{};
@@ -57,7 +167,12 @@ private:
     VkPipelineColorBlendStateCreateInfo _colorBlendInfo{};
     VkPipelineDepthStencilStateCreateInfo _depthStencilInfo{};
     std::vector<VkDynamicState> _dynamicStates; // <--- 新增
+    bool _useExtendedDynamicState = false;
     VkPipelineDynamicStateCreateInfo _dynamicStateInfo{};
     std::vector<VkDescriptorSetLayout> _descriptorSetLayouts;
+    std::vector<VkPushConstantRange> _pushConstantRanges;
     VkPipelineRenderingCreateInfo _renderingInfo{};
+    VkFormat _colorFormat = VK_FORMAT_UNDEFINED;    // pColorAttachmentFormats 指向这里
+    std::optional<VkPipelineCache> _pipelineCache;
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
 };
\ No newline at end of file
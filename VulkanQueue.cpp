@@ -32,8 +32,13 @@ VulkanQueue::VulkanQueue(VulkanContext& context, QueueType type) {
             }
             break;
 
-        // 可以在这里添加 Transfer 类型的处理
-        // case QueueType::Transfer: ...
+        case QueueType::Transfer:
+            // findQueueFamilies 在没有专用传输队列族时已回退到图形队列族
+            if (!indices.transferFamily.has_value()) {
+                throw std::runtime_error("Transfer queue family not found!");
+            }
+            _familyIndex = indices.transferFamily.value();
+            break;
 
         default:
             throw std::runtime_error("Unknown queue type requested!");
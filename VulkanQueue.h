@@ -9,7 +9,7 @@ enum class QueueType {
     Graphics,
     Present,
     Compute,
-    Transfer // 还可以为专门的传输队列添加类型
+    Transfer // 专用传输队列，没有时回退到图形队列
 };
 
 class VulkanQueue {
@@ -1,38 +1,187 @@
 #include "Dependencies.h"
 #include <vulkan/vulkan.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <thread>
 
-int main()
+int main(int argc, char* argv[])
 {
+    // 基准测试只在 --benchmark 时运行，正常启动不做额外的工作
+    bool runBenchmarks = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--benchmark") {
+            runBenchmarks = true;
+        }
+    }
+
     WindowInfo info(800, 600,"Vulkan");
     VulkanContext context(info);
     VulkanQueue graphicsQueue(context, QueueType::Graphics);
     VulkanQueue presentQueue(context, QueueType::Present);
     Renderer renderer(context,3);
     ImmediateSubmitter immediateSubmitter(context, graphicsQueue);
+    // 纹理上传时 mip 链优先用单趟计算着色器生成；不支持推送描述符时退回 blit / CPU 路径
+    MipmapGenerator mipmapGenerator(context, "res\\spd.spv");
+    immediateSubmitter.setMipmapGenerator(&mipmapGenerator);
     VulkanSwapchain swapchain(context);
     Model model("res\\model.obj");
-    VulkanBuffer vertexBuffer(context, model.getVertices().size() * sizeof(Vertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    VulkanBuffer indexBuffer(context, model.getIndices().size() * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    immediateSubmitter.copyDataToBuffer(model.getVertices().data(), vertexBuffer, model.getVertices().size() * sizeof(Vertex));
-    immediateSubmitter.copyDataToBuffer(model.getIndices().data(), indexBuffer, model.getIndices().size() * sizeof(uint32_t));
+    // 所有 LOD 级别都在同一个索引缓冲区中；这里只统计人群场景下按屏幕误差选级能省下的三角形
+    if (runBenchmarks) {
+        LodSelector::benchmarkCrowd(model.getLods(), model.getBounds());
+        // OBJ 解析与 tinyobjloader 的一致性，以及吞吐量随线程数的变化
+        Model::verifyObjParser("res\\model.obj");
+        std::vector<uint32_t> parseThreads;
+        const uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        for (uint32_t threads = 1; threads < hardwareThreads; threads *= 2) {
+            parseThreads.push_back(threads);
+        }
+        parseThreads.push_back(hardwareThreads);
+        ObjParser::benchmark("res\\model.obj", parseThreads);
+    }
+    // 所有模型共用一个顶点缓冲区和一个索引缓冲区；当前着色器直接读取 float 顶点
+    // 池的索引类型沿用打包时为网格选出的类型，顶点数不超过 65536 时保持 16 位索引
+    GeometryPool geometryPool(context, immediateSubmitter, VertexFormat::Float32, VertexLayout::Interleaved,
+        1u << 20, 4u << 20, VertexCompressor::selectIndexType(model.getVertices().size()));
+    // 顶点与索引在同一个批次中上传，只需一次提交和一次等待
+    auto uploadStart = std::chrono::high_resolution_clock::now();
+    immediateSubmitter.beginBatch();
+    GeometryPool::MeshId modelMesh = geometryPool.add(model);
+    immediateSubmitter.wait(immediateSubmitter.flush());
+    auto uploadEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "[Upload] model uploaded to geometry pool in 1 batch: "
+              << std::chrono::duration<double, std::milli>(uploadEnd - uploadStart).count() << " ms" << std::endl;
+    // 上传次数增加时，逐次提交与批处理的加载耗时对比
+    if (runBenchmarks) {
+        for (uint32_t uploadCount : { 16u, 64u, 256u }) {
+            immediateSubmitter.benchmark(uploadCount);
+        }
+        // 直接解码进暂存内存与解码到堆上再拷贝的峰值内存对比
+        ImageDecoder::benchmark("res\\texture.png");
+        // blit 链与单趟计算着色器生成 mip 链的 GPU 耗时对比
+        mipmapGenerator.benchmark(graphicsQueue.getQueue());
+    }
+    // 按簇剔除：子网格切分成簇后上传；簇缓冲区通过推送描述符绑定，不支持时继续使用普通的索引绘制
+    MeshletMesh modelMeshlets = MeshletBuilder::build(model.getVertices(), model.getIndices(), model.getSubmeshes());
+    std::unique_ptr<MeshletCuller> meshletCuller;
+    if (!modelMeshlets.meshlets.empty() && context.isDeviceExtensionEnabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+        meshletCuller = std::make_unique<MeshletCuller>(context, immediateSubmitter, modelMeshlets, "res\\meshlet_cull.spv");
+    }
+    std::cout << "[INFO] model split into " << modelMeshlets.meshlets.size() << " meshlets, GPU culling "
+              << (meshletCuller && meshletCuller->isAvailable() ? "enabled" : "disabled") << ", mesh shaders "
+              << (meshletCuller && meshletCuller->isMeshShaderSupported() ? "enabled" : "unavailable") << std::endl;
+    // 绘制时 geometryPool.bind() 一次，再用 getDrawCommand() 生成的间接命令绘制
+    VkDrawIndexedIndirectCommand modelDraw = geometryPool.getDrawCommand(modelMesh);
+    std::cout << "[INFO] model draw: firstIndex " << modelDraw.firstIndex << ", indexCount " << modelDraw.indexCount
+              << ", vertexOffset " << modelDraw.vertexOffset << std::endl;
     PipelineBuilder pipelineBuilder(context);
     pipelineBuilder.addShaderStage(VK_SHADER_STAGE_VERTEX_BIT, "res\\vert.spv","VSMain");
-    pipelineBuilder.addShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, "res\\frag.spv","FSMain");
-    pipelineBuilder.setVertexInputState({
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .vertexBindingDescriptionCount = (uint32_t)model.getVertexBindingDescription().size(),
-        .pVertexBindingDescriptions = model.getVertexBindingDescription().data(),
-        .vertexAttributeDescriptionCount = (uint32_t)model.getVertexAttributeDescription().size(),
-        .pVertexAttributeDescriptions = model.getVertexAttributeDescription().data(),
-    });
+    pipelineBuilder.addShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, "res\\frag.spv","PSMain");
+    pipelineBuilder.setVertexInput(geometryPool.getFormat(), geometryPool.getLayout());
     pipelineBuilder.setInputAssemblyState({
         .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
         .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
         .primitiveRestartEnable = VK_FALSE,
     });
     pipelineBuilder.setRenderingFormats(swapchain.getImageFormat(), context.findDepthFormat());
-    //VulkanDescriptorSetLayout::Builder descriptorSetLayoutBuilder(context);
-    //descriptorSetLayoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT);
-    //descriptorSetLayoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
-    //std::unique_ptr<VulkanDescriptorSetLayout> descriptorSetLayout = descriptorSetLayoutBuilder.build();
+    // 描述符集布局与推送常量从着色器反射得到，不再手写；相同绑定的布局在所有管线间共享
+    PipelineRegistry pipelineRegistry(context);
+    pipelineBuilder.reflectLayout(pipelineRegistry);
+    for (const SpirvReflection::DescriptorBinding& binding : pipelineBuilder.reflect().getBindings()) {
+        std::cout << "[INFO] reflected descriptor " << binding.name << ": set " << binding.set << ", binding " << binding.binding
+                  << ", type " << binding.type << ", stages 0x" << std::hex << binding.stageFlags << std::dec << std::endl;
+    }
+    // 材质排列组合（剔除模式 x 正面朝向 x 深度比较）在不同线程数下的编译耗时
+    auto makeMaterialVariant = [&](uint32_t i) {
+        auto variant = std::make_unique<PipelineBuilder>(context);
+        variant->addShaderStage(VK_SHADER_STAGE_VERTEX_BIT, "res\\vert.spv", "VSMain");
+        variant->addShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, "res\\frag.spv", "PSMain");
+        variant->setVertexInput(geometryPool.getFormat(), geometryPool.getLayout());
+        variant->setRenderingFormats(swapchain.getImageFormat(), context.findDepthFormat());
+        // vert.spv 使用 set 0 的 uniform 缓冲区，管线布局必须包含它；工厂在调用线程中执行，可以直接使用注册表
+        variant->reflectLayout(pipelineRegistry);
+        variant->setRasterizationState({
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+            .polygonMode = VK_POLYGON_MODE_FILL,
+            .cullMode = static_cast<VkCullModeFlags>(i % 4),
+            .frontFace = (i / 4) % 2 ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE,
+            .lineWidth = 1.0f,
+        });
+        variant->setDepthStencilState({
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+            .depthTestEnable = VK_TRUE,
+            .depthWriteEnable = VK_TRUE,
+            .depthCompareOp = static_cast<VkCompareOp>(1 + (i / 8) % 7),
+        });
+        return variant;
+    };
+    if (runBenchmarks) {
+        AsyncPipelineCompiler::benchmark(context, makeMaterialVariant, 56);
+    }
+    // 同样的排列组合改用扩展动态状态：只在这些状态上不同的材质共用管线，绘制时由 DynamicStateTracker 设置
+    if (runBenchmarks) {
+        PipelineRegistry dynamicStateRegistry(context);
+        std::vector<std::shared_ptr<VulkanPipeline>> materialPipelines;
+        for (uint32_t i = 0; i < 56; ++i) {
+            auto variant = makeMaterialVariant(i);
+            variant->useExtendedDynamicState();
+            materialPipelines.push_back(dynamicStateRegistry.getGraphicsPipeline(*variant));
+        }
+        std::cout << "[INFO] 56 material permutations -> " << dynamicStateRegistry.getStats().livePipelines
+                  << " pipelines with extended dynamic state" << std::endl;
+
+        // 按材质顺序录制一遍绑定与状态设置，统计实际发出与省略的命令数
+        DynamicStateTracker stateTracker(context);
+        const VkExtent2D extent = swapchain.getExtent();
+        const VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f };
+        const VkRect2D scissor{ { 0, 0 }, extent };
+        immediateSubmitter.submit([&](VkCommandBuffer cmd) {
+            stateTracker.begin(cmd);
+            for (uint32_t i = 0; i < 56; ++i) {
+                DynamicStateTracker::State state;
+                state.cullMode = static_cast<VkCullModeFlags>(i % 4);
+                state.frontFace = (i / 4) % 2 ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+                state.depthCompareOp = static_cast<VkCompareOp>(1 + (i / 8) % 7);
+                stateTracker.bindPipeline(*materialPipelines[i]);
+                stateTracker.setState(state);
+                stateTracker.setViewport(viewport);
+                stateTracker.setScissor(scissor);
+            }
+        });
+        std::cout << "[INFO] dynamic state tracker: " << stateTracker.getStats().emitted << " commands emitted, "
+                  << stateTracker.getStats().skipped << " skipped" << std::endl;
+    }
+    std::shared_ptr<VulkanPipeline> pipeline = pipelineRegistry.getGraphicsPipeline(pipelineBuilder);
+    // 逐物体变换走推送常量：反射得到 64 字节的顶点阶段范围，绘制每个物体前 objectPipeline->pushConstants(cmd, model)
+    PipelineBuilder objectPipelineBuilder(context);
+    objectPipelineBuilder.addShaderStage(VK_SHADER_STAGE_VERTEX_BIT, "res\\vert_object.spv", "VSMainObject");
+    objectPipelineBuilder.addShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, "res\\frag.spv", "PSMain");
+    objectPipelineBuilder.setVertexInput(geometryPool.getFormat(), geometryPool.getLayout());
+    objectPipelineBuilder.setRenderingFormats(swapchain.getImageFormat(), context.findDepthFormat());
+    objectPipelineBuilder.reflectLayout(pipelineRegistry);
+    std::shared_ptr<VulkanPipeline> objectPipeline = pipelineRegistry.getGraphicsPipeline(objectPipelineBuilder);
+    for (const VkPushConstantRange& range : objectPipeline->getPushConstantRanges()) {
+        std::cout << "[INFO] object pipeline push constants: offset " << range.offset << ", size " << range.size
+                  << ", stages 0x" << std::hex << range.stageFlags << std::dec << std::endl;
+    }
+    // 粒子更新：运行时 uniform 分支与特化常量版本对比，每种设置是注册表中的一个缓存变体
+    if (runBenchmarks) {
+        std::vector<ParticleSimulation::Particle> particles(1 << 20);
+        for (size_t i = 0; i < particles.size(); ++i) {
+            float angle = static_cast<float>(i) * 0.001f;
+            particles[i].position = glm::vec3(std::cos(angle), std::sin(angle), 0.0f) * (1.0f + (i % 100) * 0.01f);
+            particles[i].velocity = glm::vec3(-std::sin(angle), std::cos(angle), 0.1f) * static_cast<float>(i % 17);
+            particles[i].color = glm::vec4(1.0f);
+        }
+        ParticleSimulation particleSimulation(context, immediateSubmitter, pipelineRegistry, particles);
+        for (uint32_t workgroupSize : { 64u, 256u }) {
+            for (uint32_t substeps : { 1u, 4u }) {
+                particleSimulation.benchmark(graphicsQueue.getQueue(), { workgroupSize, substeps, true, true });
+            }
+        }
+    }
+    pipelineRegistry.printStats();
 }
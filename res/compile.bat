@@ -6,6 +6,14 @@
   -Fo vert.spv ^
   testShader.hlsl
 
+"C:\Libraries\Vulkan\Bin\dxc.exe" ^
+  -T vs_6_0 ^
+  -E VSMainObject ^
+  -spirv ^
+  -fspv-target-env=vulkan1.2 ^
+  -Fo vert_object.spv ^
+  testShader.hlsl
+
 "C:\Libraries\Vulkan\Bin\dxc.exe" ^
   -T ps_6_0 ^
   -E PSMain ^
@@ -24,3 +32,36 @@
   -Fo compute.spv ^
   compute.hlsl
 
+  "C:\Libraries\Vulkan\Bin\dxc.exe" ^
+  -T cs_6_0 ^
+  -E CSMain ^
+  -spirv ^
+  -fspv-target-env=vulkan1.2 ^
+  -Fo spd.spv ^
+  spd.hlsl
+
+  "C:\Libraries\Vulkan\Bin\dxc.exe" ^
+  -T cs_6_0 ^
+  -E CSMain ^
+  -spirv ^
+  -fspv-target-env=vulkan1.2 ^
+  -Fo meshlet_cull.spv ^
+  meshlet_cull.hlsl
+
+  "C:\Libraries\Vulkan\Bin\dxc.exe" ^
+  -T as_6_5 ^
+  -E ASMain ^
+  -spirv ^
+  -fspv-target-env=vulkan1.2 ^
+  -fspv-extension=SPV_EXT_mesh_shader ^
+  -Fo meshlet_task.spv ^
+  meshlet_mesh.hlsl
+
+  "C:\Libraries\Vulkan\Bin\dxc.exe" ^
+  -T ms_6_5 ^
+  -E MSMain ^
+  -spirv ^
+  -fspv-target-env=vulkan1.2 ^
+  -fspv-extension=SPV_EXT_mesh_shader ^
+  -Fo meshlet_mesh.spv ^
+  meshlet_mesh.hlsl
@@ -0,0 +1,49 @@
+// 簇剔除的公共定义，由 meshlet_cull.hlsl 与 meshlet_mesh.hlsl 共用
+
+// 与 MeshletBuilder.h 中的 Meshlet 一致（48 字节）
+struct Meshlet
+{
+    float3 center;
+    float radius;
+    float3 coneAxis;
+    float coneCutoff;
+    uint vertexOffset;
+    uint triangleOffset;
+    uint vertexCount;
+    uint triangleCount;
+};
+
+// 与 MeshletCuller::PushConstants 一致；矩阵为物体空间到裁剪空间，相机位置在物体空间
+struct CullParams
+{
+    float4x4 viewProjection;
+    float4 cameraPosition;
+    uint meshletCount;
+    uint3 pad;
+};
+
+[[vk::push_constant]] ConstantBuffer<CullParams> params;
+
+// 与 MeshletCuller::isMeshletVisible 相同：包围球对六个视锥平面，再做法线锥背面测试
+bool isMeshletVisible(Meshlet meshlet)
+{
+    float4x4 m = params.viewProjection;
+    float4 planes[6] = {
+        m[3] + m[0], m[3] - m[0],
+        m[3] + m[1], m[3] - m[1],
+        m[2],        m[3] - m[2],
+    };
+    for (uint i = 0; i < 6; ++i) {
+        if (dot(planes[i].xyz, meshlet.center) + planes[i].w < -meshlet.radius * length(planes[i].xyz)) {
+            return false;
+        }
+    }
+    float3 toCenter = meshlet.center - params.cameraPosition.xyz;
+    return dot(toCenter, meshlet.coneAxis) < meshlet.coneCutoff * length(toCenter) + meshlet.radius;
+}
+
+// 三角形的三个局部下标打包在一个 uint 中
+uint3 unpackTriangle(uint packed)
+{
+    return uint3(packed & 0xFF, (packed >> 8) & 0xFF, (packed >> 16) & 0xFF);
+}
@@ -0,0 +1,42 @@
+// GPU 簇剔除：每个工作组处理一个簇，可见簇的三角形展开为全局索引，紧密写入输出索引缓冲区，
+// 同时累加间接绘制参数中的 indexCount，之后由 vkCmdDrawIndexedIndirect 绘制。
+// 每簇最多 124 个三角形，一个线程写一个三角形。
+
+#include "meshlet_common.hlsli"
+
+[[vk::binding(0, 0)]] StructuredBuffer<Meshlet> meshlets;
+[[vk::binding(1, 0)]] StructuredBuffer<uint> meshletVertices;
+[[vk::binding(2, 0)]] StructuredBuffer<uint> meshletTriangles;
+[[vk::binding(3, 0)]] RWStructuredBuffer<uint> drawCommand;     // VkDrawIndexedIndirectCommand，[0] 为 indexCount
+[[vk::binding(4, 0)]] RWStructuredBuffer<uint> outputIndices;
+
+groupshared uint visible;
+groupshared uint baseIndex;
+
+[numthreads(128, 1, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint threadIndex : SV_GroupIndex)
+{
+    // 工作组数超过 65535 时折叠到 y 维（见 MeshletCuller::recordCull）
+    uint meshletIndex = groupId.x + groupId.y * 65535;
+    if (meshletIndex >= params.meshletCount) {
+        return;
+    }
+    Meshlet meshlet = meshlets[meshletIndex];
+
+    if (threadIndex == 0) {
+        visible = isMeshletVisible(meshlet) ? 1 : 0;
+        if (visible != 0) {
+            InterlockedAdd(drawCommand[0], meshlet.triangleCount * 3, baseIndex);
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (visible == 0 || threadIndex >= meshlet.triangleCount) {
+        return;
+    }
+    uint3 local = unpackTriangle(meshletTriangles[meshlet.triangleOffset + threadIndex]);
+    uint dst = baseIndex + threadIndex * 3;
+    outputIndices[dst + 0] = meshletVertices[meshlet.vertexOffset + local.x];
+    outputIndices[dst + 1] = meshletVertices[meshlet.vertexOffset + local.y];
+    outputIndices[dst + 2] = meshletVertices[meshlet.vertexOffset + local.z];
+}
@@ -0,0 +1,68 @@
+// 网格着色器路径（VK_EXT_mesh_shader）：
+// ASMain 每个线程测试一个簇，把可见簇的编号写入负载，为每个可见簇派发一个网格工作组；
+// MSMain 从存储缓冲区读取 Float32 顶点（VertexFormat::Float32，每个顶点 8 个 float），输出顶点与三角形。
+
+#include "meshlet_common.hlsli"
+
+[[vk::binding(0, 0)]] StructuredBuffer<Meshlet> meshlets;
+[[vk::binding(1, 0)]] StructuredBuffer<uint> meshletVertices;
+[[vk::binding(2, 0)]] StructuredBuffer<uint> meshletTriangles;
+[[vk::binding(3, 0)]] StructuredBuffer<float> vertices;
+
+#define TASK_GROUP_SIZE 32  // 与 MeshletCuller::kTaskGroupSize 一致
+
+struct TaskPayload
+{
+    uint meshletIndices[TASK_GROUP_SIZE];
+};
+
+groupshared TaskPayload payload;
+groupshared uint visibleCount;
+
+[numthreads(TASK_GROUP_SIZE, 1, 1)]
+void ASMain(uint3 groupId : SV_GroupID, uint threadIndex : SV_GroupIndex)
+{
+    if (threadIndex == 0) {
+        visibleCount = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    uint meshletIndex = (groupId.x + groupId.y * 65535) * TASK_GROUP_SIZE + threadIndex;
+    if (meshletIndex < params.meshletCount && isMeshletVisible(meshlets[meshletIndex])) {
+        uint slot;
+        InterlockedAdd(visibleCount, 1, slot);
+        payload.meshletIndices[slot] = meshletIndex;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    DispatchMesh(visibleCount, 1, 1, payload);
+}
+
+struct MeshOutput
+{
+    float4 position : SV_POSITION;
+    float3 normal   : NORMAL;
+    float2 texCoord : TEXCOORD0;
+};
+
+[outputtopology("triangle")]
+[numthreads(128, 1, 1)]
+void MSMain(uint3 groupId : SV_GroupID, uint threadIndex : SV_GroupIndex, in payload TaskPayload taskPayload,
+    out vertices MeshOutput outVertices[64], out indices uint3 outTriangles[124])
+{
+    Meshlet meshlet = meshlets[taskPayload.meshletIndices[groupId.x]];
+    SetMeshOutputCounts(meshlet.vertexCount, meshlet.triangleCount);
+
+    if (threadIndex < meshlet.vertexCount) {
+        uint base = meshletVertices[meshlet.vertexOffset + threadIndex] * 8;
+        float3 position = float3(vertices[base + 0], vertices[base + 1], vertices[base + 2]);
+        MeshOutput output;
+        output.position = mul(params.viewProjection, float4(position, 1.0f));
+        output.normal = float3(vertices[base + 3], vertices[base + 4], vertices[base + 5]);
+        output.texCoord = float2(vertices[base + 6], vertices[base + 7]);
+        outVertices[threadIndex] = output;
+    }
+    if (threadIndex < meshlet.triangleCount) {
+        outTriangles[threadIndex] = unpackTriangle(meshletTriangles[meshlet.triangleOffset + threadIndex]);
+    }
+}
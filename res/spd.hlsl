@@ -0,0 +1,135 @@
+// 单次 dispatch 生成整条 mip 链（SPD 风格）
+// 每个工作组 256 线程，负责 mip0 中 64x64 的区域，在共享内存里连续生成 mip1~mip6；
+// 所有工作组写完 mip6 后，最后到达的那个工作组（原子计数判断）继续生成 mip7~mip12。
+// 只支持 RGBA8（UNORM，或以 UNORM 别名访问的 SRGB 图像），mip0 最大 4096。
+
+struct Params
+{
+    uint mips;          // 需要生成的级数（不含 mip0），最多 12
+    uint numWorkGroups; // 每一层的工作组数量
+    uint srgb;          // 非 0 表示存储视图是 SRGB 图像的 UNORM 别名，需要手动编解码
+    uint pad;
+};
+
+[[vk::push_constant]] ConstantBuffer<Params> params;
+
+[[vk::binding(0, 0)]] Texture2DArray<float4> srcMip0;
+[[vk::binding(1, 0)]] [[vk::image_format("rgba8")]] RWTexture2DArray<float4> dstMips[12];
+[[vk::binding(2, 0)]] globallycoherent RWStructuredBuffer<uint> counters;
+// 与 dstMips[5] 是同一级，单独绑定为 globallycoherent，保证最后一个工作组能读到其它工作组的结果
+[[vk::binding(3, 0)]] [[vk::image_format("rgba8")]] globallycoherent RWTexture2DArray<float4> mip6;
+
+groupshared float4 tile[32][32];
+groupshared uint isLastGroup;
+
+float3 srgbToLinear(float3 c)
+{
+    float3 lo = c / 12.92;
+    float3 hi = pow((c + 0.055) / 1.055, 2.4);
+    return lerp(hi, lo, float3(c <= 0.04045));
+}
+
+float3 linearToSrgb(float3 c)
+{
+    float3 lo = c * 12.92;
+    float3 hi = 1.055 * pow(c, 1.0 / 2.4) - 0.055;
+    return lerp(hi, lo, float3(c <= 0.0031308));
+}
+
+float4 decode(float4 v)
+{
+    if (params.srgb != 0) v.rgb = srgbToLinear(v.rgb);
+    return v;
+}
+
+float4 encode(float4 v)
+{
+    if (params.srgb != 0) v.rgb = linearToSrgb(saturate(v.rgb));
+    return v;
+}
+
+// mip 从 1 开始计数
+void store(uint mip, uint2 pos, uint layer, float4 v)
+{
+    uint w, h, elements;
+    dstMips[mip - 1].GetDimensions(w, h, elements);
+    if (pos.x >= w || pos.y >= h) return;
+
+    if (mip == 6) mip6[uint3(pos, layer)] = encode(v);
+    else dstMips[mip - 1][uint3(pos, layer)] = encode(v);
+}
+
+float4 loadBase(bool fromMip0, int2 pos, int2 size, uint layer)
+{
+    pos = min(pos, size - 1);
+    if (fromMip0) return srcMip0.Load(int4(pos, layer, 0)); // SRGB 视图读取时已由硬件转换到线性空间
+    return decode(mip6[uint3(pos, layer)]);
+}
+
+// 以 mip0（或 mip6）为源，处理一个 64x64 的源区域，依次生成 firstMip..lastMip
+void downsampleTile(uint2 groupTile, uint t, uint layer, bool fromMip0, uint firstMip, uint lastMip)
+{
+    uint w, h, elements, levels;
+    if (fromMip0) srcMip0.GetDimensions(0, w, h, elements, levels);
+    else mip6.GetDimensions(w, h, elements);
+    int2 baseSize = int2(w, h);
+
+    // 第一级：32x32 个输出纹素，每个线程 4 个，直接从源读取
+    for (uint i = 0; i < 4; ++i)
+    {
+        uint idx = t + i * 256;
+        uint2 local = uint2(idx % 32, idx / 32);
+        int2 src = int2(groupTile * 64 + local * 2);
+        float4 v = loadBase(fromMip0, src, baseSize, layer)
+                 + loadBase(fromMip0, src + int2(1, 0), baseSize, layer)
+                 + loadBase(fromMip0, src + int2(0, 1), baseSize, layer)
+                 + loadBase(fromMip0, src + int2(1, 1), baseSize, layer);
+        v *= 0.25;
+        store(firstMip, groupTile * 32 + local, layer, v);
+        tile[local.y][local.x] = v;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // 后续各级在共享内存中完成：16x16 -> 8x8 -> ... -> 1x1
+    uint size = 16;
+    for (uint mip = firstMip + 1; mip <= lastMip; ++mip)
+    {
+        uint2 local = uint2(t % size, t / size);
+        bool active = t < size * size;
+        float4 v = 0;
+        if (active)
+        {
+            v = (tile[local.y * 2][local.x * 2] + tile[local.y * 2][local.x * 2 + 1]
+               + tile[local.y * 2 + 1][local.x * 2] + tile[local.y * 2 + 1][local.x * 2 + 1]) * 0.25;
+            store(mip, groupTile * size + local, layer, v);
+        }
+        GroupMemoryBarrierWithGroupSync();
+        if (active) tile[local.y][local.x] = v;
+        GroupMemoryBarrierWithGroupSync();
+        size >>= 1;
+    }
+}
+
+[numthreads(256, 1, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint t : SV_GroupIndex)
+{
+    uint layer = groupId.z;
+
+    downsampleTile(groupId.xy, t, layer, true, 1, min(params.mips, 6));
+    if (params.mips <= 6) return;
+
+    // 等待本组对 mip6 的写入对其它工作组可见，再参与计数
+    AllMemoryBarrierWithGroupSync();
+    if (t == 0)
+    {
+        uint previous;
+        InterlockedAdd(counters[layer], 1, previous);
+        isLastGroup = (previous == params.numWorkGroups - 1) ? 1 : 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (isLastGroup == 0) return;
+
+    // 复位计数器，供下一次 dispatch 使用
+    if (t == 0) counters[layer] = 0;
+    downsampleTile(uint2(0, 0), t, layer, false, 7, params.mips);
+}
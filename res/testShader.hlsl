@@ -27,6 +27,23 @@ VSOutput VSMain(VSInput input) {
     return output;
 }
 
+// 逐物体的模型矩阵放在推送常量中：每次绘制前 vkCmdPushConstants 即可，不需要写 UBO 或更新描述符集。
+// cbuffer 中的 model 在这个入口中不使用，view/proj 每帧只写一次
+struct ObjectConstants {
+    float4x4 objectModel;
+};
+[[vk::push_constant]] ObjectConstants object;
+
+VSOutput VSMainObject(VSInput input) {
+    VSOutput output;
+    output.position = float4(input.position, 1.0f);
+    output.position = mul(output.position, object.objectModel);
+    output.position = mul(output.position, view);
+    output.position = mul(output.position, proj);
+    output.color = float4(input.velocity, 1.0f);
+    return output;
+}
+
 Texture2D myTexture : register(t1, space0);
 SamplerState mySampler : register(s1, space0);
 
@@ -0,0 +1,22 @@
+// VertexCompressor 紧凑顶点布局的解码函数，在顶点着色器中 #include 使用
+
+// 位置：R16G16B16A16_UNORM 读入后为 [0, 1]，按包围盒还原（PackedMesh::dequantization）
+float3 dequantizePosition(float3 unorm, float3 scale, float3 offset)
+{
+    return offset + scale * unorm;
+}
+
+float2 signNotZero(float2 v)
+{
+    return float2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+// 法线：R16G16_SNORM / R8G8_SNORM 读入后为 [-1, 1]^2 的八面体坐标
+float3 decodeOctahedral(float2 e)
+{
+    float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    if (n.z < 0.0f) {
+        n.xy = (1.0f - abs(n.yx)) * signNotZero(n.xy);
+    }
+    return normalize(n);
+}